@@ -74,33 +74,22 @@ size_t ByteBufferEnqueueBytes(
   size_t const to_copy = (count > (buffer->capacity - buffer->size))
       ? (buffer->capacity - buffer->size) : count;
   size_t const end_idx = (buffer->size + buffer->ptr) % buffer->capacity;
-  size_t i = 0;
-  while (end_idx + i < buffer->capacity && i < to_copy) {
-    buffer->data[end_idx + i] = data[i];
-    ++i;
-  }
-  size_t const wrap_offset = buffer->capacity - end_idx;
-  while (i < to_copy) {
-    buffer->data[i - wrap_offset] = data[i];
-    ++i;
-  }
+  /* At most two contiguous segments. */
+  size_t const first = (to_copy < buffer->capacity - end_idx)
+      ? to_copy : (buffer->capacity - end_idx);
+  memcpy(&buffer->data[end_idx], data, first);
+  memcpy(buffer->data, &data[first], to_copy - first);
   buffer->size += to_copy;
   return to_copy;
 }
 
 static size_t ByteBufferPeakBytesInternal(
-    byte_buffer_t *buffer, uint8_t *data, size_t count) {
+    byte_buffer_t const *buffer, uint8_t *data, size_t count) {
   size_t const to_copy = (count > buffer->size) ? buffer->size : count;
-  size_t i = 0;
-  while (buffer->ptr + i < buffer->capacity && i < to_copy) {
-    data[i] = buffer->data[buffer->ptr + i];
-    ++i;
-  }
-  size_t const wrap_offset = buffer->capacity - buffer->ptr;
-  while (i < to_copy) {
-    data[i] = buffer->data[i - wrap_offset];
-    ++i;
-  }
+  size_t const first = (to_copy < buffer->capacity - buffer->ptr)
+      ? to_copy : (buffer->capacity - buffer->ptr);
+  memcpy(data, &buffer->data[buffer->ptr], first);
+  memcpy(&data[first], buffer->data, to_copy - first);
   return to_copy;
 }
 
@@ -143,3 +132,29 @@ size_t ByteBufferDequeueBytes(
   }
   return copied;
 }
+
+size_t ByteBufferGetWriteSpan(byte_buffer_t *buffer, uint8_t **span) {
+  if (!ByteBufferIsValid(buffer) || span == NULL) return 0;
+  size_t const end_idx = (buffer->size + buffer->ptr) % buffer->capacity;
+  *span = &buffer->data[end_idx];
+  if (buffer->size == buffer->capacity) return 0;
+  /* Free space ends at either the end of the data, or the front. */
+  return (end_idx >= buffer->ptr) ? (buffer->capacity - end_idx)
+      : (buffer->ptr - end_idx);
+}
+
+size_t ByteBufferCommitBytes(byte_buffer_t *buffer, size_t count) {
+  if (!ByteBufferIsValid(buffer)) return 0;
+  size_t const space = buffer->capacity - buffer->size;
+  size_t const committed = (count > space) ? space : count;
+  buffer->size += committed;
+  return committed;
+}
+
+size_t ByteBufferGetReadSpan(
+    byte_buffer_t const *buffer, uint8_t const **span) {
+  if (!ByteBufferIsValid(buffer) || span == NULL) return 0;
+  *span = &buffer->data[buffer->ptr];
+  return (buffer->ptr + buffer->size > buffer->capacity)
+      ? (buffer->capacity - buffer->ptr) : buffer->size;
+}
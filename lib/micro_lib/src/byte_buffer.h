@@ -39,6 +39,22 @@ bool_t ByteBufferDequeueByte(byte_buffer_t *buffer, uint8_t *byte);
 size_t ByteBufferDequeueBytes(
   byte_buffer_t *buffer, uint8_t *data, size_t count);
 
+/* Contiguous spans.
+ *  ByteBufferGetWriteSpan() sets |span| to the free space after the
+ *  last byte, and returns the number of bytes that can be written
+ *  there.  ByteBufferCommitBytes() adds |count| written bytes to
+ *  the buffer.
+ *  ByteBufferGetReadSpan() sets |span| to the first byte, and returns
+ *  the number of bytes that can be read there.  ByteBufferClearBytes()
+ *  consumes the bytes read.
+ *  If the free space or data wraps around the end of the buffer, a
+ *  second span is available after the first is committed or consumed.
+ */
+size_t ByteBufferGetWriteSpan(byte_buffer_t *buffer, uint8_t **span);
+size_t ByteBufferCommitBytes(byte_buffer_t *buffer, size_t count);
+size_t ByteBufferGetReadSpan(
+  byte_buffer_t const *buffer, uint8_t const **span);
+
 C_SECTION_END;
 
 #endif  /* _BYTE_BUFFER_H_ */
@@ -0,0 +1,140 @@
+/*
+ * MIDI Controller - Byte Ring
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <string.h>
+
+#include "byte_ring.h"
+
+/* Index access.
+ *  The owner of an index may read it directly.  An index owned by the
+ *  other side is loaded with acquire semantics, so that the data
+ *  written before it was published is visible.  An owned index is
+ *  stored with release semantics, so that the data is written (or
+ *  read) before the other side sees the new index.
+ *  AVR is single core, and single byte accesses are atomic; only a
+ *  compiler barrier is required.
+ */
+#ifdef _PLATFORM_AVR
+#define ByteRingBarrier() __asm__ __volatile__ ("" ::: "memory")
+#define ByteRingLoadAcquire(index_ptr) \
+  ({ byte_ring_index_t const _i = *(index_ptr); ByteRingBarrier(); _i; })
+#define ByteRingStoreRelease(index_ptr, value) \
+  do { ByteRingBarrier(); *(index_ptr) = (value); } while (0)
+#else
+#define ByteRingLoadAcquire(index_ptr) \
+  __atomic_load_n((index_ptr), __ATOMIC_ACQUIRE)
+#define ByteRingStoreRelease(index_ptr, value) \
+  __atomic_store_n((index_ptr), (value), __ATOMIC_RELEASE)
+#endif
+
+static inline bool_t ByteRingIsValid(byte_ring_t const *ring) {
+  return ring != NULL && ring->data != NULL;
+}
+
+static inline size_t ByteRingUsed(
+    byte_ring_index_t head, byte_ring_index_t tail) {
+  return (byte_ring_index_t) (head - tail);
+}
+
+bool_t ByteRingInitialize(byte_ring_t *ring, uint8_t *data, size_t capacity) {
+  if (ring == NULL || data == NULL) return false;
+  if (capacity == 0 || capacity > BYTE_RING_MAX_CAPACITY) return false;
+  /* Power of two. */
+  if ((capacity & (capacity - 1)) != 0) return false;
+  *ring = (byte_ring_t) {
+    .data = data,
+    .mask = (byte_ring_index_t) (capacity - 1),
+    .head = 0,
+    .tail = 0
+  };
+  return true;
+}
+
+bool_t ByteRingClear(byte_ring_t *ring) {
+  if (!ByteRingIsValid(ring)) return false;
+  ByteRingStoreRelease(&ring->tail, ByteRingLoadAcquire(&ring->head));
+  return true;
+}
+
+size_t ByteRingCapacity(byte_ring_t const *ring) {
+  if (!ByteRingIsValid(ring)) return 0;
+  return (size_t) ring->mask + 1;
+}
+
+size_t ByteRingSize(byte_ring_t const *ring) {
+  if (!ByteRingIsValid(ring)) return 0;
+  return ByteRingUsed(
+      ByteRingLoadAcquire(&ring->head), ByteRingLoadAcquire(&ring->tail));
+}
+
+bool_t ByteRingIsEmpty(byte_ring_t const *ring) {
+  if (!ByteRingIsValid(ring)) return false;
+  return ByteRingSize(ring) == 0;
+}
+
+bool_t ByteRingIsFull(byte_ring_t const *ring) {
+  if (!ByteRingIsValid(ring)) return false;
+  return ByteRingSize(ring) == ByteRingCapacity(ring);
+}
+
+bool_t ByteRingEnqueueByte(byte_ring_t *ring, uint8_t byte) {
+  if (!ByteRingIsValid(ring)) return false;
+  byte_ring_index_t const head = ring->head;
+  byte_ring_index_t const tail = ByteRingLoadAcquire(&ring->tail);
+  if (ByteRingUsed(head, tail) > ring->mask) return false;
+  ring->data[head & ring->mask] = byte;
+  ByteRingStoreRelease(&ring->head, (byte_ring_index_t) (head + 1));
+  return true;
+}
+
+size_t ByteRingEnqueueBytes(
+    byte_ring_t *ring, uint8_t const *data, size_t count) {
+  if (!ByteRingIsValid(ring)) return 0;
+  if (data == NULL || count == 0) return 0;
+  byte_ring_index_t const head = ring->head;
+  byte_ring_index_t const tail = ByteRingLoadAcquire(&ring->tail);
+  size_t const capacity = (size_t) ring->mask + 1;
+  size_t const space = capacity - ByteRingUsed(head, tail);
+  size_t const to_copy = (count > space) ? space : count;
+  if (to_copy == 0) return 0;
+  /* At most two contiguous segments. */
+  size_t const start = head & ring->mask;
+  size_t const first = (to_copy < capacity - start)
+      ? to_copy : (capacity - start);
+  memcpy(&ring->data[start], data, first);
+  memcpy(ring->data, &data[first], to_copy - first);
+  ByteRingStoreRelease(&ring->head, (byte_ring_index_t) (head + to_copy));
+  return to_copy;
+}
+
+bool_t ByteRingDequeueByte(byte_ring_t *ring, uint8_t *byte) {
+  if (!ByteRingIsValid(ring) || byte == NULL) return false;
+  byte_ring_index_t const tail = ring->tail;
+  byte_ring_index_t const head = ByteRingLoadAcquire(&ring->head);
+  if (head == tail) return false;
+  *byte = ring->data[tail & ring->mask];
+  ByteRingStoreRelease(&ring->tail, (byte_ring_index_t) (tail + 1));
+  return true;
+}
+
+size_t ByteRingDequeueBytes(byte_ring_t *ring, uint8_t *data, size_t count) {
+  if (!ByteRingIsValid(ring)) return 0;
+  if (data == NULL || count == 0) return 0;
+  byte_ring_index_t const tail = ring->tail;
+  byte_ring_index_t const head = ByteRingLoadAcquire(&ring->head);
+  size_t const used = ByteRingUsed(head, tail);
+  size_t const to_copy = (count > used) ? used : count;
+  if (to_copy == 0) return 0;
+  size_t const capacity = (size_t) ring->mask + 1;
+  size_t const start = tail & ring->mask;
+  size_t const first = (to_copy < capacity - start)
+      ? to_copy : (capacity - start);
+  memcpy(data, &ring->data[start], first);
+  memcpy(&data[first], ring->data, to_copy - first);
+  ByteRingStoreRelease(&ring->tail, (byte_ring_index_t) (tail + to_copy));
+  return to_copy;
+}
@@ -0,0 +1,72 @@
+/*
+ * MIDI Controller - Byte Ring
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _BYTE_RING_H_
+#define _BYTE_RING_H_
+
+#include "base.h"
+
+C_SECTION_BEGIN;
+
+/*
+ *  Single-Producer Single-Consumer Byte Ring
+ *    A byte queue which can be shared between one producer and one
+ *    consumer (an ISR and the main loop, or two threads) without
+ *    disabling interrupts or locking.
+ *
+ *    The producer only writes |head| and the consumer only writes
+ *    |tail|; both are free running and wrap using |mask|, so the
+ *    capacity must be a power of two.  Enqueue functions must only
+ *    be called by the producer, and dequeue / clear functions must
+ *    only be called by the consumer.
+ *
+ *    On AVR the indexes are a single byte so that they can be read
+ *    and written atomically, limiting capacity to 128 bytes.
+ */
+#ifdef _PLATFORM_AVR
+typedef uint8_t byte_ring_index_t;
+#define BYTE_RING_MAX_CAPACITY 128
+#else
+typedef size_t byte_ring_index_t;
+#define BYTE_RING_MAX_CAPACITY (((size_t) SIZE_MAX >> 1) + 1)
+#endif
+
+typedef struct {
+  uint8_t *data;
+  byte_ring_index_t mask;
+  /* Only modified by the producer. */
+  byte_ring_index_t volatile head;
+  /* Only modified by the consumer. */
+  byte_ring_index_t volatile tail;
+} byte_ring_t;
+
+/* |capacity| must be a power of two, no larger than
+ * BYTE_RING_MAX_CAPACITY. */
+bool_t ByteRingInitialize(byte_ring_t *ring, uint8_t *data, size_t capacity);
+
+/* Consumer only.  Discards all available bytes. */
+bool_t ByteRingClear(byte_ring_t *ring);
+
+size_t ByteRingCapacity(byte_ring_t const *ring);
+/* The size is a snapshot; it may grow (if called by the consumer) or
+ * shrink (if called by the producer) by the time it is used. */
+size_t ByteRingSize(byte_ring_t const *ring);
+bool_t ByteRingIsEmpty(byte_ring_t const *ring);
+bool_t ByteRingIsFull(byte_ring_t const *ring);
+
+/* Producer only. */
+bool_t ByteRingEnqueueByte(byte_ring_t *ring, uint8_t byte);
+size_t ByteRingEnqueueBytes(
+  byte_ring_t *ring, uint8_t const *data, size_t count);
+
+/* Consumer only. */
+bool_t ByteRingDequeueByte(byte_ring_t *ring, uint8_t *byte);
+size_t ByteRingDequeueBytes(byte_ring_t *ring, uint8_t *data, size_t count);
+
+C_SECTION_END;
+
+#endif  /* _BYTE_RING_H_ */
@@ -8,36 +8,54 @@
 #include <string.h>
 
 #include "system_interrupt.h"
+#include "system_sleep.h"
 #include "scheduler.h"
 
 #define EVENT_NULL  0
+#define ENTRY_NULL  0xFF
 
-#define NULL_ENTRY_TYPE 0
-#define TIMER_ENTRY_TYPE 1
-#define EVENT_ENTRY_TYPE 2
+#define SchedulerIsValidEvent(event) \
+  ((event) != EVENT_NULL && (event) <= SCHEDULER_EVENT_ID_COUNT)
+#define SchedulerEventIndex(event) ((event) - 1)
+
+#define TIMER_SLOT_NULL  0xFFFF
 
 bool_t SchedulerInitialize(
     scheduler_t *scheduler, system_time_t const *init_time) {
   if (scheduler == NULL || init_time == NULL) return false;
   memset(scheduler, 0, sizeof(scheduler_t));
   memcpy(&scheduler->last_update, init_time, sizeof(system_time_t));
+  SchedulerClearCallbacks(scheduler);
   return true;
 }
 
 bool_t SchedulerClearEvents(scheduler_t *scheduler) {
   if (scheduler == NULL) return false;
-  for (uint8_t i = 0; i < SCHEDULER_EVENT_QUEUE_SIZE; ++i) {
-    scheduler->events[i] = EVENT_NULL;
-  }
+  SystemDisableInterrupt();
+  memset(scheduler->pending_events, 0, sizeof(scheduler->pending_events));
   scheduler->event_count = 0;
+  SystemEnableInterrupt();
   return true;
 }
 
 bool_t SchedulerClearCallbacks(scheduler_t *scheduler) {
   if (scheduler == NULL) return false;
+  scheduler->timer_count = 0;
+  /* Invalidates all timer handles. */
+  for (uint16_t i = 0; i < SCHEDULER_TIMER_HEAP_SIZE; ++i) {
+    scheduler_timer_slot_t *slot = &scheduler->timer_slots[i];
+    slot->position =
+        (i + 1 < SCHEDULER_TIMER_HEAP_SIZE) ? (i + 1) : TIMER_SLOT_NULL;
+    if (++slot->generation == 0) slot->generation = 1;
+  }
+  scheduler->free_timer_slot = 0;
+  memset(scheduler->event_heads, ENTRY_NULL, sizeof(scheduler->event_heads));
   for (uint8_t i = 0; i < SCHEDULER_CALLBACK_TABLE_SIZE; ++i) {
-    scheduler->entries[i].type = NULL_ENTRY_TYPE;
+    scheduler->entries[i].next =
+        (i + 1 < SCHEDULER_CALLBACK_TABLE_SIZE) ? (i + 1) : ENTRY_NULL;
   }
+  scheduler->free_entry = 0;
+  scheduler->event_entry_count = 0;
   scheduler->entry_count = 0;
   return true;
 }
@@ -50,36 +68,42 @@ size_t SchedulerDoCallbacks(
   if (scheduler == NULL || time == NULL) return 0;
   if (SystemTimeLessThan(time, &scheduler->last_update)) return 0;
   memcpy(&scheduler->last_update, time, sizeof(system_time_t));
-  size_t const job_count = SchedulerDoTimerCallbacksInternal(scheduler) +
-                           SchedulerDoEventCallbacksInternal(scheduler);
-  size_t dest_idx = 0;
-  for (size_t src_idx = 0; src_idx < scheduler->entry_count; ++src_idx) {
-    if (scheduler->entries[src_idx].type == NULL_ENTRY_TYPE) continue;
-    while (dest_idx < src_idx &&
-           scheduler->entries[dest_idx].type != NULL_ENTRY_TYPE) {
-      ++dest_idx;
-    }
-    if (dest_idx == src_idx) continue;
-    memcpy(&scheduler->entries[dest_idx], &scheduler->entries[src_idx],
-           sizeof(scheduler_callback_entry_t));
-    scheduler->entries[src_idx].type = NULL_ENTRY_TYPE;
-  }
-  while (dest_idx < scheduler->entry_count &&
-         scheduler->entries[dest_idx].type != NULL_ENTRY_TYPE) {
-    ++dest_idx;
+  return SchedulerDoTimerCallbacksInternal(scheduler) +
+         SchedulerDoEventCallbacksInternal(scheduler);
+}
+
+bool_t SchedulerNextDeadline(
+    scheduler_t const *scheduler, system_time_t *deadline) {
+  if (scheduler == NULL || deadline == NULL) return false;
+  if (scheduler->event_count > 0) {
+    memcpy(deadline, &scheduler->last_update, sizeof(system_time_t));
+    return true;
   }
-  scheduler->entry_count = dest_idx;
-  return job_count;
+  if (scheduler->timer_count == 0) return false;
+  /* Root of the timer heap. */
+  memcpy(deadline, &scheduler->timers[0].timer, sizeof(system_time_t));
+  return true;
 }
 
-#define SchedulerIsFull(scheduler) \
-  ((scheduler)->entry_count >= SCHEDULER_CALLBACK_TABLE_SIZE)
+void SchedulerIdle(scheduler_t const *scheduler) {
+  if (scheduler == NULL) return;
+  system_time_t deadline;
+  /* Events triggered from interrupts after this check will wake the
+   * sleep. */
+  SystemDisableInterrupt();
+  if (!SchedulerNextDeadline(scheduler, &deadline)) {
+    SystemSleepUntil(NULL);
+  } else if (SystemTimeLessThan(&scheduler->last_update, &deadline)) {
+    SystemSleepUntil(&deadline);
+  } else {
+    SystemEnableInterrupt();
+  }
+}
 
-#define SchedulerIsEventFull(scheduler) \
-  ((scheduler)->event_count >= SCHEDULER_EVENT_QUEUE_SIZE)
+#define SchedulerIsTimerFull(scheduler) \
+  ((scheduler)->free_timer_slot == TIMER_SLOT_NULL)
 
-#define SchedulerAllocateCallback(scheduler) \
-  (&(scheduler)->entries[(scheduler)->entry_count++])
+#define SchedulerIsFull(scheduler) ((scheduler)->free_entry == ENTRY_NULL)
 
 /*
  *  Timer Callbacks
@@ -87,158 +111,278 @@ size_t SchedulerDoCallbacks(
 #define TIMER_PERIODIC_S     0x01
 #define TIMER_PERIODIC_US    0x02
 #define TIMER_PERIODIC (TIMER_PERIODIC_S | TIMER_PERIODIC_US)
+/* Set if the timer was rescheduled from within its own callback. */
+#define TIMER_RESCHEDULED    0x04
+
+#define TimerHeapParent(idx) (((idx) - 1) / 2)
+#define TimerHeapLeftChild(idx) ((2 * (idx)) + 1)
+
+#define TimerHandle(generation, slot) \
+  ((((scheduler_timer_handle_t) (generation)) << 16) | (slot))
+#define TimerHandleGeneration(handle) ((uint16_t) ((handle) >> 16))
+#define TimerHandleSlot(handle) ((uint16_t) ((handle) & 0xFFFF))
+
+#define SchedulerTimerIsBefore(scheduler, idx_a, idx_b) \
+  SystemTimeLessThan( \
+    &(scheduler)->timers[idx_a].timer, &(scheduler)->timers[idx_b].timer)
 
-static scheduler_timer_callback_entry_t *SchedulerAllocateTimerCallback(
-    scheduler_t *scheduler) {
-  if (scheduler == NULL) return NULL;
-  scheduler_callback_entry_t *entry = SchedulerAllocateCallback(scheduler);
-  memset(entry, 0, sizeof(scheduler_callback_entry_t));
-  entry->type = TIMER_ENTRY_TYPE;
-  return &entry->timer_entry;
+static void SchedulerSwapTimers(
+    scheduler_t *scheduler, size_t idx_a, size_t idx_b) {
+  scheduler_timer_callback_entry_t tmp;
+  memcpy(&tmp, &scheduler->timers[idx_a], sizeof(tmp));
+  memcpy(&scheduler->timers[idx_a], &scheduler->timers[idx_b], sizeof(tmp));
+  memcpy(&scheduler->timers[idx_b], &tmp, sizeof(tmp));
+  scheduler->timer_slots[scheduler->timers[idx_a].slot].position = idx_a;
+  scheduler->timer_slots[scheduler->timers[idx_b].slot].position = idx_b;
 }
 
-bool_t SchedulerSetPeriodicCallbackMicroseconds(
-    scheduler_t *scheduler, uint32_t period, system_time_t const *current_time,
-    scheduler_timer_callback_t callback, void *callback_ctx) {
-  if (scheduler == NULL || period == 0 || callback == NULL) return false;
-  if (SchedulerIsFull(scheduler)) return false;
-  scheduler_timer_callback_entry_t *entry =
-      SchedulerAllocateTimerCallback(scheduler);
-  *entry = (scheduler_timer_callback_entry_t) {
-    .callback = callback,
-    .ctx = callback_ctx,
-    .period = period,
-    .flags = TIMER_PERIODIC_US
-  };
+static size_t SchedulerSiftTimerUp(scheduler_t *scheduler, size_t idx) {
+  while (idx > 0) {
+    size_t const parent = TimerHeapParent(idx);
+    if (!SchedulerTimerIsBefore(scheduler, idx, parent)) break;
+    SchedulerSwapTimers(scheduler, idx, parent);
+    idx = parent;
+  }
+  return idx;
+}
 
-  if (current_time == NULL) {
-    memcpy(&entry->timer, &scheduler->last_update, sizeof(system_time_t));
-  } else {
-    if (SystemTimeLessThan(current_time, &scheduler->last_update)) {
-      --scheduler->entry_count;
-      return false;
-    }
-    memcpy(&entry->timer, current_time, sizeof(system_time_t));
+static void SchedulerSiftTimerDown(scheduler_t *scheduler, size_t idx) {
+  size_t const count = scheduler->timer_count;
+  for (;;) {
+    size_t const left = TimerHeapLeftChild(idx);
+    if (left >= count) break;
+    size_t const right = left + 1;
+    size_t const child =
+        (right < count && SchedulerTimerIsBefore(scheduler, right, left))
+        ? right : left;
+    if (!SchedulerTimerIsBefore(scheduler, child, idx)) break;
+    SchedulerSwapTimers(scheduler, idx, child);
+    idx = child;
   }
+}
 
-  if (!SystemTimeIncrementMicroseconds(&entry->timer, period)) {
-    --scheduler->entry_count;
-    return false;
+/* Restores the heap order after the timer at |idx| has changed. */
+static void SchedulerUpdateTimer(scheduler_t *scheduler, size_t idx) {
+  if (SchedulerSiftTimerUp(scheduler, idx) == idx) {
+    SchedulerSiftTimerDown(scheduler, idx);
   }
-  return true;
 }
 
-bool_t SchedulerSetPeriodicCallbackSeconds(
-    scheduler_t *scheduler, uint32_t period, system_time_t const *current_time,
-    scheduler_timer_callback_t callback, void *callback_ctx) {
-  if (scheduler == NULL || period == 0  || callback == NULL) return false;
-  if (SchedulerIsFull(scheduler)) return false;
-  scheduler_timer_callback_entry_t *entry =
-      SchedulerAllocateTimerCallback(scheduler);
-  *entry = (scheduler_timer_callback_entry_t) {
-    .callback = callback,
-    .ctx = callback_ctx,
-    .period = period,
-    .flags = TIMER_PERIODIC_S
-  };
+/* Assumes the heap is not full. */
+static scheduler_timer_handle_t SchedulerPushTimer(
+    scheduler_t *scheduler, scheduler_timer_callback_entry_t const *entry) {
+  uint16_t const slot_idx = scheduler->free_timer_slot;
+  scheduler_timer_slot_t *slot = &scheduler->timer_slots[slot_idx];
+  scheduler->free_timer_slot = slot->position;
+  size_t const idx = scheduler->timer_count++;
+  ++scheduler->entry_count;
+  memcpy(&scheduler->timers[idx], entry,
+         sizeof(scheduler_timer_callback_entry_t));
+  scheduler->timers[idx].slot = slot_idx;
+  slot->position = idx;
+  SchedulerSiftTimerUp(scheduler, idx);
+  return TimerHandle(slot->generation, slot_idx);
+}
 
-  if (current_time == NULL) {
-    memcpy(&entry->timer, &scheduler->last_update, sizeof(system_time_t));
-  } else {
-    if (SystemTimeLessThan(current_time, &scheduler->last_update)) {
-      --scheduler->entry_count;
-      return false;
-    }
-    memcpy(&entry->timer, current_time, sizeof(system_time_t));
-  }
+static void SchedulerRemoveTimer(scheduler_t *scheduler, size_t idx) {
+  uint16_t const slot_idx = scheduler->timers[idx].slot;
+  scheduler_timer_slot_t *slot = &scheduler->timer_slots[slot_idx];
+  if (++slot->generation == 0) slot->generation = 1;
+  slot->position = scheduler->free_timer_slot;
+  scheduler->free_timer_slot = slot_idx;
+  size_t const last = --scheduler->timer_count;
+  --scheduler->entry_count;
+  if (idx == last) return;
+  memcpy(&scheduler->timers[idx], &scheduler->timers[last],
+         sizeof(scheduler_timer_callback_entry_t));
+  scheduler->timer_slots[scheduler->timers[idx].slot].position = idx;
+  SchedulerUpdateTimer(scheduler, idx);
+}
 
-  if (!SystemTimeIncrementSeconds(&entry->timer, period)) {
-    --scheduler->entry_count;
-    return false;
+/* Returns the heap position of |handle|, or SCHEDULER_TIMER_HEAP_SIZE if
+ * the handle is not valid. */
+static size_t SchedulerFindTimer(
+    scheduler_t const *scheduler, scheduler_timer_handle_t handle) {
+  uint16_t const slot_idx = TimerHandleSlot(handle);
+  if (slot_idx >= SCHEDULER_TIMER_HEAP_SIZE) return SCHEDULER_TIMER_HEAP_SIZE;
+  scheduler_timer_slot_t const *slot = &scheduler->timer_slots[slot_idx];
+  if (slot->generation != TimerHandleGeneration(handle) ||
+      slot->position >= scheduler->timer_count ||
+      scheduler->timers[slot->position].slot != slot_idx) {
+    return SCHEDULER_TIMER_HEAP_SIZE;
   }
-  return true;
+  return slot->position;
 }
 
-bool_t SchedulerSetDelayedCallbackMicroseconds(
-    scheduler_t *scheduler, uint32_t delay, system_time_t const *current_time,
+static scheduler_timer_handle_t SchedulerSetTimerCallbackInternal(
+    scheduler_t *scheduler, uint32_t duration, bool_t in_seconds,
+    bool_t periodic, system_time_t const *current_time,
     scheduler_timer_callback_t callback, void *callback_ctx) {
-  if (scheduler == NULL || callback == NULL) return false;
-  if (SchedulerIsFull(scheduler)) return false;
-  scheduler_timer_callback_entry_t *entry =
-      SchedulerAllocateTimerCallback(scheduler);
-  *entry = (scheduler_timer_callback_entry_t) {
+  if (scheduler == NULL || callback == NULL) {
+    return SCHEDULER_TIMER_HANDLE_NULL;
+  }
+  if (SchedulerIsTimerFull(scheduler)) return SCHEDULER_TIMER_HANDLE_NULL;
+  scheduler_timer_callback_entry_t entry = {
     .callback = callback,
     .ctx = callback_ctx
   };
+  if (periodic) {
+    entry.period = duration;
+    entry.flags = in_seconds ? TIMER_PERIODIC_S : TIMER_PERIODIC_US;
+  }
 
   if (current_time == NULL) {
-    memcpy(&entry->timer, &scheduler->last_update, sizeof(system_time_t));
+    memcpy(&entry.timer, &scheduler->last_update, sizeof(system_time_t));
   } else {
     if (SystemTimeLessThan(current_time, &scheduler->last_update)) {
-      --scheduler->entry_count;
-      return false;
+      return SCHEDULER_TIMER_HANDLE_NULL;
     }
-    memcpy(&entry->timer, current_time, sizeof(system_time_t));
+    memcpy(&entry.timer, current_time, sizeof(system_time_t));
   }
 
-  if (!SystemTimeIncrementMicroseconds(&entry->timer, delay)) {
-    --scheduler->entry_count;
-    return false;
-  }
-  return true;
+  bool_t const incremented = in_seconds
+      ? SystemTimeIncrementSeconds(&entry.timer, duration)
+      : SystemTimeIncrementMicroseconds(&entry.timer, duration);
+  if (!incremented) return SCHEDULER_TIMER_HANDLE_NULL;
+  return SchedulerPushTimer(scheduler, &entry);
+}
+
+scheduler_timer_handle_t SchedulerSetPeriodicCallbackMicroseconds(
+    scheduler_t *scheduler, uint32_t period, system_time_t const *current_time,
+    scheduler_timer_callback_t callback, void *callback_ctx) {
+  if (period == 0) return SCHEDULER_TIMER_HANDLE_NULL;
+  return SchedulerSetTimerCallbackInternal(
+      scheduler, period, false, true, current_time, callback, callback_ctx);
 }
 
-bool_t SchedulerSetDelayedCallbackSeconds(
+scheduler_timer_handle_t SchedulerSetPeriodicCallbackSeconds(
+    scheduler_t *scheduler, uint32_t period, system_time_t const *current_time,
+    scheduler_timer_callback_t callback, void *callback_ctx) {
+  if (period == 0) return SCHEDULER_TIMER_HANDLE_NULL;
+  return SchedulerSetTimerCallbackInternal(
+      scheduler, period, true, true, current_time, callback, callback_ctx);
+}
+
+scheduler_timer_handle_t SchedulerSetDelayedCallbackMicroseconds(
     scheduler_t *scheduler, uint32_t delay, system_time_t const *current_time,
     scheduler_timer_callback_t callback, void *callback_ctx) {
-  if (scheduler == NULL || callback == NULL) return false;
-  if (SchedulerIsFull(scheduler)) return false;
-  scheduler_timer_callback_entry_t *entry =
-      SchedulerAllocateTimerCallback(scheduler);
-  *entry = (scheduler_timer_callback_entry_t) {
-    .callback = callback,
-    .ctx = callback_ctx
-  };
+  return SchedulerSetTimerCallbackInternal(
+      scheduler, delay, false, false, current_time, callback, callback_ctx);
+}
+
+scheduler_timer_handle_t SchedulerSetDelayedCallbackSeconds(
+    scheduler_t *scheduler, uint32_t delay, system_time_t const *current_time,
+    scheduler_timer_callback_t callback, void *callback_ctx) {
+  return SchedulerSetTimerCallbackInternal(
+      scheduler, delay, true, false, current_time, callback, callback_ctx);
+}
+
+bool_t SchedulerIsTimerPending(
+    scheduler_t const *scheduler, scheduler_timer_handle_t handle) {
+  if (scheduler == NULL) return false;
+  return SchedulerFindTimer(scheduler, handle) < SCHEDULER_TIMER_HEAP_SIZE;
+}
 
+bool_t SchedulerCancelTimer(
+    scheduler_t *scheduler, scheduler_timer_handle_t handle) {
+  if (scheduler == NULL) return false;
+  size_t const idx = SchedulerFindTimer(scheduler, handle);
+  if (idx >= SCHEDULER_TIMER_HEAP_SIZE) return false;
+  SchedulerRemoveTimer(scheduler, idx);
+  return true;
+}
+
+static bool_t SchedulerRescheduleTimerInternal(
+    scheduler_t *scheduler, scheduler_timer_handle_t handle, uint32_t delay,
+    bool_t in_seconds, system_time_t const *current_time) {
+  if (scheduler == NULL) return false;
+  size_t const idx = SchedulerFindTimer(scheduler, handle);
+  if (idx >= SCHEDULER_TIMER_HEAP_SIZE) return false;
+  system_time_t timer;
   if (current_time == NULL) {
-    memcpy(&entry->timer, &scheduler->last_update, sizeof(system_time_t));
+    memcpy(&timer, &scheduler->last_update, sizeof(system_time_t));
   } else {
     if (SystemTimeLessThan(current_time, &scheduler->last_update)) {
-      --scheduler->entry_count;
       return false;
     }
-    memcpy(&entry->timer, current_time, sizeof(system_time_t));
+    memcpy(&timer, current_time, sizeof(system_time_t));
   }
+  bool_t const incremented = in_seconds
+      ? SystemTimeIncrementSeconds(&timer, delay)
+      : SystemTimeIncrementMicroseconds(&timer, delay);
+  if (!incremented) return false;
+  scheduler_timer_callback_entry_t *entry = &scheduler->timers[idx];
+  memcpy(&entry->timer, &timer, sizeof(system_time_t));
+  entry->flags |= TIMER_RESCHEDULED;
+  SchedulerUpdateTimer(scheduler, idx);
+  return true;
+}
 
-  if (!SystemTimeIncrementSeconds(&entry->timer, delay)) {
-    --scheduler->entry_count;
-    return false;
+bool_t SchedulerRescheduleTimerMicroseconds(
+    scheduler_t *scheduler, scheduler_timer_handle_t handle, uint32_t delay,
+    system_time_t const *current_time) {
+  return SchedulerRescheduleTimerInternal(
+      scheduler, handle, delay, false, current_time);
+}
+
+bool_t SchedulerRescheduleTimerSeconds(
+    scheduler_t *scheduler, scheduler_timer_handle_t handle, uint32_t delay,
+    system_time_t const *current_time) {
+  return SchedulerRescheduleTimerInternal(
+      scheduler, handle, delay, true, current_time);
+}
+
+/* Moves a periodic timer to its first deadline after |now|, skipping any
+ * missed periods at once.  Returns false if the timer cannot be moved
+ * past |now|. */
+static bool_t SchedulerAdvancePeriodicTimer(
+    scheduler_timer_callback_entry_t *entry, system_time_t const *now) {
+  bool_t const in_seconds = (entry->flags & TIMER_PERIODIC_S) != 0;
+  bool_t (*incrementer)(system_time_t *, uint32_t) =
+      in_seconds ? SystemTimeIncrementSeconds
+                 : SystemTimeIncrementMicroseconds;
+  uint32_t late;
+  bool_t const has_late = in_seconds
+      ? SystemTimeSecondsDelta(&entry->timer, now, &late)
+      : SystemTimeMicrosecondsDelta(&entry->timer, now, &late);
+  if (has_late) {
+    /* Deltas are rounded down, so one more period always passes |now|. */
+    if (!incrementer(&entry->timer, late - (late % entry->period))) {
+      return false;
+    }
+  } else {
+    /* Too far behind to keep the phase. */
+    memcpy(&entry->timer, now, sizeof(system_time_t));
   }
-  return true;
+  if (!incrementer(&entry->timer, entry->period)) return false;
+  /* Saturated at the maximum time. */
+  return SystemTimeLessThan(now, &entry->timer);
 }
 
 static size_t SchedulerDoTimerCallbacksInternal(scheduler_t *scheduler) {
   size_t job_count = 0;
-  for (size_t i = 0; i < scheduler->entry_count; ++i) {
-    if (scheduler->entries[i].type != TIMER_ENTRY_TYPE) continue;
-    scheduler_timer_callback_entry_t *entry =
-        &scheduler->entries[i].timer_entry;
-    if (SystemTimeLessThan(&scheduler->last_update, &entry->timer)) continue;
+  while (scheduler->timer_count > 0 &&
+         SystemTimeLessThanOrEqual(
+            &scheduler->timers[0].timer, &scheduler->last_update)) {
+    /* The timer stays in the heap during the callback, where it may be
+     * cancelled or rescheduled through its handle. */
+    scheduler_timer_callback_entry_t *entry = &scheduler->timers[0];
+    scheduler_timer_slot_t const *slot = &scheduler->timer_slots[entry->slot];
+    scheduler_timer_handle_t const handle =
+        TimerHandle(slot->generation, entry->slot);
+    entry->flags &= ~TIMER_RESCHEDULED;
     entry->callback(entry->ctx, &scheduler->last_update);
     ++job_count;
-    if (entry->flags & TIMER_PERIODIC) {
-      bool_t (*incrementer)(system_time_t *, uint32_t) =
-          (entry->flags & TIMER_PERIODIC_US) ? SystemTimeIncrementMicroseconds
-                                             : SystemTimeIncrementSeconds;
-      while (SystemTimeLessThanOrEqual(&entry->timer,
-                                       &scheduler->last_update)) {
-        if (!incrementer(&entry->timer, entry->period)) {
-          scheduler->entries[i].type = NULL_ENTRY_TYPE;
-          break;
-        }
-      }
+    size_t const idx = SchedulerFindTimer(scheduler, handle);
+    if (idx >= SCHEDULER_TIMER_HEAP_SIZE) continue;
+    entry = &scheduler->timers[idx];
+    if (entry->flags & TIMER_RESCHEDULED) {
+      entry->flags &= ~TIMER_RESCHEDULED;
+    } else if ((entry->flags & TIMER_PERIODIC) &&
+               SchedulerAdvancePeriodicTimer(entry, &scheduler->last_update)) {
+      SchedulerSiftTimerDown(scheduler, idx);
     } else {
-      scheduler->entries[i].type = NULL_ENTRY_TYPE;
+      SchedulerRemoveTimer(scheduler, idx);
     }
   }
   return job_count;
@@ -249,61 +393,90 @@ static size_t SchedulerDoTimerCallbacksInternal(scheduler_t *scheduler) {
  */
 #define EVENT_REOCCURING  0x01
 
-static scheduler_event_callback_entry_t *SchedulerAllocateEventCallback(
-    scheduler_t *scheduler) {
-  if (scheduler == NULL) return NULL;
-  scheduler_callback_entry_t *entry = SchedulerAllocateCallback(scheduler);
-  memset(entry, 0, sizeof(scheduler_callback_entry_t));
-  entry->type = EVENT_ENTRY_TYPE;
-  return &entry->event_entry;
-}
-
 bool_t SchedulerSetEventCallback(
     scheduler_t *scheduler, scheduler_event_id_t event, bool reoccuring,
     scheduler_event_callback_t callback, void *callback_ctx) {
-  if (scheduler == NULL || event == EVENT_NULL || callback == NULL) return false;
+  if (scheduler == NULL || callback == NULL) return false;
+  if (!SchedulerIsValidEvent(event)) return false;
   if (SchedulerIsFull(scheduler)) return false;
-  scheduler_event_callback_entry_t *entry =
-      SchedulerAllocateEventCallback(scheduler);
+  uint8_t const idx = scheduler->free_entry;
+  scheduler_event_callback_entry_t *entry = &scheduler->entries[idx];
+  scheduler->free_entry = entry->next;
   *entry = (scheduler_event_callback_entry_t) {
     .callback = callback,
     .ctx = callback_ctx,
     .event = event,
-    .flags = reoccuring ? EVENT_REOCCURING : 0
+    .flags = reoccuring ? EVENT_REOCCURING : 0,
+    .next = ENTRY_NULL
   };
+  /* Appended to keep registration order. */
+  uint8_t *link = &scheduler->event_heads[SchedulerEventIndex(event)];
+  while (*link != ENTRY_NULL) link = &scheduler->entries[*link].next;
+  *link = idx;
+  ++scheduler->event_entry_count;
+  ++scheduler->entry_count;
   return true;
 }
 
 bool_t SchedulerTiggerEvent(
     scheduler_t *scheduler, scheduler_event_id_t event) {
-  if (scheduler == NULL || event == EVENT_NULL) return false;
-  if (SchedulerIsEventFull(scheduler)) false;
-  for (size_t i = 0; i < scheduler->event_count; ++i) {
-    if (scheduler->events[i] == event) return true;
+  if (scheduler == NULL || !SchedulerIsValidEvent(event)) return false;
+  uint8_t const idx = SchedulerEventIndex(event);
+  uint8_t const bit = 1 << (idx % 8);
+  /* May be called from an interrupt or the main loop. */
+  system_interrupt_state_t const state = SystemSaveDisableInterrupt();
+  bool_t const pending = (scheduler->pending_events[idx / 8] & bit) != 0;
+  if (!pending) {
+    scheduler->pending_events[idx / 8] |= bit;
+    ++scheduler->event_count;
   }
-  scheduler->events[scheduler->event_count++] = event;
+  SystemRestoreInterrupt(state);
+  if (!pending) SystemWakeUp();
   return true;
 }
 
-static size_t SchedulerDoEventCallbacksInternal(scheduler_t *scheduler) {
+/* Calls all callbacks of |event|, removing those which do not reoccur. */
+static size_t SchedulerDoEventCallbacks(
+    scheduler_t *scheduler, scheduler_event_id_t event) {
   size_t job_count = 0;
-  for (size_t i = 0; i < scheduler->entry_count; ++i) {
-    if (scheduler->entries[i].type != EVENT_ENTRY_TYPE) continue;
-    scheduler_event_callback_entry_t *entry =
-        &scheduler->entries[i].event_entry;
-    bool_t executed = false;
-    for (size_t j = 0; j < scheduler->event_count && !executed; ++j) {
-      scheduler_event_id_t const event = scheduler->events[j];
-      if (entry->event != event) continue;
-      entry->callback(entry->ctx, event, &scheduler->last_update);
-      executed = true;
-      ++job_count;
-      if (entry->flags & EVENT_REOCCURING) continue;
-      scheduler->entries[i].type = NULL_ENTRY_TYPE;
+  uint8_t *link = &scheduler->event_heads[SchedulerEventIndex(event)];
+  while (*link != ENTRY_NULL) {
+    uint8_t const idx = *link;
+    scheduler_event_callback_entry_t *entry = &scheduler->entries[idx];
+    entry->callback(entry->ctx, event, &scheduler->last_update);
+    ++job_count;
+    if (entry->flags & EVENT_REOCCURING) {
+      link = &entry->next;
+      continue;
     }
+    /* Callbacks registered during the call are appended after |entry|,
+     * so its next index is read after the call. */
+    *link = entry->next;
+    entry->next = scheduler->free_entry;
+    scheduler->free_entry = idx;
+    --scheduler->event_entry_count;
+    --scheduler->entry_count;
   }
+  return job_count;
+}
+
+static size_t SchedulerDoEventCallbacksInternal(scheduler_t *scheduler) {
+  if (scheduler->event_count == 0) return 0;
+  /* Events triggered during the callbacks remain pending for the next
+   * call. */
+  uint8_t pending_events[SCHEDULER_EVENT_ID_COUNT / 8];
   SystemDisableInterrupt();
+  memcpy(pending_events, scheduler->pending_events, sizeof(pending_events));
+  memset(scheduler->pending_events, 0, sizeof(pending_events));
   scheduler->event_count = 0;
   SystemEnableInterrupt();
+  size_t job_count = 0;
+  for (uint8_t i = 0; i < sizeof(pending_events); ++i) {
+    uint8_t bits = pending_events[i];
+    for (uint8_t bit = 0; bits != 0; ++bit, bits >>= 1) {
+      if (!(bits & 0x01)) continue;
+      job_count += SchedulerDoEventCallbacks(scheduler, (i * 8) + bit + 1);
+    }
+  }
   return job_count;
 }
@@ -29,8 +29,23 @@ typedef struct {
   uint8_t flags;
   /* Period is only used for periodic callbacks. */
   uint32_t period;
+  /* Handle slot of the timer.  Used internally. */
+  uint16_t slot;
 } scheduler_timer_callback_entry_t;
 
+/* Handle to a timer callback, valid until the callback is removed
+ * (called for the last time, cancelled or cleared).  Handles of removed
+ * callbacks are never reused for other callbacks. */
+typedef uint32_t scheduler_timer_handle_t;
+#define SCHEDULER_TIMER_HANDLE_NULL 0
+
+typedef struct {
+  /* Position of the timer in the heap, or the next unused slot. */
+  uint16_t position;
+  /* Incremented each time the slot is released. */
+  uint16_t generation;
+} scheduler_timer_slot_t;
+
 /*
  * Event-Based Callbacks.
  */
@@ -47,34 +62,62 @@ typedef struct {
   scheduler_event_id_t event;
   /* Flags used internally for operation. */
   uint8_t flags;
+  /* Index of the next callback for the same event (or the next unused
+   * entry).  Used internally. */
+  uint8_t next;
 } scheduler_event_callback_entry_t;
 
+/* Valid event IDs are 1 to SCHEDULER_EVENT_ID_COUNT.  Each event ID has
+ * one pending bit, so this must be a multiple of 8. */
+#ifndef SCHEDULER_EVENT_ID_COUNT
+#define SCHEDULER_EVENT_ID_COUNT 32
+#endif
 
-typedef struct {
-  uint8_t type;
-  union {
-    scheduler_timer_callback_entry_t timer_entry;
-    scheduler_event_callback_entry_t event_entry;
-  };
-} scheduler_callback_entry_t;
-
-/* Number of events that can be registered. */
-#ifndef SCHEDULER_EVENT_QUEUE_SIZE
-#define SCHEDULER_EVENT_QUEUE_SIZE 8
+#if (SCHEDULER_EVENT_ID_COUNT % 8) != 0
+#error "SCHEDULER_EVENT_ID_COUNT must be a multiple of 8"
 #endif
 
-/* Number of callbacks that can be registered in the scheduler. */
+/* Number of event callbacks that can be registered in the scheduler. */
 #ifndef SCHEDULER_CALLBACK_TABLE_SIZE
 #define SCHEDULER_CALLBACK_TABLE_SIZE 16
 #endif
 
+#if SCHEDULER_CALLBACK_TABLE_SIZE > 255
+#error "SCHEDULER_CALLBACK_TABLE_SIZE must fit in an 8-bit index"
+#endif
+
+/* Number of timer callbacks that can be pending in the scheduler.
+ * Timers are kept separately from event callbacks, so sequencers with
+ * many pending note-off timers may raise this without growing the
+ * event callback table. */
+#ifndef SCHEDULER_TIMER_HEAP_SIZE
+#define SCHEDULER_TIMER_HEAP_SIZE 16
+#endif
+
+#if SCHEDULER_TIMER_HEAP_SIZE >= 0xFFFF
+#error "SCHEDULER_TIMER_HEAP_SIZE must fit in a 16-bit index"
+#endif
+
 typedef struct {
   system_time_t last_update;
-  /* List of events that have occured and are awaiting callbacks. */
-  scheduler_event_id_t events[SCHEDULER_EVENT_QUEUE_SIZE];
+  /* Events that have occured and are awaiting callbacks, one bit per
+   * event ID (bit ID - 1). */
+  uint8_t pending_events[SCHEDULER_EVENT_ID_COUNT / 8];
   size_t event_count;
-  /* List of all callbacks. */
-  scheduler_callback_entry_t entries[SCHEDULER_CALLBACK_TABLE_SIZE];
+  /* Timer callbacks, kept as a binary min-heap ordered by deadline.  The
+   * earliest timer is always timers[0]. */
+  scheduler_timer_callback_entry_t timers[SCHEDULER_TIMER_HEAP_SIZE];
+  size_t timer_count;
+  /* Maps timer handles to heap positions. */
+  scheduler_timer_slot_t timer_slots[SCHEDULER_TIMER_HEAP_SIZE];
+  uint16_t free_timer_slot;
+  /* Event callbacks, linked into one list per event ID, in order of
+   * registration.  Unused entries are linked into a free list. */
+  scheduler_event_callback_entry_t entries[SCHEDULER_CALLBACK_TABLE_SIZE];
+  uint8_t event_heads[SCHEDULER_EVENT_ID_COUNT];
+  uint8_t free_entry;
+  size_t event_entry_count;
+  /* Total number of registered callbacks, timer and event. */
   size_t entry_count;
   /* Flags used internally for operation. */
   uint8_t flags;
@@ -84,29 +127,73 @@ bool_t SchedulerInitialize(
   scheduler_t *scheduler, system_time_t const *init_time);
 bool_t SchedulerClearEvents(scheduler_t *scheduler);
 bool_t SchedulerClearCallbacks(scheduler_t *scheduler);
+/* Calls all timer callbacks which are due at |time| and all event
+ * callbacks for triggered events.  Timers which are due at the same
+ * time are called in no particular order.  Returns the number of
+ * callbacks called. */
 size_t SchedulerDoCallbacks(
   scheduler_t *scheduler, system_time_t const *time);
 
+/* Gets the time at which SchedulerDoCallbacks() next has work to do.  If
+ * events are pending, this is the time of the last update.  Returns
+ * false if no timers or events are pending, in which case only a newly
+ * triggered event or registered timer will create work. */
+bool_t SchedulerNextDeadline(
+  scheduler_t const *scheduler, system_time_t *deadline);
+
+/* Sleeps until the next deadline, or until an event is triggered or
+ * the system is otherwise woken (see SystemWakeUp()).  Intended to be
+ * called from the main loop, between calls to SchedulerDoCallbacks(),
+ * in place of polling.  May return before the deadline. */
+void SchedulerIdle(scheduler_t const *scheduler);
+
 /* For the timer callback setter, if |current_time| is NULL, the period is
- * assumed to be from the schedulers last update.*/
-bool_t SchedulerSetPeriodicCallbackMicroseconds(
+ * assumed to be from the schedulers last update.
+ * Returns a handle to the callback, or SCHEDULER_TIMER_HANDLE_NULL if the
+ * callback could not be set. */
+scheduler_timer_handle_t SchedulerSetPeriodicCallbackMicroseconds(
   scheduler_t *scheduler, uint32_t period, system_time_t const *current_time,
   scheduler_timer_callback_t callback, void *callback_ctx);
-bool_t SchedulerSetPeriodicCallbackSeconds(
+scheduler_timer_handle_t SchedulerSetPeriodicCallbackSeconds(
   scheduler_t *scheduler, uint32_t period, system_time_t const *current_time,
   scheduler_timer_callback_t callback, void *callback_ctx);
 
-bool_t SchedulerSetDelayedCallbackMicroseconds(
+scheduler_timer_handle_t SchedulerSetDelayedCallbackMicroseconds(
   scheduler_t *scheduler, uint32_t delay, system_time_t const *current_time,
   scheduler_timer_callback_t callback, void *callback_ctx);
-bool_t SchedulerSetDelayedCallbackSeconds(
+scheduler_timer_handle_t SchedulerSetDelayedCallbackSeconds(
   scheduler_t *scheduler, uint32_t delay, system_time_t const *current_time,
   scheduler_timer_callback_t callback, void *callback_ctx);
 
+/* Returns true if |handle| refers to a callback which will still be
+ * called. */
+bool_t SchedulerIsTimerPending(
+  scheduler_t const *scheduler, scheduler_timer_handle_t handle);
+
+/* Removes the callback of |handle|.  Returns false if the handle is no
+ * longer valid.  May be called from within any timer callback,
+ * including the cancelled one. */
+bool_t SchedulerCancelTimer(
+  scheduler_t *scheduler, scheduler_timer_handle_t handle);
+
+/* Moves the next call of |handle| to |delay| after |current_time| (or
+ * the last update if NULL).  Periodic callbacks keep their period from
+ * the new time.  The handle remains valid.  Returns false if the handle
+ * is no longer valid. */
+bool_t SchedulerRescheduleTimerMicroseconds(
+  scheduler_t *scheduler, scheduler_timer_handle_t handle, uint32_t delay,
+  system_time_t const *current_time);
+bool_t SchedulerRescheduleTimerSeconds(
+  scheduler_t *scheduler, scheduler_timer_handle_t handle, uint32_t delay,
+  system_time_t const *current_time);
+
 bool_t SchedulerSetEventCallback(
   scheduler_t *scheduler, scheduler_event_id_t event_id, bool reoccuring,
   scheduler_event_callback_t callback, void *callback_ctx);
 
+/* Marks |event| as pending; triggering an already pending event has no
+ * effect.  Safe to call from interrupts.  Wakes the system from
+ * SchedulerIdle(). */
 bool_t SchedulerTiggerEvent(
   scheduler_t *scheduler, scheduler_event_id_t event);
 
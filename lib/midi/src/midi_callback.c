@@ -7,16 +7,34 @@
  */
 #include <string.h>
 
+#include "program_memory.h"
+
 #include "midi_callback.h"
 #include "midi_callback_internal.h"
 #include "midi_defs.h"
+#include "midi_event_queue.h"
+
+bool_t MidiInitializeRxCallbacks(midi_rx_callbacks_t *rx) {
+  if (rx == NULL) return false;
+  memset(rx, 0, sizeof(midi_rx_callbacks_t));
+  rx->next_rx_event_id = 1;
+  rx->next_sys_ex_rx_event_id = 1;
+  rx->channel_mask = MIDI_CHANNEL_MASK_ALL;
+  return true;
+}
+
+bool_t MidiInitializeChannelCallbacks(
+    midi_channel_callbacks_t *channel_callbacks) {
+  if (channel_callbacks == NULL) return false;
+  memset(channel_callbacks, 0, sizeof(midi_channel_callbacks_t));
+  return true;
+}
 
 bool_t MidiInitializeCallbacks(midi_callbacks_t *callbacks) {
   if (callbacks == NULL) return false;
   memset(callbacks, 0, sizeof(midi_callbacks_t));
   callbacks->next_event_id = 1;
-  callbacks->rx.next_rx_event_id = 1;
-  callbacks->rx.next_sys_ex_rx_event_id = 1;
+  MidiInitializeRxCallbacks(&callbacks->rx);
   callbacks->tx.next_tx_event_id = 1;
   return true;
 }
@@ -32,6 +50,14 @@ bool_t MidiIsValidCallbacks(midi_callbacks_t const *callbacks) {
   return true;
 }
 
+/* |subscriber_ends| is stored as uint8_t. */
+#if MIDI_SUBSCRIBER_POOL_SIZE > 255
+# error "MIDI_SUBSCRIBER_POOL_SIZE must not be larger than 255"
+#endif
+
+#define MidiSubscriberStart(rx, index) \
+  ((index) == 0 ? 0 : (size_t) (rx)->subscriber_ends[(index) - 1])
+
 static void MidiIncrementEventCounter(uint32_t *counter) {
   ++(*counter);
   if (*counter == 0) ++(*counter);
@@ -39,7 +65,7 @@ static void MidiIncrementEventCounter(uint32_t *counter) {
 
 static bool_t MidiCallSysExMessageCallback(
     midi_callbacks_t const *callbacks, midi_time_t const *time,
-    midi_message_t const *message) {
+    midi_timestamp_t timestamp, midi_message_t const *message) {
   midi_rx_callbacks_t const *rx = &callbacks->rx;
   midi_sys_ex_t const *sys_ex = &message->sys_ex;
   midi_sys_ex_rx_event_t sys_ex_event = {
@@ -49,6 +75,7 @@ static bool_t MidiCallSysExMessageCallback(
         .time = time
       },
       .rx_event_id = rx->next_rx_event_id,
+      .timestamp = timestamp,
       .message = message,
       .user_ctx = NULL
     },
@@ -112,158 +139,409 @@ static bool_t MidiCallSysExMessageCallback(
   return false;
 }
 
-static bool_t MidiCallMessageCallback(
-    midi_callbacks_t const *callbacks, midi_time_t const *time,
+/* Message invokers.
+ *  Each calls the message type specific callbacks, assuming that the
+ *  generic |rx_event| has already been passed to OnMessage(). */
+typedef void (*midi_message_invoker_t) (
+  midi_rx_callbacks_t const *, midi_rx_event_t *, midi_message_t const *);
+
+static void MidiInvokeNoteOff(
+    midi_rx_callbacks_t const *rx, midi_rx_event_t *rx_event,
     midi_message_t const *message) {
-  midi_rx_callbacks_t const *rx = &callbacks->rx;
+  if (rx->OnNoteOff == NULL) return;
+  rx_event->user_ctx = rx->note_ctx;
+  rx->OnNoteOff(rx_event, message->channel, &message->note);
+}
+
+static void MidiInvokeNoteOn(
+    midi_rx_callbacks_t const *rx, midi_rx_event_t *rx_event,
+    midi_message_t const *message) {
+  if (rx->OnNoteOn == NULL) return;
+  rx_event->user_ctx = rx->note_ctx;
+  rx->OnNoteOn(rx_event, message->channel, &message->note);
+}
+
+static void MidiInvokeKeyPressure(
+    midi_rx_callbacks_t const *rx, midi_rx_event_t *rx_event,
+    midi_message_t const *message) {
+  if (rx->OnKeyPressure == NULL) return;
+  rx_event->user_ctx = rx->note_ctx;
+  rx->OnKeyPressure(rx_event, message->channel, &message->note);
+}
+
+static void MidiInvokeControlChange(
+    midi_rx_callbacks_t const *rx, midi_rx_event_t *rx_event,
+    midi_message_t const *message) {
+  if (rx->OnControlChange == NULL) return;
+  rx_event->user_ctx = rx->control_change_ctx;
+  rx->OnControlChange(rx_event, message->channel, &message->control);
+}
+
+static void MidiInvokeProgramChange(
+    midi_rx_callbacks_t const *rx, midi_rx_event_t *rx_event,
+    midi_message_t const *message) {
+  if (rx->OnProgramChange == NULL) return;
+  rx_event->user_ctx = rx->program_change_ctx;
+  rx->OnProgramChange(rx_event, message->channel, message->program);
+}
+
+static void MidiInvokeChannelPressure(
+    midi_rx_callbacks_t const *rx, midi_rx_event_t *rx_event,
+    midi_message_t const *message) {
+  if (rx->OnChannelPressureChange == NULL) return;
+  rx_event->user_ctx = rx->channel_pressure_ctx;
+  rx->OnChannelPressureChange(rx_event, message->channel, message->pressure);
+}
+
+static void MidiInvokePitchWheel(
+    midi_rx_callbacks_t const *rx, midi_rx_event_t *rx_event,
+    midi_message_t const *message) {
+  if (rx->OnPitchWheelChange == NULL) return;
+  rx_event->user_ctx = rx->pitch_wheel_ctx;
+  rx->OnPitchWheelChange(rx_event, message->channel, message->pitch);
+}
+
+static void MidiInvokeSongPosition(
+    midi_rx_callbacks_t const *rx, midi_rx_event_t *rx_event,
+    midi_message_t const *message) {
+  if (rx->OnSongPosition == NULL) return;
+  rx_event->user_ctx = rx->song_position_ctx;
+  rx->OnSongPosition(rx_event, message->song_position);
+}
+
+static void MidiInvokeSongSelect(
+    midi_rx_callbacks_t const *rx, midi_rx_event_t *rx_event,
+    midi_message_t const *message) {
+  if (rx->OnSongSelect == NULL) return;
+  rx_event->user_ctx = rx->song_select_ctx;
+  rx->OnSongSelect(rx_event, message->song_number);
+}
+
+static void MidiInvokeTuneRequest(
+    midi_rx_callbacks_t const *rx, midi_rx_event_t *rx_event,
+    midi_message_t const *message) {
+  if (rx->OnTuneRequest == NULL) return;
+  rx_event->user_ctx = rx->tune_request_ctx;
+  rx->OnTuneRequest(rx_event);
+}
+
+static void MidiInvokeTimingClock(
+    midi_rx_callbacks_t const *rx, midi_rx_event_t *rx_event,
+    midi_message_t const *message) {
+  if (rx->OnTimingClock == NULL) return;
+  rx_event->user_ctx = rx->timing_clock_ctx;
+  rx->OnTimingClock(rx_event);
+}
+
+static void MidiInvokePlayback(
+    midi_rx_callbacks_t const *rx, midi_rx_event_t *rx_event,
+    midi_message_t const *message) {
+  rx_event->user_ctx = rx->playback_ctx;
+  if (rx->OnPlayback != NULL) {
+    rx->OnPlayback(rx_event, message->type);
+  }
+  if (message->type == MIDI_START && rx->OnStartPlayback != NULL) {
+    rx->OnStartPlayback(rx_event);
+  } else if (message->type == MIDI_CONTINUE &&
+             rx->OnContinuePlayback != NULL) {
+    rx->OnContinuePlayback(rx_event);
+  } else if (message->type == MIDI_STOP && rx->OnStopPlayback != NULL) {
+    rx->OnStopPlayback(rx_event);
+  }
+}
+
+static void MidiInvokeActiveSensing(
+    midi_rx_callbacks_t const *rx, midi_rx_event_t *rx_event,
+    midi_message_t const *message) {
+  if (rx->OnActiveSensing == NULL) return;
+  rx_event->user_ctx = rx->active_sensing_ctx;
+  rx->OnActiveSensing(rx_event);
+}
+
+/* Indexed by MidiMessageTypeIndex().  Message types without an entry
+ * are not handled by MidiCallMessageCallback(). */
+static midi_message_invoker_t const
+    kMidiMessageInvokers[MIDI_MESSAGE_TYPE_COUNT] __ROM_SECTION = {
+  /* Channel messages. */
+  MidiInvokeNoteOff,
+  MidiInvokeNoteOn,
+  MidiInvokeKeyPressure,
+  MidiInvokeControlChange,
+  MidiInvokeProgramChange,
+  MidiInvokeChannelPressure,
+  MidiInvokePitchWheel,
+  /* System exclusive, time code. */
+  NULL, NULL,
+  MidiInvokeSongPosition,
+  MidiInvokeSongSelect,
+  NULL, NULL,
+  MidiInvokeTuneRequest,
+  /* End of SysEx. */
+  NULL,
+  /* System realtime. */
+  MidiInvokeTimingClock,
+  NULL,
+  MidiInvokePlayback,
+  MidiInvokePlayback,
+  MidiInvokePlayback,
+  NULL,
+  MidiInvokeActiveSensing,
+  /* System reset. */
+  NULL
+};
+
+/* Calls the callbacks of a per-channel set.  Only channel messages
+ * are routed to a per-channel set, so every type has a callback. */
+static void MidiInvokeChannelCallbacks(
+    midi_channel_callbacks_t const *channel, midi_rx_event_t *rx_event,
+    midi_message_t const *message) {
+  switch (message->type) {
+    case MIDI_NOTE_OFF:
+      if (channel->OnNoteOff == NULL) return;
+      rx_event->user_ctx = channel->note_ctx;
+      channel->OnNoteOff(rx_event, message->channel, &message->note);
+      return;
+    case MIDI_NOTE_ON:
+      if (channel->OnNoteOn == NULL) return;
+      rx_event->user_ctx = channel->note_ctx;
+      channel->OnNoteOn(rx_event, message->channel, &message->note);
+      return;
+    case MIDI_KEY_PRESSURE:
+      if (channel->OnKeyPressure == NULL) return;
+      rx_event->user_ctx = channel->note_ctx;
+      channel->OnKeyPressure(rx_event, message->channel, &message->note);
+      return;
+    case MIDI_CONTROL_CHANGE:
+      if (channel->OnControlChange == NULL) return;
+      rx_event->user_ctx = channel->control_change_ctx;
+      channel->OnControlChange(rx_event, message->channel, &message->control);
+      return;
+    case MIDI_PROGRAM_CHANGE:
+      if (channel->OnProgramChange == NULL) return;
+      rx_event->user_ctx = channel->program_change_ctx;
+      channel->OnProgramChange(rx_event, message->channel, message->program);
+      return;
+    case MIDI_CHANNEL_PRESSURE:
+      if (channel->OnChannelPressureChange == NULL) return;
+      rx_event->user_ctx = channel->channel_pressure_ctx;
+      channel->OnChannelPressureChange(
+          rx_event, message->channel, message->pressure);
+      return;
+    case MIDI_PITCH_WHEEL:
+      if (channel->OnPitchWheelChange == NULL) return;
+      rx_event->user_ctx = channel->pitch_wheel_ctx;
+      channel->OnPitchWheelChange(rx_event, message->channel, message->pitch);
+      return;
+  }
+}
+
+static bool_t MidiCallChannelMessageCallback(
+    midi_channel_callbacks_t const *channel, uint32_t event_id,
+    uint32_t rx_event_id, midi_time_t const *time,
+    midi_timestamp_t timestamp, midi_message_t const *message) {
+  size_t const index = MidiMessageTypeIndex(message->type);
+  midi_fast_handler_slot_t const *fast = &channel->fast_handlers[index];
+  if (fast->handler != NULL) {
+    fast->handler(fast->ctx, message);
+    return true;
+  }
   midi_rx_event_t rx_event = {
     .general = {
-      .event_id = callbacks->next_event_id,
+      .event_id = event_id,
       .time = time
     },
-    .rx_event_id = rx->next_rx_event_id,
+    .rx_event_id = rx_event_id,
+    .timestamp = timestamp,
     .message = message,
     .user_ctx = NULL
   };
+  if (channel->OnMessage) {
+    rx_event.user_ctx = channel->message_ctx;
+    channel->OnMessage(&rx_event);
+  }
+  MidiInvokeChannelCallbacks(channel, &rx_event, message);
+  return true;
+}
+
+static bool_t MidiCallMessageCallback(
+    midi_callbacks_t const *callbacks, uint32_t event_id,
+    uint32_t rx_event_id, midi_time_t const *time,
+    midi_timestamp_t timestamp, midi_message_t const *message) {
+  /* Counters are always taken from the main set. */
+  midi_rx_callbacks_t const *rx = &callbacks->rx;
+  /* |message->type| is already known to be valid. */
+  if (message->type < MIDI_SYSTEM_EXCLUSIVE &&
+      MidiIsValidChannelNumber(message->channel) &&
+      rx->channel_callbacks[message->channel] != NULL) {
+    return MidiCallChannelMessageCallback(
+        rx->channel_callbacks[message->channel], event_id, rx_event_id,
+        time, timestamp, message);
+  }
+  size_t const index = MidiMessageTypeIndex(message->type);
+  midi_message_invoker_t invoker;
+  ProgMemoryCopy(&kMidiMessageInvokers[index], &invoker, sizeof(invoker));
+  if (invoker != NULL) {
+    midi_fast_handler_slot_t const *fast = &rx->fast_handlers[index];
+    if (fast->handler != NULL) {
+      fast->handler(fast->ctx, message);
+      return true;
+    }
+  }
 
+  midi_rx_event_t rx_event = {
+    .general = {
+      .event_id = event_id,
+      .time = time
+    },
+    .rx_event_id = rx_event_id,
+    .timestamp = timestamp,
+    .message = message,
+    .user_ctx = NULL
+  };
   if (rx->OnMessage) {
     rx_event.user_ctx = rx->message_ctx;
     rx->OnMessage(&rx_event);
   }
+  /* Messages without an invoker are still passed to OnMessage(), but
+   * are not considered handled. */
+  if (invoker == NULL) return false;
+  invoker(rx, &rx_event, message);
+  size_t const end = rx->subscriber_ends[index];
+  for (size_t i = MidiSubscriberStart(rx, index); i < end; ++i) {
+    rx_event.user_ctx = rx->subscribers[i].ctx;
+    rx->subscribers[i].callback(&rx_event);
+  }
+  return true;
+}
 
-  switch (message->type) {
-    case MIDI_NOTE_OFF: {
-      if (rx->OnNoteOff != NULL) {
-        rx_event.user_ctx = rx->note_ctx;
-        rx->OnNoteOff(&rx_event, message->channel, &message->note);
-      }
-      return true;
-    }
-    case MIDI_NOTE_ON: {
-      if (rx->OnNoteOn != NULL) {
-        rx_event.user_ctx = rx->note_ctx;
-        rx->OnNoteOn(&rx_event, message->channel, &message->note);
-      }
-      return true;
-    }
-    case MIDI_KEY_PRESSURE: {
-      if (rx->OnKeyPressure != NULL) {
-        rx_event.user_ctx = rx->note_ctx;
-        rx->OnKeyPressure(&rx_event, message->channel, &message->note);
-      }
-      return true;
-    }
-    case MIDI_CONTROL_CHANGE: {
-      if (rx->OnControlChange != NULL) {
-        rx_event.user_ctx = rx->control_change_ctx;
-        rx->OnControlChange(&rx_event, message->channel, &message->control);
-      }
-      return true;
-    }
-    case MIDI_PROGRAM_CHANGE: {
-      if (rx->OnProgramChange != NULL) {
-        rx_event.user_ctx = rx->program_change_ctx;
-        rx->OnProgramChange(&rx_event, message->channel, message->program);
-      }
-      return true;
-    }
-    case MIDI_CHANNEL_PRESSURE: {
-      if (rx->OnChannelPressureChange != NULL) {
-        rx_event.user_ctx = rx->channel_pressure_ctx;
-        rx->OnChannelPressureChange(
-            &rx_event, message->channel, message->pressure);
-      }
-      return true;
-    }
-    case MIDI_PITCH_WHEEL: {
-      if (rx->OnPitchWheelChange != NULL) {
-        rx_event.user_ctx = rx->pitch_wheel_ctx;
-        rx->OnPitchWheelChange(
-            &rx_event, message->channel, message->pitch);
-      }
-      return true;
-    }
-    case MIDI_SONG_POSITION_POINTER: {
-      if (rx->OnSongPosition != NULL) {
-        rx_event.user_ctx = rx->song_position_ctx;
-        rx->OnSongPosition(&rx_event, message->song_position);
-      }
-      return true;
-    }
-    case MIDI_SONG_SELECT: {
-      if (rx->OnSongSelect != NULL) {
-        rx_event.user_ctx = rx->song_select_ctx;
-        rx->OnSongSelect(&rx_event, message->song_number);
-      }
-      return true;
-    }
-    case MIDI_TUNE_REQUEST: {
-      if (rx->OnTuneRequest != NULL) {
-        rx_event.user_ctx = rx->tune_request_ctx;
-        rx->OnTuneRequest(&rx_event);
-      }
-      return true;
-    }
-    case MIDI_TIMING_CLOCK: {
-      if (rx->OnTimingClock != NULL) {
-        rx_event.user_ctx = rx->timing_clock_ctx;
-        rx->OnTimingClock(&rx_event);
-      }
-      return true;
-    }
-    case MIDI_START: {
-      if (rx->OnPlayback != NULL) {
-        rx_event.user_ctx = rx->playback_ctx;
-        rx->OnPlayback(&rx_event, MIDI_START);
-      }
-      if (rx->OnStartPlayback != NULL) {
-        rx_event.user_ctx = rx->playback_ctx;
-        rx->OnStartPlayback(&rx_event);
-      }
-      return true;
-    }
-    case MIDI_CONTINUE: {
-      if (rx->OnPlayback != NULL) {
-        rx_event.user_ctx = rx->playback_ctx;
-        rx->OnPlayback(&rx_event, MIDI_CONTINUE);
-      }
-      if (rx->OnContinuePlayback != NULL) {
-        rx_event.user_ctx = rx->playback_ctx;
-        rx->OnContinuePlayback(&rx_event);
-      }
-      return true;
-    }
-    case MIDI_STOP: {
-      if (rx->OnPlayback != NULL) {
-        rx_event.user_ctx = rx->playback_ctx;
-        rx->OnPlayback(&rx_event, MIDI_STOP);
-      }
-      if (rx->OnStopPlayback != NULL) {
-        rx_event.user_ctx = rx->playback_ctx;
-        rx->OnStopPlayback(&rx_event);
-      }
-      return true;
-    }
-    case MIDI_ACTIVE_SENSING: {
-      if (rx->OnActiveSensing != NULL) {
-        rx_event.user_ctx = rx->active_sensing_ctx;
-        rx->OnActiveSensing(&rx_event);
-      }
-      return true;
-    }
-    case MIDI_TIME_CODE:
-    case MIDI_SYSTEM_RESET:
-    case MIDI_END_SYSTEM_EXCLUSIVE: {
-      /* WUT? */
-      return false;
+bool_t MidiSetFastMessageHandler(
+    midi_rx_callbacks_t *rx, midi_message_type_t message_type,
+    midi_fast_message_handler_t handler, void *ctx) {
+  if (rx == NULL) return false;
+  if (!MidiIsValidMessageType(message_type)) return false;
+  size_t const index = MidiMessageTypeIndex(message_type);
+  midi_message_invoker_t invoker;
+  ProgMemoryCopy(&kMidiMessageInvokers[index], &invoker, sizeof(invoker));
+  if (invoker == NULL) return false;
+  rx->fast_handlers[index].handler = handler;
+  rx->fast_handlers[index].ctx = (handler != NULL) ? ctx : NULL;
+  return true;
+}
+
+bool_t MidiSetChannelFastMessageHandler(
+    midi_channel_callbacks_t *channel_callbacks,
+    midi_message_type_t message_type,
+    midi_fast_message_handler_t handler, void *ctx) {
+  if (channel_callbacks == NULL) return false;
+  if (!MidiIsValidMessageType(message_type)) return false;
+  if (!MidiIsChannelMessageType(message_type)) return false;
+  size_t const index = MidiMessageTypeIndex(message_type);
+  channel_callbacks->fast_handlers[index].handler = handler;
+  channel_callbacks->fast_handlers[index].ctx =
+      (handler != NULL) ? ctx : NULL;
+  return true;
+}
+
+static bool_t MidiIsSubscribableType(midi_message_type_t message_type) {
+  if (!MidiIsValidMessageType(message_type)) return false;
+  midi_message_invoker_t invoker;
+  ProgMemoryCopy(
+      &kMidiMessageInvokers[MidiMessageTypeIndex(message_type)],
+      &invoker, sizeof(invoker));
+  return invoker != NULL;
+}
+
+/* Returns the pool index of the subscriber, or MIDI_SUBSCRIBER_POOL_SIZE
+ * if not found. */
+static size_t MidiFindSubscriber(
+    midi_rx_callbacks_t const *rx, size_t index,
+    midi_message_callback_t callback, void *ctx) {
+  size_t const end = rx->subscriber_ends[index];
+  for (size_t i = MidiSubscriberStart(rx, index); i < end; ++i) {
+    if (rx->subscribers[i].callback == callback &&
+        rx->subscribers[i].ctx == ctx) {
+      return i;
     }
   }
-  return false;
+  return MIDI_SUBSCRIBER_POOL_SIZE;
+}
+
+bool_t MidiAddSubscriber(
+    midi_rx_callbacks_t *rx, midi_message_type_t message_type,
+    midi_message_callback_t callback, void *ctx) {
+  if (rx == NULL || callback == NULL) return false;
+  if (!MidiIsSubscribableType(message_type)) return false;
+  size_t const total = rx->subscriber_ends[MIDI_MESSAGE_TYPE_COUNT - 1];
+  if (total == MIDI_SUBSCRIBER_POOL_SIZE) return false;
+  size_t const index = MidiMessageTypeIndex(message_type);
+  if (MidiFindSubscriber(rx, index, callback, ctx) !=
+      MIDI_SUBSCRIBER_POOL_SIZE) {
+    return false;
+  }
+  /* Insert at the end of the type's group, shifting later groups. */
+  size_t const position = rx->subscriber_ends[index];
+  memmove(&rx->subscribers[position + 1], &rx->subscribers[position],
+          (total - position) * sizeof(midi_subscriber_t));
+  rx->subscribers[position].callback = callback;
+  rx->subscribers[position].ctx = ctx;
+  for (size_t i = index; i < MIDI_MESSAGE_TYPE_COUNT; ++i) {
+    ++rx->subscriber_ends[i];
+  }
+  return true;
+}
+
+bool_t MidiRemoveSubscriber(
+    midi_rx_callbacks_t *rx, midi_message_type_t message_type,
+    midi_message_callback_t callback, void *ctx) {
+  if (rx == NULL || callback == NULL) return false;
+  if (!MidiIsSubscribableType(message_type)) return false;
+  size_t const index = MidiMessageTypeIndex(message_type);
+  size_t const position = MidiFindSubscriber(rx, index, callback, ctx);
+  if (position == MIDI_SUBSCRIBER_POOL_SIZE) return false;
+  size_t const total = rx->subscriber_ends[MIDI_MESSAGE_TYPE_COUNT - 1];
+  memmove(&rx->subscribers[position], &rx->subscribers[position + 1],
+          (total - position - 1) * sizeof(midi_subscriber_t));
+  memset(&rx->subscribers[total - 1], 0, sizeof(midi_subscriber_t));
+  for (size_t i = index; i < MIDI_MESSAGE_TYPE_COUNT; ++i) {
+    --rx->subscriber_ends[i];
+  }
+  return true;
+}
+
+bool_t MidiSetChannelMask(
+    midi_callbacks_t *callbacks, midi_channel_mask_t channel_mask) {
+  if (callbacks == NULL) return false;
+  callbacks->rx.channel_mask = channel_mask;
+  return true;
+}
+
+bool_t MidiSetChannelCallbacks(
+    midi_callbacks_t *callbacks, midi_channel_number_t channel_number,
+    midi_channel_callbacks_t const *channel_callbacks) {
+  if (callbacks == NULL) return false;
+  if (!MidiIsValidChannelNumber(channel_number)) return false;
+  callbacks->rx.channel_callbacks[channel_number] = channel_callbacks;
+  return true;
+}
+
+bool_t MidiSetEventQueue(
+    midi_callbacks_t *callbacks, struct midi_event_queue_s *event_queue) {
+  if (callbacks == NULL) return false;
+  if (event_queue != NULL && event_queue->callbacks != callbacks)
+    return false;
+  callbacks->event_queue = event_queue;
+  return true;
 }
 
 bool_t MidiCallOnMessageCallback(
     midi_callbacks_t *callbacks, midi_time_t const *time,
     midi_message_t const *message) {
+  return MidiCallOnTimestampedMessageCallback(callbacks, time, 0, message);
+}
+
+bool_t MidiCallOnTimestampedMessageCallback(
+    midi_callbacks_t *callbacks, midi_time_t const *time,
+    midi_timestamp_t timestamp, midi_message_t const *message) {
   if (callbacks == NULL || message == NULL) return false;
   if (message->type == MIDI_NONE || !MidiIsValidMessageType(message->type))
     return false;
@@ -271,7 +549,8 @@ bool_t MidiCallOnMessageCallback(
   bool_t sub_result = false;
   switch  (message->type) {
     case MIDI_SYSTEM_EXCLUSIVE: {
-      sub_result = MidiCallSysExMessageCallback(callbacks, time, message);
+      sub_result = MidiCallSysExMessageCallback(
+          callbacks, time, timestamp, message);
       if (sub_result) {
         MidiIncrementEventCounter(&callbacks->rx.next_sys_ex_rx_event_id);
       }
@@ -280,7 +559,16 @@ bool_t MidiCallOnMessageCallback(
       /* System reset MUST be handled by MidiCallOnSystemResetCallback(). */
       return false;
     default: {
-      sub_result = MidiCallMessageCallback(callbacks, time, message);
+      if (callbacks->event_queue != NULL &&
+          MidiEventQueueCapture(
+              callbacks->event_queue, callbacks->next_event_id,
+              callbacks->rx.next_rx_event_id, time, timestamp, message)) {
+        sub_result = true;
+        break;
+      }
+      sub_result = MidiCallMessageCallback(
+          callbacks, callbacks->next_event_id,
+          callbacks->rx.next_rx_event_id, time, timestamp, message);
     }
   }
 
@@ -291,6 +579,130 @@ bool_t MidiCallOnMessageCallback(
   return sub_result;
 }
 
+bool_t MidiCallOnQueuedMessageCallback(
+    midi_callbacks_t *callbacks, uint32_t event_id, uint32_t rx_event_id,
+    midi_time_t const *time, midi_timestamp_t timestamp,
+    midi_message_t const *message) {
+  if (callbacks == NULL || message == NULL) return false;
+  if (message->type == MIDI_NONE || !MidiIsValidMessageType(message->type))
+    return false;
+  if (message->type == MIDI_SYSTEM_EXCLUSIVE ||
+      message->type == MIDI_SYSTEM_RESET) {
+    return false;
+  }
+  return MidiCallMessageCallback(
+      callbacks, event_id, rx_event_id, time, timestamp, message);
+}
+
+bool_t MidiCallOnCompactMessageCallback(
+    midi_callbacks_t *callbacks, midi_time_t const *time,
+    midi_compact_message_t const *compact) {
+  if (callbacks == NULL || compact == NULL) return false;
+  midi_rx_callbacks_t *rx = &callbacks->rx;
+  midi_compact_message_callback_t on_compact_message = rx->OnCompactMessage;
+  void *compact_message_ctx = rx->compact_message_ctx;
+  if (compact->status < MIDI_SYSTEM_EXCLUSIVE &&
+      rx->channel_callbacks[compact->status & 0x0F] != NULL) {
+    midi_channel_callbacks_t const *channel =
+        rx->channel_callbacks[compact->status & 0x0F];
+    on_compact_message = channel->OnCompactMessage;
+    compact_message_ctx = channel->compact_message_ctx;
+  }
+  if (on_compact_message != NULL) {
+    midi_rx_event_t const rx_event = {
+      .general = {
+        .event_id = callbacks->next_event_id,
+        .time = time
+      },
+      .rx_event_id = rx->next_rx_event_id,
+      .message = NULL,
+      .user_ctx = compact_message_ctx
+    };
+    on_compact_message(&rx_event, compact);
+  }
+  MidiIncrementEventCounter(&callbacks->next_event_id);
+  MidiIncrementEventCounter(&rx->next_rx_event_id);
+  return true;
+}
+
+bool_t MidiCallOnSysExDataCallback(
+    midi_callbacks_t *callbacks, midi_time_t const *time,
+    uint8_t const *data, size_t data_size) {
+  if (callbacks == NULL) return false;
+  if (data == NULL && data_size > 0) return false;
+  midi_rx_callbacks_t *rx = &callbacks->rx;
+  if (rx->OnSysExData != NULL) {
+    midi_rx_event_t const rx_event = {
+      .general = {
+        .event_id = callbacks->next_event_id,
+        .time = time
+      },
+      .rx_event_id = rx->next_rx_event_id,
+      .message = NULL,
+      .user_ctx = rx->sys_ex_data_ctx
+    };
+    rx->OnSysExData(&rx_event, data, data_size);
+  }
+  MidiIncrementEventCounter(&callbacks->next_event_id);
+  MidiIncrementEventCounter(&rx->next_rx_event_id);
+  MidiIncrementEventCounter(&rx->next_sys_ex_rx_event_id);
+  return true;
+}
+
+static void MidiInitializeSysExStreamEvent(
+    midi_callbacks_t const *callbacks, midi_time_t const *time,
+    midi_rx_event_t *rx_event) {
+  rx_event->general.event_id = callbacks->next_event_id;
+  rx_event->general.time = time;
+  rx_event->rx_event_id = callbacks->rx.next_rx_event_id;
+  rx_event->message = NULL;
+  rx_event->user_ctx = callbacks->rx.sys_ex_stream_ctx;
+}
+
+bool_t MidiCallOnSysExStartCallback(
+    midi_callbacks_t *callbacks, midi_time_t const *time) {
+  if (callbacks == NULL) return false;
+  midi_rx_callbacks_t *rx = &callbacks->rx;
+  if (rx->OnSysExStart != NULL) {
+    midi_rx_event_t rx_event;
+    MidiInitializeSysExStreamEvent(callbacks, time, &rx_event);
+    rx->OnSysExStart(&rx_event);
+  }
+  MidiIncrementEventCounter(&callbacks->next_event_id);
+  MidiIncrementEventCounter(&rx->next_rx_event_id);
+  return true;
+}
+
+bool_t MidiCallOnSysExChunkCallback(
+    midi_callbacks_t *callbacks, midi_time_t const *time,
+    uint8_t const *data, size_t data_size) {
+  if (callbacks == NULL || data == NULL || data_size == 0) return false;
+  midi_rx_callbacks_t *rx = &callbacks->rx;
+  if (rx->OnSysExChunk != NULL) {
+    midi_rx_event_t rx_event;
+    MidiInitializeSysExStreamEvent(callbacks, time, &rx_event);
+    rx->OnSysExChunk(&rx_event, data, data_size);
+  }
+  MidiIncrementEventCounter(&callbacks->next_event_id);
+  MidiIncrementEventCounter(&rx->next_rx_event_id);
+  return true;
+}
+
+bool_t MidiCallOnSysExEndCallback(
+    midi_callbacks_t *callbacks, midi_time_t const *time, bool_t complete) {
+  if (callbacks == NULL) return false;
+  midi_rx_callbacks_t *rx = &callbacks->rx;
+  if (rx->OnSysExEnd != NULL) {
+    midi_rx_event_t rx_event;
+    MidiInitializeSysExStreamEvent(callbacks, time, &rx_event);
+    rx->OnSysExEnd(&rx_event, complete);
+  }
+  MidiIncrementEventCounter(&callbacks->next_event_id);
+  MidiIncrementEventCounter(&rx->next_rx_event_id);
+  MidiIncrementEventCounter(&rx->next_sys_ex_rx_event_id);
+  return true;
+}
+
 bool_t MidiCallOnTimeSynchronizeCallback(
     midi_callbacks_t *callbacks, midi_time_t const *time,
     midi_time_direction_t direction) {
@@ -342,3 +754,43 @@ bool_t MidiCallOnSystemResetCallback(
   MidiIncrementEventCounter(&rx->next_rx_event_id);
   return true;
 }
+
+static bool_t MidiCallWriterCallback(
+    midi_callbacks_t *callbacks, midi_data_writer_t writer,
+    midi_time_t const *time, midi_message_t const *message,
+    uint8_t const *data, size_t data_size) {
+  midi_tx_callbacks_t *tx = &callbacks->tx;
+  midi_tx_event_t const tx_event = {
+    .general = {
+      .event_id = callbacks->next_event_id,
+      .time = time
+    },
+    .tx_event_id = tx->next_tx_event_id,
+    .message = message,
+    .user_ctx = tx->data_writer_ctx
+  };
+  writer(&tx_event, data, data_size);
+  MidiIncrementEventCounter(&callbacks->next_event_id);
+  MidiIncrementEventCounter(&tx->next_tx_event_id);
+  return true;
+}
+
+bool_t MidiCallOnWriteDataCallback(
+    midi_callbacks_t *callbacks, midi_time_t const *time,
+    midi_message_t const *message, uint8_t const *data, size_t data_size) {
+  if (callbacks == NULL || data == NULL || data_size == 0) return false;
+  if (callbacks->tx.WriteData == NULL) return false;
+  return MidiCallWriterCallback(
+      callbacks, callbacks->tx.WriteData, time, message, data, data_size);
+}
+
+bool_t MidiCallOnWriteRealtimeCallback(
+    midi_callbacks_t *callbacks, midi_time_t const *time,
+    midi_message_t const *message, uint8_t const *data, size_t data_size) {
+  if (callbacks == NULL || data == NULL || data_size == 0) return false;
+  midi_data_writer_t const writer = (callbacks->tx.WriteRealtime != NULL)
+      ? callbacks->tx.WriteRealtime : callbacks->tx.WriteData;
+  if (writer == NULL) return false;
+  return MidiCallWriterCallback(
+      callbacks, writer, time, message, data, data_size);
+}
@@ -10,6 +10,7 @@
 
 #include "base.h"
 
+#include "midi_compact.h"
 #include "midi_message.h"
 #include "midi_time.h"
 
@@ -57,17 +58,30 @@ typedef void (*midi_data_writer_t) (
 typedef struct {
   uint32_t next_tx_event_id;
   midi_data_writer_t WriteData;
+  /* Optional.  Used for system realtime bytes, which should be written
+   * ahead of any data still pending from WriteData() (for example,
+   * SystemSerialWriteRealtime()).  WriteData() is used if not set. */
+  midi_data_writer_t WriteRealtime;
   void *data_writer_ctx;
 } midi_tx_callbacks_t;
 
 /* MIDI Receiver Events
  *  Not all messages have callbacks, some will be combined. */
 
+/* Receive timestamp, in the units of the system timestamp (see
+ * SystemTimestamp()).  Wraps around, and is only meaningful relative
+ * to the timestamps of nearby events. */
+typedef uint16_t midi_timestamp_t;
+
 /* Generic information about a receiver event. */
 typedef struct {
   midi_event_t general;
   /* A counter for the current receiver event. */
   uint32_t rx_event_id;
+  /* Time at which the first byte of the message was received.  Zero
+   * unless the message was received with timestamps, see
+   * MidiReceiveTimestampedData(). */
+  midi_timestamp_t timestamp;
   /* The message struct that was received (if applicable).
    * Each receiver event callback will have the important parameters
    * passed in separately. */
@@ -81,6 +95,12 @@ typedef struct {
  * callbacks. */
 typedef void (*midi_message_callback_t) (midi_rx_event_t const *);
 
+/* Called by the compact receiver upon receiving any non-SysEx message.
+ * The event |message| is NULL, the message is only provided in its
+ * compact form. */
+typedef void (*midi_compact_message_callback_t) (
+  midi_rx_event_t const *, midi_compact_message_t const *);
+
 /* Channel-based callbacks. */
 
 /* Called when a note on message is received. */
@@ -190,12 +210,93 @@ typedef void (*midi_eof_callback_t) (midi_sys_ex_rx_event_t const *);
  * system exclusive callbacks. */
 typedef void (*midi_sys_ex_message_callback_t) (midi_sys_ex_rx_event_t const *);
 
+/* Called when a receiver in raw SysEx mode has received a complete
+ * System Exclusive message.  The data does not include the SysEx
+ * start and end bytes, and the message is not decoded.  The data is
+ * only valid for the duration of the callback, and may point into the
+ * data provided to the receiver. */
+typedef void (*midi_sys_ex_data_callback_t) (
+  midi_rx_event_t const *, uint8_t const *, size_t);
+
+/* Called by a receiver in stream SysEx mode, allowing SysEx messages
+ * of any size to be processed as they are received.
+ *  - Start is called upon receiving the SysEx start byte.
+ *  - Chunk is called with the SysEx data bytes received so far, (not
+ *    including the SysEx start and end bytes).  The chunk data is only
+ *    valid for the duration of the callback.
+ *  - End is called once the SysEx end byte is received (true), or if
+ *    the SysEx was interrupted by another status byte (false). */
+typedef void (*midi_sys_ex_start_callback_t) (midi_rx_event_t const *);
+typedef void (*midi_sys_ex_chunk_callback_t) (
+  midi_rx_event_t const *, uint8_t const *, size_t);
+typedef void (*midi_sys_ex_end_callback_t) (midi_rx_event_t const *, bool_t);
+
+/* Fast message handler.
+ *  A single handler may be set per message type using
+ *  MidiSetFastMessageHandler().  When set, it replaces all other
+ *  callbacks for that message type (including OnMessage()); no
+ *  midi_rx_event_t is created, and only the message and the context
+ *  provided at registration are passed.  Event counters are still
+ *  incremented.  Not used for System Exclusive or System Reset. */
+typedef void (*midi_fast_message_handler_t) (
+  void *, midi_message_t const *);
+
+typedef struct {
+  midi_fast_message_handler_t handler;
+  void *ctx;
+} midi_fast_handler_slot_t;
+
+/* Message subscribers.
+ *  Any number of callbacks may subscribe to a message type using
+ *  MidiAddSubscriber(), up to MIDI_SUBSCRIBER_POOL_SIZE in total for
+ *  all message types.  Subscribers are called after the message
+ *  specific callback, in the order they were added, each with its own
+ *  |user_ctx|.  Only message types supported by
+ *  MidiSetFastMessageHandler() may be subscribed to.  Per-channel
+ *  callback sets do not have subscribers. */
+#ifndef MIDI_SUBSCRIBER_POOL_SIZE
+#define MIDI_SUBSCRIBER_POOL_SIZE 8
+#endif
+
+typedef struct {
+  midi_message_callback_t callback;
+  void *ctx;
+} midi_subscriber_t;
+
+/* Per-channel receiver callback set.
+ *  Only holds the callbacks which apply to channel messages, to keep
+ *  sets small enough to have one for every channel on small targets.
+ *  The fields have the same meaning as in midi_rx_callbacks_t. */
+typedef struct {
+  midi_message_callback_t OnMessage;
+  void *message_ctx;
+  midi_compact_message_callback_t OnCompactMessage;
+  void *compact_message_ctx;
+  midi_note_on_callback_t OnNoteOn;
+  midi_note_off_callback_t OnNoteOff;
+  midi_key_pressure_callback_t OnKeyPressure;
+  void *note_ctx;
+  midi_control_change_callback_t OnControlChange;
+  void *control_change_ctx;
+  midi_program_change_callback_t OnProgramChange;
+  void *program_change_ctx;
+  midi_channel_pressure_change_callback_t OnChannelPressureChange;
+  void *channel_pressure_ctx;
+  midi_pitch_wheel_change_callback_t OnPitchWheelChange;
+  void *pitch_wheel_ctx;
+  /* Indexed by MidiMessageTypeIndex(). */
+  midi_fast_handler_slot_t fast_handlers[MIDI_CHANNEL_MESSAGE_TYPE_COUNT];
+} midi_channel_callbacks_t;
+
 /* Receiver event callback set. */
 typedef struct {
   uint32_t next_rx_event_id;
   /* Any message. */
   midi_message_callback_t OnMessage;
   void *message_ctx;
+  /* Any compact message. */
+  midi_compact_message_callback_t OnCompactMessage;
+  void *compact_message_ctx;
   /* Channel-based callbacks. */
   /* Note callback. */
   midi_note_on_callback_t OnNoteOn;
@@ -240,6 +341,14 @@ typedef struct {
   uint32_t next_sys_ex_rx_event_id;
   midi_sys_ex_message_callback_t OnSysExMessage;
   void *sys_ex_message_ctx;
+  /* Raw SysEx data. */
+  midi_sys_ex_data_callback_t OnSysExData;
+  void *sys_ex_data_ctx;
+  /* Streamed SysEx data. */
+  midi_sys_ex_start_callback_t OnSysExStart;
+  midi_sys_ex_chunk_callback_t OnSysExChunk;
+  midi_sys_ex_end_callback_t OnSysExEnd;
+  void *sys_ex_stream_ctx;
   /* Handshake callbacks. */
   midi_eof_callback_t OnEof;
   midi_wait_callback_t OnWait;
@@ -247,14 +356,83 @@ typedef struct {
   midi_nak_callback_t OnNak;
   midi_ack_callback_t OnAck;
   void *handshake_ctx;
+
+  /* Indexed by MidiMessageTypeIndex(). */
+  midi_fast_handler_slot_t fast_handlers[MIDI_MESSAGE_TYPE_COUNT];
+
+  /* Subscribers grouped by message type, in the order of
+   * MidiMessageTypeIndex().  The subscribers of type index i end at
+   * |subscriber_ends[i]| and start at the end of index i - 1. */
+  midi_subscriber_t subscribers[MIDI_SUBSCRIBER_POOL_SIZE];
+  uint8_t subscriber_ends[MIDI_MESSAGE_TYPE_COUNT];
+
+  /* Channel routing.  Channel messages on channels not in
+   * |channel_mask| are dropped by the receiver at the status byte;
+   * their data bytes are skipped without being buffered or decoded.
+   * If a channel has its own callback set, its callbacks, contexts
+   * and fast handlers are used for that channel's messages instead of
+   * the ones above (including subscribers).  Event counters are always
+   * taken from this set. */
+  midi_channel_mask_t channel_mask;
+  midi_channel_callbacks_t const *channel_callbacks[MIDI_CHANNEL_COUNT];
 } midi_rx_callbacks_t;
 
+/* See midi_event_queue.h. */
+struct midi_event_queue_s;
+
 typedef struct {
   uint32_t next_event_id;
   midi_rx_callbacks_t rx;
   midi_tx_callbacks_t tx;
+  /* Optional.  When set, received messages (other than SysEx and
+   * System Reset) are captured by the queue and their callbacks are
+   * called when the queue is drained. */
+  struct midi_event_queue_s *event_queue;
 } midi_callbacks_t;
 
+/* Sets (or clears, if |handler| is NULL) the fast handler for
+ * |message_type|.  The per-channel variant only accepts channel
+ * message types. */
+bool_t MidiSetFastMessageHandler(
+  midi_rx_callbacks_t *rx, midi_message_type_t message_type,
+  midi_fast_message_handler_t handler, void *ctx);
+bool_t MidiSetChannelFastMessageHandler(
+  midi_channel_callbacks_t *channel_callbacks,
+  midi_message_type_t message_type,
+  midi_fast_message_handler_t handler, void *ctx);
+
+/* Adds or removes a subscriber to |message_type|.  Adding fails if
+ * the pool is full or the same |callback| and |ctx| are already
+ * subscribed. */
+bool_t MidiAddSubscriber(
+  midi_rx_callbacks_t *rx, midi_message_type_t message_type,
+  midi_message_callback_t callback, void *ctx);
+bool_t MidiRemoveSubscriber(
+  midi_rx_callbacks_t *rx, midi_message_type_t message_type,
+  midi_message_callback_t callback, void *ctx);
+
+/* Sets the channels which are accepted by the receiver.  Defaults to
+ * MIDI_CHANNEL_MASK_ALL. */
+bool_t MidiSetChannelMask(
+  midi_callbacks_t *callbacks, midi_channel_mask_t channel_mask);
+
+/* Sets (or clears, if |channel_callbacks| is NULL) the callback set
+ * used for messages on |channel_number|.  |channel_callbacks| must
+ * remain valid while set, and be initialized with
+ * MidiInitializeChannelCallbacks(). */
+bool_t MidiSetChannelCallbacks(
+  midi_callbacks_t *callbacks, midi_channel_number_t channel_number,
+  midi_channel_callbacks_t const *channel_callbacks);
+
+bool_t MidiInitializeRxCallbacks(midi_rx_callbacks_t *rx);
+bool_t MidiInitializeChannelCallbacks(
+  midi_channel_callbacks_t *channel_callbacks);
+
+/* Sets (or clears, if |event_queue| is NULL) the deferred event queue.
+ * The queue must have been initialized with the same |callbacks|. */
+bool_t MidiSetEventQueue(
+  midi_callbacks_t *callbacks, struct midi_event_queue_s *event_queue);
+
 C_SECTION_END;
 
 #endif  /* _MIDI_CALLBACK_H_ */
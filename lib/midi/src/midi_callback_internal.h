@@ -21,9 +21,48 @@ bool_t MidiInitializeCallbacks(midi_callbacks_t *callbacks);
 
 bool_t MidiIsValidCallbacks(midi_callbacks_t const *callbacks);
 
+/* True if |status_byte| is a channel status byte (0x80 - 0xEF) for a
+ * channel not in the channel mask of |callbacks|.  |status_byte| must
+ * not be a data byte. */
+#define MidiIsMaskedChannelStatus(callbacks, status_byte) \
+  ((status_byte) < 0xF0 && \
+   !MidiChannelMaskHas((callbacks)->rx.channel_mask, (status_byte)))
+
 bool_t MidiCallOnMessageCallback(
   midi_callbacks_t *callbacks, midi_time_t const *time,
   midi_message_t const *message);
+/* Same as MidiCallOnMessageCallback(), with the receive |timestamp|
+ * of the message. */
+bool_t MidiCallOnTimestampedMessageCallback(
+  midi_callbacks_t *callbacks, midi_time_t const *time,
+  midi_timestamp_t timestamp, midi_message_t const *message);
+
+/* Dispatches a message captured by a midi_event_queue_t, using the
+ * event IDs assigned when it was captured.  Event counters are not
+ * changed. */
+bool_t MidiCallOnQueuedMessageCallback(
+  midi_callbacks_t *callbacks, uint32_t event_id, uint32_t rx_event_id,
+  midi_time_t const *time, midi_timestamp_t timestamp,
+  midi_message_t const *message);
+
+/* Compact messages, see midi_compact_message_callback_t. */
+bool_t MidiCallOnCompactMessageCallback(
+  midi_callbacks_t *callbacks, midi_time_t const *time,
+  midi_compact_message_t const *compact);
+
+/* Raw SysEx data, see midi_sys_ex_data_callback_t. */
+bool_t MidiCallOnSysExDataCallback(
+  midi_callbacks_t *callbacks, midi_time_t const *time,
+  uint8_t const *data, size_t data_size);
+
+/* Streamed SysEx data, see midi_sys_ex_start_callback_t. */
+bool_t MidiCallOnSysExStartCallback(
+  midi_callbacks_t *callbacks, midi_time_t const *time);
+bool_t MidiCallOnSysExChunkCallback(
+  midi_callbacks_t *callbacks, midi_time_t const *time,
+  uint8_t const *data, size_t data_size);
+bool_t MidiCallOnSysExEndCallback(
+  midi_callbacks_t *callbacks, midi_time_t const *time, bool_t complete);
 
 bool_t MidiCallOnTimeSynchronizeCallback(
   midi_callbacks_t *callbacks, midi_time_t const *time,
@@ -33,6 +72,19 @@ bool_t MidiCallOnSystemResetCallback(
   midi_callbacks_t *callbacks, midi_time_t const *time,
   midi_message_t const *message, bool_t *soft_reset);
 
+/* Passes |data| to the transmitter WriteData() callback.  |message|
+ * may be NULL if |data| contains more than one message.  Returns
+ * false if there is no WriteData() callback. */
+bool_t MidiCallOnWriteDataCallback(
+  midi_callbacks_t *callbacks, midi_time_t const *time,
+  midi_message_t const *message, uint8_t const *data, size_t data_size);
+
+/* Same as MidiCallOnWriteDataCallback(), but uses the WriteRealtime()
+ * callback if available. */
+bool_t MidiCallOnWriteRealtimeCallback(
+  midi_callbacks_t *callbacks, midi_time_t const *time,
+  midi_message_t const *message, uint8_t const *data, size_t data_size);
+
 C_SECTION_END;
 
 #endif  /* _MIDI_CALLBACK_INTERNAL_H_ */
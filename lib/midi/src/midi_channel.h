@@ -19,6 +19,18 @@ typedef uint8_t midi_channel_number_t;
 #define MidiIsValidChannelNumber(channel_number) \
     (((channel_number) & 0xF) == (channel_number))
 
+#define MIDI_CHANNEL_COUNT 16
+
+/* Set of MIDI channels, bit N is set for channel number N. */
+typedef uint16_t midi_channel_mask_t;
+
+#define MIDI_CHANNEL_MASK_NONE  ((midi_channel_mask_t) 0x0000)
+#define MIDI_CHANNEL_MASK_ALL   ((midi_channel_mask_t) 0xFFFF)
+#define MidiChannelMaskBit(channel_number) \
+    ((midi_channel_mask_t) (1u << ((channel_number) & 0xF)))
+#define MidiChannelMaskHas(mask, channel_number) \
+    (((mask) & MidiChannelMaskBit(channel_number)) != 0)
+
 /* MIDI channel properties. */
 typedef struct {
   /* TODO: Implement channel properties. */
@@ -0,0 +1,302 @@
+/*
+ * MIDI Controller - MIDI Clock Recovery
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <string.h>
+
+#include "midi_clock_recovery.h"
+
+/* Times and periods of the loop are fixed point, with 8 fractional
+ * bits. */
+#define MIDI_CLOCK_PLL_FRACTION_BITS 8
+#define MIDI_CLOCK_PLL_ONE (1ul << MIDI_CLOCK_PLL_FRACTION_BITS)
+#define MidiClockPllFixed(ticks) \
+    (((system_ticks_t) (ticks)) << MIDI_CLOCK_PLL_FRACTION_BITS)
+#define MidiClockPllTicks(fixed) ((fixed) >> MIDI_CLOCK_PLL_FRACTION_BITS)
+/* Longest period the loop can track, in ticks. */
+#define MIDI_CLOCK_PLL_MAX_PERIOD (UINT32_MAX >> MIDI_CLOCK_PLL_FRACTION_BITS)
+/* Metrics are averaged over ~16 events. */
+#define MIDI_CLOCK_PLL_METRIC_DIVISOR 16
+
+#define MIDI_CLOCKS_PER_BEAT 24
+#define MIDI_QUARTER_FRAMES_PER_FRAME 4
+/* The last quarter frame of a sequence is received 7 quarter frames
+ * after the time it encodes. */
+#define MIDI_QUARTER_FRAME_SEQUENCE_OFFSET \
+    (7 * MIDI_CLOCK_PLL_ONE / MIDI_QUARTER_FRAMES_PER_FRAME)
+
+/*
+ *  MIDI Clock Phase-Locked Loop.
+ */
+static void MidiInitializeClockPll(midi_clock_pll_t *pll) {
+  memset(pll, 0, sizeof(midi_clock_pll_t));
+}
+
+/* Restarts the loop from the event at |time|, keeping the period. */
+static void MidiClockPllRestart(midi_clock_pll_t *pll, system_ticks_t time) {
+  pll->phase = MidiClockPllFixed(time);
+  pll->lock_count = 0;
+  pll->locked = false;
+}
+
+static bool_t MidiClockPllIsTimedOut(
+    midi_clock_pll_t const *pll, system_ticks_t now) {
+  if (pll->events == 0 || pll->period == 0) return false;
+  if (SystemTicksLessThan(now, pll->last_event)) return false;
+  system_ticks_t const elapsed = SystemTicksDelta(pll->last_event, now);
+  return MidiClockPllFixed(elapsed)
+      > ((uint64_t) pll->period * MIDI_CLOCK_PLL_TIMEOUT_PERIODS);
+}
+
+static void MidiClockPllUpdateMetrics(midi_clock_pll_t *pll, int32_t error) {
+  uint32_t const abs_error = (error < 0) ? -error : error;
+  pll->drift += (error - pll->drift) / MIDI_CLOCK_PLL_METRIC_DIVISOR;
+  pll->jitter = (uint32_t) ((int32_t) pll->jitter
+      + ((int32_t) abs_error - (int32_t) pll->jitter)
+        / MIDI_CLOCK_PLL_METRIC_DIVISOR);
+  if (abs_error > pll->max_error) pll->max_error = abs_error;
+  if (abs_error <= pll->period / 16) {
+    if (pll->lock_count < MIDI_CLOCK_PLL_LOCK_COUNT) ++pll->lock_count;
+    if (pll->lock_count == MIDI_CLOCK_PLL_LOCK_COUNT) pll->locked = true;
+  } else if (abs_error > pll->period / 8) {
+    pll->lock_count = 0;
+    pll->locked = false;
+  }
+}
+
+static void MidiClockPllUpdate(midi_clock_pll_t *pll, system_ticks_t time) {
+  bool_t const first = (pll->events == 0);
+  system_ticks_t const last_event = pll->last_event;
+  bool_t const timed_out = MidiClockPllIsTimedOut(pll, time);
+  ++pll->events;
+  pll->last_event = time;
+  /* Events out of order are not tracked. */
+  if (first || timed_out || SystemTicksLessThanOrEqual(time, last_event)) {
+    MidiClockPllRestart(pll, time);
+    return;
+  }
+  system_ticks_t const interval = SystemTicksDelta(last_event, time);
+  if (pll->period == 0) {
+    /* Second event, the period is measured. */
+    if (interval <= MIDI_CLOCK_PLL_MAX_PERIOD) {
+      pll->period = (uint32_t) MidiClockPllFixed(interval);
+    }
+    MidiClockPllRestart(pll, time);
+    return;
+  }
+  system_ticks_t const predicted = pll->phase + pll->period;
+  system_ticks_t const event = MidiClockPllFixed(time);
+  /* Events within half a period of the prediction are filtered, others
+   * restart the loop from the measured interval. */
+  system_ticks_t const half_period = pll->period / 2;
+  if (event + half_period < predicted || predicted + half_period < event) {
+    if (interval <= MIDI_CLOCK_PLL_MAX_PERIOD) {
+      pll->period = (uint32_t) MidiClockPllFixed(interval);
+    }
+    MidiClockPllRestart(pll, time);
+    return;
+  }
+  int32_t const error = (int32_t) (int64_t) (event - predicted);
+  pll->phase = (system_ticks_t)
+      ((int64_t) predicted + error / (1l << MIDI_CLOCK_PLL_PHASE_SHIFT));
+  int32_t const correction = error / (1l << MIDI_CLOCK_PLL_PERIOD_SHIFT);
+  if (correction > 0 || (uint32_t) -correction < pll->period) {
+    pll->period += correction;
+  }
+  MidiClockPllUpdateMetrics(pll, error);
+}
+
+/* Position of the loop at |now|, in 1/256 events since the first
+ * event. */
+static uint32_t MidiClockPllPosition(
+    midi_clock_pll_t const *pll, system_ticks_t now) {
+  if (pll->events == 0) return 0;
+  uint32_t const position = (pll->events - 1) * MIDI_CLOCK_PLL_ONE;
+  system_ticks_t const current = MidiClockPllFixed(now);
+  if (pll->period == 0 || current <= pll->phase) return position;
+  system_ticks_t const elapsed = current - pll->phase;
+  if (elapsed >= pll->period) return position + MIDI_CLOCK_PLL_ONE;
+  return position
+      + (uint32_t) ((elapsed * MIDI_CLOCK_PLL_ONE) / pll->period);
+}
+
+static bool_t MidiClockPllIsLocked(
+    midi_clock_pll_t const *pll, system_ticks_t now) {
+  return pll->locked && !MidiClockPllIsTimedOut(pll, now);
+}
+
+/*
+ *  MIDI Clock Recovery.
+ */
+bool_t MidiInitializeClockRecovery(midi_clock_recovery_t *recovery) {
+  if (recovery == NULL) return false;
+  memset(recovery, 0, sizeof(midi_clock_recovery_t));
+  MidiInitializeClockPll(&recovery->clock);
+  MidiInitializeClockPll(&recovery->quarter_frame);
+  MidiInitializeTimeTracker(&recovery->tracker);
+  recovery->direction = MIDI_TIME_UNKNOWN;
+  return true;
+}
+
+bool_t MidiClockRecoveryTimingClock(
+    midi_clock_recovery_t *recovery, system_ticks_t time) {
+  if (recovery == NULL) return false;
+  MidiClockPllUpdate(&recovery->clock, time);
+  return true;
+}
+
+bool_t MidiClockRecoveryLocate(
+    midi_clock_recovery_t *recovery, uint32_t clocks) {
+  if (recovery == NULL) return false;
+  if (clocks > UINT32_MAX / MIDI_CLOCK_PLL_ONE) return false;
+  recovery->clock_base = clocks;
+  /* The next clock restarts the loop as the first event. */
+  recovery->clock.events = 0;
+  return true;
+}
+
+static uint32_t MidiClockRecoveryWrapFrames(
+    midi_clock_recovery_t const *recovery, int64_t frames) {
+  int64_t const per_day =
+      (int64_t) MidiFrameCountPerDay(recovery->fps) * MIDI_CLOCK_PLL_ONE;
+  frames %= per_day;
+  if (frames < 0) frames += per_day;
+  return (uint32_t) frames;
+}
+
+static void MidiClockRecoveryUpdateTime(
+    midi_clock_recovery_t *recovery, midi_time_t const *time,
+    midi_time_direction_t direction) {
+  midi_frame_count_t frames;
+  if (direction == MIDI_TIME_UNKNOWN ||
+      !MidiTimeToFrameCount(time, &frames)) {
+    recovery->has_time = false;
+    recovery->direction = MIDI_TIME_UNKNOWN;
+    return;
+  }
+  recovery->fps = time->fps;
+  recovery->direction = direction;
+  int64_t const offset = (direction == MIDI_TIME_FORWARD)
+      ? MIDI_QUARTER_FRAME_SEQUENCE_OFFSET
+      : -MIDI_QUARTER_FRAME_SEQUENCE_OFFSET;
+  recovery->time_frames = MidiClockRecoveryWrapFrames(
+      recovery, (int64_t) frames * MIDI_CLOCK_PLL_ONE + offset);
+  recovery->time_event = recovery->quarter_frame.events - 1;
+  recovery->has_time = true;
+}
+
+bool_t MidiClockRecoveryQuarterFrame(
+    midi_clock_recovery_t *recovery, midi_time_code_t const *time_code,
+    system_ticks_t time) {
+  if (recovery == NULL || !MidiIsValidTimeCode(time_code)) return false;
+  MidiClockPllUpdate(&recovery->quarter_frame, time);
+  bool_t updated = false;
+  midi_time_t tracked_time;
+  midi_time_direction_t direction = MIDI_TIME_UNKNOWN;
+  if (!MidiUpdateTimeTracker(
+        &recovery->tracker, time_code, &updated, &tracked_time,
+        &direction)) {
+    return false;
+  }
+  if (updated) {
+    MidiClockRecoveryUpdateTime(recovery, &tracked_time, direction);
+  }
+  return true;
+}
+
+static midi_clock_pll_t const *MidiClockRecoverySource(
+    midi_clock_recovery_t const *recovery,
+    midi_clock_recovery_source_t source) {
+  switch (source) {
+    case MIDI_CLOCK_RECOVERY_CLOCK:
+      return &recovery->clock;
+    case MIDI_CLOCK_RECOVERY_QUARTER_FRAME:
+      return &recovery->quarter_frame;
+  }
+  return NULL;
+}
+
+bool_t MidiIsClockRecoveryLocked(
+    midi_clock_recovery_t const *recovery,
+    midi_clock_recovery_source_t source, system_ticks_t now) {
+  if (recovery == NULL) return false;
+  midi_clock_pll_t const *pll = MidiClockRecoverySource(recovery, source);
+  if (pll == NULL) return false;
+  return MidiClockPllIsLocked(pll, now);
+}
+
+bool_t MidiGetClockRecoveryTempo(
+    midi_clock_recovery_t const *recovery, uint32_t *milli_bpm) {
+  if (recovery == NULL || milli_bpm == NULL) return false;
+  if (recovery->clock.period == 0) return false;
+  /* 60 s per minute, 1000 milli-BPM per BPM, per beat of clocks. */
+  *milli_bpm = (uint32_t)
+      ((MidiClockPllFixed(SYSTEM_TICKS_PER_SECOND) * 60 * 1000)
+       / ((uint64_t) recovery->clock.period * MIDI_CLOCKS_PER_BEAT));
+  return true;
+}
+
+bool_t MidiGetClockRecoveryPosition(
+    midi_clock_recovery_t const *recovery, system_ticks_t now,
+    uint32_t *position) {
+  if (recovery == NULL || position == NULL) return false;
+  *position = recovery->clock_base * MIDI_CLOCK_PLL_ONE
+      + MidiClockPllPosition(&recovery->clock, now);
+  return true;
+}
+
+bool_t MidiGetClockRecoveryPositionTime(
+    midi_clock_recovery_t const *recovery, uint32_t position,
+    system_ticks_t *time) {
+  if (recovery == NULL || time == NULL) return false;
+  midi_clock_pll_t const *pll = &recovery->clock;
+  if (pll->events == 0 || pll->period == 0) return false;
+  int64_t const last = (int64_t) recovery->clock_base * MIDI_CLOCK_PLL_ONE
+      + (int64_t) (pll->events - 1) * MIDI_CLOCK_PLL_ONE;
+  int64_t const offset =
+      (((int64_t) position - last) * pll->period) / MIDI_CLOCK_PLL_ONE;
+  if (offset < 0 && (system_ticks_t) -offset > pll->phase) return false;
+  *time = MidiClockPllTicks(
+      (system_ticks_t) ((int64_t) pll->phase + offset));
+  return true;
+}
+
+bool_t MidiGetClockRecoveryFrames(
+    midi_clock_recovery_t const *recovery, system_ticks_t now,
+    midi_frame_count_t *frames, uint8_t *fraction) {
+  if (recovery == NULL || frames == NULL || fraction == NULL) return false;
+  if (!recovery->has_time) return false;
+  int64_t const elapsed =
+      (int64_t) MidiClockPllPosition(&recovery->quarter_frame, now)
+      - (int64_t) recovery->time_event * MIDI_CLOCK_PLL_ONE;
+  int64_t const moved = elapsed / MIDI_QUARTER_FRAMES_PER_FRAME;
+  uint32_t const position = MidiClockRecoveryWrapFrames(
+      recovery, (int64_t) recovery->time_frames
+          + ((recovery->direction == MIDI_TIME_FORWARD) ? moved : -moved));
+  *frames = position / MIDI_CLOCK_PLL_ONE;
+  *fraction = position % MIDI_CLOCK_PLL_ONE;
+  return true;
+}
+
+bool_t MidiGetClockRecoveryStats(
+    midi_clock_recovery_t const *recovery,
+    midi_clock_recovery_source_t source, system_ticks_t now,
+    midi_clock_pll_stats_t *stats) {
+  if (recovery == NULL || stats == NULL) return false;
+  midi_clock_pll_t const *pll = MidiClockRecoverySource(recovery, source);
+  if (pll == NULL) return false;
+  stats->locked = MidiClockPllIsLocked(pll, now);
+  stats->events = pll->events;
+  stats->period_ns = (uint32_t)
+      (((uint64_t) pll->period * SYSTEM_TICK_NS) / MIDI_CLOCK_PLL_ONE);
+  stats->drift_us = (pll->drift / (int32_t) MIDI_CLOCK_PLL_ONE)
+      / (int32_t) SYSTEM_TICKS_PER_MICROSECOND;
+  stats->jitter_us = SystemTicksToMicroseconds(
+      MidiClockPllTicks(pll->jitter));
+  stats->max_error_us = SystemTicksToMicroseconds(
+      MidiClockPllTicks(pll->max_error));
+  return true;
+}
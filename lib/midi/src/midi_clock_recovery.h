@@ -0,0 +1,157 @@
+/*
+ * MIDI Controller - MIDI Clock Recovery
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MIDI_CLOCK_RECOVERY_H_
+#define _MIDI_CLOCK_RECOVERY_H_
+
+#include "base.h"
+#include "system_time.h"
+
+#include "midi_time.h"
+#include "midi_time_tracker.h"
+
+C_SECTION_BEGIN;
+
+/* Loop gains, as right shifts of the phase error.  The phase gain
+ * corrects the time of each event, the period gain corrects the
+ * period.  The defaults give a slightly underdamped loop (poles at
+ * |z| ~ 0.87) which overshoots briefly and settles to within 1% in
+ * ~30 events. */
+#ifndef MIDI_CLOCK_PLL_PHASE_SHIFT
+#define MIDI_CLOCK_PLL_PHASE_SHIFT 2
+#endif
+#ifndef MIDI_CLOCK_PLL_PERIOD_SHIFT
+#define MIDI_CLOCK_PLL_PERIOD_SHIFT 5
+#endif
+
+/* Number of consecutive events within 1/16 period of the prediction
+ * before the loop is locked.  The loop unlocks when an event is more
+ * than 1/8 period off, or no event is received for
+ * MIDI_CLOCK_PLL_TIMEOUT_PERIODS. */
+#ifndef MIDI_CLOCK_PLL_LOCK_COUNT
+#define MIDI_CLOCK_PLL_LOCK_COUNT 8
+#endif
+#ifndef MIDI_CLOCK_PLL_TIMEOUT_PERIODS
+#define MIDI_CLOCK_PLL_TIMEOUT_PERIODS 4
+#endif
+
+/*
+ *  MIDI Clock Phase-Locked Loop.
+ *    Tracks a stream of evenly spaced events (timing clocks or quarter
+ *    frames) from their receive times.  Times and periods are kept in
+ *    1/256 system ticks; no floating point is used.  An event more than
+ *    half a period from its prediction restarts the loop from the
+ *    measured interval (for example, after a tempo jump).
+ */
+typedef struct {
+  /* Filtered time of the last event and period, in 1/256 ticks. */
+  system_ticks_t phase;
+  uint32_t period;
+  /* Receive time of the last event, in ticks. */
+  system_ticks_t last_event;
+  /* Events since the loop was reset. */
+  uint32_t events;
+  /* Phase error metrics, in 1/256 ticks.  |drift| is the average
+   * signed error, |jitter| the average absolute error. */
+  int32_t drift;
+  uint32_t jitter;
+  uint32_t max_error;
+  uint8_t lock_count;
+  bool_t locked;
+} midi_clock_pll_t;
+
+typedef struct {
+  bool_t locked;
+  uint32_t events;
+  /* Filtered period, in ns. */
+  uint32_t period_ns;
+  /* Phase error metrics, in us. */
+  int32_t drift_us;
+  uint32_t jitter_us;
+  uint32_t max_error_us;
+} midi_clock_pll_stats_t;
+
+/*
+ *  MIDI Clock Recovery.
+ *    Recovers the tempo and position of incoming timing clock (0xF8)
+ *    messages, and the time of incoming quarter frame time codes, from
+ *    their receive times.  Receive times are system ticks; either the
+ *    receive timestamps of the messages converted to ticks, or
+ *    SystemTicksNow() if called from the receive path.
+ *
+ *    Positions are interpolated between events using the filtered
+ *    period, so downstream timers can fire between clock pulses.
+ */
+#define MIDI_CLOCK_RECOVERY_CLOCK         0
+#define MIDI_CLOCK_RECOVERY_QUARTER_FRAME 1
+typedef uint8_t midi_clock_recovery_source_t;
+
+typedef struct {
+  midi_clock_pll_t clock;
+  midi_clock_pll_t quarter_frame;
+  /* Timing clock position of the first clock after a locate, in
+   * clocks. */
+  uint32_t clock_base;
+  /* Time code of the last complete quarter frame sequence. */
+  midi_time_tracker_t tracker;
+  bool_t has_time;
+  uint8_t fps;
+  midi_time_direction_t direction;
+  /* Frame count (in 1/256 frames) at quarter frame event |time_event|. */
+  uint32_t time_frames;
+  uint32_t time_event;
+} midi_clock_recovery_t;
+
+bool_t MidiInitializeClockRecovery(midi_clock_recovery_t *recovery);
+
+/* Called for each timing clock received at |time|. */
+bool_t MidiClockRecoveryTimingClock(
+  midi_clock_recovery_t *recovery, system_ticks_t time);
+/* Sets the position of the next timing clock, in clocks (6 per song
+ * position unit).  Use 0 on Start.  The tempo is kept. */
+bool_t MidiClockRecoveryLocate(
+  midi_clock_recovery_t *recovery, uint32_t clocks);
+
+/* Called for each quarter frame received at |time|. */
+bool_t MidiClockRecoveryQuarterFrame(
+  midi_clock_recovery_t *recovery, midi_time_code_t const *time_code,
+  system_ticks_t time);
+
+bool_t MidiIsClockRecoveryLocked(
+  midi_clock_recovery_t const *recovery,
+  midi_clock_recovery_source_t source, system_ticks_t now);
+
+/* Tempo, in 1/1000 BPM (24 clocks per beat).  Fails until the timing
+ * clock loop has measured a period. */
+bool_t MidiGetClockRecoveryTempo(
+  midi_clock_recovery_t const *recovery, uint32_t *milli_bpm);
+
+/* Timing clock position at |now|, in 1/256 clocks.  Interpolation stops
+ * at the next expected clock. */
+bool_t MidiGetClockRecoveryPosition(
+  midi_clock_recovery_t const *recovery, system_ticks_t now,
+  uint32_t *position);
+/* Predicts the time at which the timing clock reaches |position| (in
+ * 1/256 clocks). */
+bool_t MidiGetClockRecoveryPositionTime(
+  midi_clock_recovery_t const *recovery, uint32_t position,
+  system_ticks_t *time);
+
+/* Time code position at |now|, as a frame count and 1/256 frames.  Fails
+ * until a complete quarter frame sequence has been received. */
+bool_t MidiGetClockRecoveryFrames(
+  midi_clock_recovery_t const *recovery, system_ticks_t now,
+  midi_frame_count_t *frames, uint8_t *fraction);
+
+bool_t MidiGetClockRecoveryStats(
+  midi_clock_recovery_t const *recovery,
+  midi_clock_recovery_source_t source, system_ticks_t now,
+  midi_clock_pll_stats_t *stats);
+
+C_SECTION_END;
+
+#endif  /* _MIDI_CLOCK_RECOVERY_H_ */
@@ -0,0 +1,133 @@
+/*
+ * MIDI Controller - MIDI Compact Message
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <string.h>
+
+#include "midi_compact.h"
+#include "midi_defs.h"
+#include "midi_serialize.h"
+
+/* Status byte, plus two data bytes. */
+#define MIDI_COMPACT_MAX_SIZE 3
+
+/* Data-less messages are valid. */
+#define MidiIsCompactData(data, data_size) \
+  ((data_size) == 0 || MidiIsDataArray(data, data_size))
+
+bool_t MidiIsValidCompactMessage(midi_compact_message_t const *compact) {
+  if (compact == NULL) return false;
+  midi_status_info_t info;
+  MidiGetStatusInfo(compact->status, &info);
+  if (!MidiStatusInfoIsDefined(&info)) return false;
+  if (MidiStatusInfoIsVariableSize(&info)) return false;
+  if (compact->data_size != MidiStatusInfoDataSize(&info)) return false;
+  return MidiIsCompactData(compact->data, compact->data_size);
+}
+
+bool_t MidiCompactMessage(
+    midi_compact_message_t *compact, midi_status_t status,
+    uint8_t data_0, uint8_t data_1) {
+  if (compact == NULL) return false;
+  midi_status_info_t info;
+  MidiGetStatusInfo(status, &info);
+  if (!MidiStatusInfoIsDefined(&info)) return false;
+  if (MidiStatusInfoIsVariableSize(&info)) return false;
+  midi_compact_message_t const result = {
+    .status = status,
+    .data = { data_0, data_1 },
+    .data_size = (uint8_t) MidiStatusInfoDataSize(&info)
+  };
+  if (!MidiIsCompactData(result.data, result.data_size)) return false;
+  *compact = result;
+  /* Unused data bytes are always zero. */
+  if (compact->data_size < 2) compact->data[1] = 0;
+  if (compact->data_size < 1) compact->data[0] = 0;
+  return true;
+}
+
+midi_message_type_t MidiCompactMessageType(
+    midi_compact_message_t const *compact) {
+  if (compact == NULL) return MIDI_NONE;
+  midi_status_info_t info;
+  MidiGetStatusInfo(compact->status, &info);
+  return info.type;
+}
+
+midi_channel_number_t MidiCompactMessageChannel(
+    midi_compact_message_t const *compact) {
+  if (compact == NULL) return 0;
+  midi_status_info_t info;
+  MidiGetStatusInfo(compact->status, &info);
+  if (!MidiStatusInfoIsChannel(&info)) return 0;
+  return compact->status & 0x0F;
+}
+
+bool_t MidiMessageToCompact(
+    midi_message_t const *message, midi_compact_message_t *compact) {
+  if (message == NULL || compact == NULL) return false;
+  if (message->type == MIDI_SYSTEM_EXCLUSIVE) return false;
+  uint8_t data[MIDI_COMPACT_MAX_SIZE] = { 0 };
+  size_t const size = MidiSerializeMessage(message, false, data, sizeof(data));
+  if (size == 0 || size > sizeof(data)) return false;
+  return MidiCompactMessage(compact, data[0], data[1], data[2]);
+}
+
+bool_t MidiCompactToMessage(
+    midi_compact_message_t const *compact, midi_message_t *message) {
+  if (message == NULL) return false;
+  if (!MidiIsValidCompactMessage(compact)) return false;
+  uint8_t data[MIDI_COMPACT_MAX_SIZE];
+  size_t const size = MidiSerializeCompactMessage(
+      compact, false, data, sizeof(data));
+  return MidiDeserializeMessage(data, size, MIDI_NONE, message) == size &&
+      message->type != MIDI_NONE;
+}
+
+size_t MidiSerializeCompactMessage(
+    midi_compact_message_t const *compact, bool_t skip_status,
+    uint8_t *data, size_t data_size) {
+  if (data == NULL && data_size > 0) return 0;
+  if (!MidiIsValidCompactMessage(compact)) return 0;
+  size_t const data_used = compact->data_size + (skip_status ? 0 : 1);
+  /* Truncated, only the required size is reported. */
+  if (data_size < data_used) return data_used;
+  if (!skip_status) *data++ = compact->status;
+  memcpy(data, compact->data, compact->data_size);
+  return data_used;
+}
+
+size_t MidiDeserializeCompactMessage(
+    uint8_t const *data, size_t data_size,
+    midi_status_t status_override, midi_compact_message_t *compact) {
+  if (data == NULL && data_size > 0) return 0;
+  if (compact == NULL) return 0;
+  memset(compact, 0, sizeof(midi_compact_message_t));
+  size_t data_used = 0;
+  midi_status_t status_byte = status_override;
+  if (status_override == MIDI_NONE) {
+    if (data_size == 0) return 1;
+    status_byte = data[0];
+    data_used = 1;
+  }
+  midi_status_info_t info;
+  MidiGetStatusInfo(status_byte, &info);
+  /* Data byte, reserved status or SysEx. */
+  if (!MidiStatusInfoIsDefined(&info)) return 0;
+  if (MidiStatusInfoIsVariableSize(&info)) return 0;
+  compact->status = status_byte;
+  compact->data_size = (uint8_t) MidiStatusInfoDataSize(&info);
+  data_used += compact->data_size;
+  /* Incomplete, only the status is populated. */
+  if (data_size < data_used) return data_used;
+  memcpy(compact->data, &data[data_used - compact->data_size],
+      compact->data_size);
+  if (!MidiIsCompactData(compact->data, compact->data_size)) {
+    memset(compact, 0, sizeof(midi_compact_message_t));
+    return 0;
+  }
+  return data_used;
+}
@@ -0,0 +1,73 @@
+/*
+ * MIDI Controller - MIDI Compact Message
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MIDI_COMPACT_H_
+#define _MIDI_COMPACT_H_
+
+#include "base.h"
+#include "midi_message.h"
+#include "midi_status.h"
+
+C_SECTION_BEGIN;
+
+/*
+ *  Compact MIDI Message
+ *    A 4-byte message which holds the status byte (including channel)
+ *    and the raw data bytes of any channel voice, system common or
+ *    system realtime message.  System Exclusive messages cannot be
+ *    represented, and must be handled by midi_message_t or the SysEx
+ *    receive modes.
+ *    Intended for deep message queues, where a midi_message_t (which
+ *    is sized by the largest SysEx message) is too large.
+ */
+typedef struct {
+  midi_status_t status;
+  uint8_t data[2];
+  /* Number of valid bytes in |data| (0 to 2). */
+  uint8_t data_size;
+} midi_compact_message_t;
+
+/* Checks the status is defined, not SysEx, and that data bytes are
+ * valid for the status.  Values are not checked beyond being data
+ * bytes. */
+bool_t MidiIsValidCompactMessage(midi_compact_message_t const *compact);
+
+/* Constructs a compact message from a raw status and data bytes.  Any
+ * data bytes not required by the status are ignored. */
+bool_t MidiCompactMessage(
+  midi_compact_message_t *compact, midi_status_t status,
+  uint8_t data_0, uint8_t data_1);
+
+midi_message_type_t MidiCompactMessageType(
+  midi_compact_message_t const *compact);
+/* Returns 0 if not a channel message. */
+midi_channel_number_t MidiCompactMessageChannel(
+  midi_compact_message_t const *compact);
+/* Pitch Wheel and Song Position data. */
+#define MidiCompactMessageDataWord(compact) \
+  MidiDataWordFromBytes((compact)->data[1], (compact)->data[0])
+
+/* Conversions to and from midi_message_t.  Converting to a
+ * midi_message_t fully validates the message values. */
+bool_t MidiMessageToCompact(
+  midi_message_t const *message, midi_compact_message_t *compact);
+bool_t MidiCompactToMessage(
+  midi_compact_message_t const *compact, midi_message_t *message);
+
+/* Serialize and deserialize, follows the same conventions as
+ * MidiSerializeMessage() and MidiDeserializeMessage().  A SysEx
+ * status cannot be deserialized (returns 0). */
+size_t MidiSerializeCompactMessage(
+  midi_compact_message_t const *compact, bool_t skip_status,
+  uint8_t *data, size_t data_size);
+size_t MidiDeserializeCompactMessage(
+  uint8_t const *data, size_t data_size,
+  midi_status_t status_override, midi_compact_message_t *compact);
+
+C_SECTION_END;
+
+#endif  /* _MIDI_COMPACT_H_ */
@@ -0,0 +1,145 @@
+/*
+ * MIDI Controller - MIDI Deferred Event Queue
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <string.h>
+
+#include "system_interrupt.h"
+
+#include "midi_callback_internal.h"
+#include "midi_defs.h"
+#include "midi_event_queue.h"
+
+#define MidiEventQueueIndex(queue, offset) \
+  (((queue)->head + (offset)) % MIDI_EVENT_QUEUE_SIZE)
+
+bool_t MidiInitializeEventQueue(
+    midi_event_queue_t *queue, midi_callbacks_t *callbacks,
+    midi_event_queue_policy_t policy) {
+  if (queue == NULL || !MidiIsValidCallbacks(callbacks)) return false;
+  switch (policy) {
+    case MIDI_EVENT_QUEUE_DROP_OLDEST:
+    case MIDI_EVENT_QUEUE_DROP_NEWEST:
+    case MIDI_EVENT_QUEUE_COALESCE_CC:
+      break;
+    default:
+      return false;
+  }
+  memset(queue, 0, sizeof(midi_event_queue_t));
+  queue->callbacks = callbacks;
+  queue->policy = policy;
+  return true;
+}
+
+static void MidiEventQueueSchedulerCallback(
+    void *ctx, scheduler_event_id_t event, system_time_t const *time) {
+  midi_event_queue_t *queue = (midi_event_queue_t *) ctx;
+  MidiDrainEventQueue(queue, MIDI_EVENT_QUEUE_SIZE);
+}
+
+bool_t MidiEventQueueAttachScheduler(
+    midi_event_queue_t *queue, scheduler_t *scheduler,
+    scheduler_event_id_t event) {
+  if (queue == NULL || scheduler == NULL) return false;
+  if (!SchedulerSetEventCallback(
+      scheduler, event, true, MidiEventQueueSchedulerCallback, queue)) {
+    return false;
+  }
+  queue->scheduler = scheduler;
+  queue->scheduler_event = event;
+  return true;
+}
+
+/* Finds the most recent queued control change for the same channel and
+ * controller as |compact|. */
+static midi_queued_event_t *MidiEventQueueFindControlChange(
+    midi_event_queue_t *queue, midi_compact_message_t const *compact) {
+  for (size_t i = queue->count; i > 0; --i) {
+    midi_queued_event_t *event =
+        &queue->events[MidiEventQueueIndex(queue, i - 1)];
+    if (event->message.status == compact->status &&
+        event->message.data[0] == compact->data[0]) {
+      return event;
+    }
+  }
+  return NULL;
+}
+
+/* Returns the slot for a new event, or NULL if the event is dropped. */
+static midi_queued_event_t *MidiEventQueueOverflow(
+    midi_event_queue_t *queue, midi_compact_message_t const *compact) {
+  switch (queue->policy) {
+    case MIDI_EVENT_QUEUE_DROP_OLDEST: {
+      queue->head = MidiEventQueueIndex(queue, 1);
+      --queue->count;
+      ++queue->dropped;
+      return &queue->events[MidiEventQueueIndex(queue, queue->count++)];
+    }
+    case MIDI_EVENT_QUEUE_COALESCE_CC: {
+      if (MidiCompactMessageType(compact) != MIDI_CONTROL_CHANGE) break;
+      midi_queued_event_t *event =
+          MidiEventQueueFindControlChange(queue, compact);
+      if (event == NULL) break;
+      ++queue->coalesced;
+      return event;
+    }
+  }
+  ++queue->dropped;
+  return NULL;
+}
+
+bool_t MidiEventQueueCapture(
+    midi_event_queue_t *queue, uint32_t event_id, uint32_t rx_event_id,
+    midi_time_t const *time, midi_timestamp_t timestamp,
+    midi_message_t const *message) {
+  if (queue == NULL || message == NULL) return false;
+  if (message->type == MIDI_SYSTEM_RESET) return false;
+  midi_compact_message_t compact;
+  /* Fails for SysEx. */
+  if (!MidiMessageToCompact(message, &compact)) return false;
+  midi_queued_event_t *event;
+  if (queue->count == MIDI_EVENT_QUEUE_SIZE) {
+    event = MidiEventQueueOverflow(queue, &compact);
+    if (event == NULL) return true;
+  } else {
+    event = &queue->events[MidiEventQueueIndex(queue, queue->count++)];
+    if (queue->count > queue->max_count) queue->max_count = queue->count;
+  }
+  event->event_id = event_id;
+  event->rx_event_id = rx_event_id;
+  event->has_time = (time != NULL);
+  if (time != NULL) memcpy(&event->time, time, sizeof(midi_time_t));
+  event->timestamp = timestamp;
+  event->message = compact;
+  if (queue->scheduler != NULL) {
+    SchedulerTiggerEvent(queue->scheduler, queue->scheduler_event);
+  }
+  return true;
+}
+
+size_t MidiDrainEventQueue(midi_event_queue_t *queue, size_t max_events) {
+  if (queue == NULL) return 0;
+  size_t drained = 0;
+  while (drained < max_events) {
+    midi_queued_event_t event;
+    SystemDisableInterrupt();
+    bool_t const available = (queue->count > 0);
+    if (available) {
+      memcpy(&event, &queue->events[queue->head], sizeof(event));
+      queue->head = MidiEventQueueIndex(queue, 1);
+      --queue->count;
+    }
+    SystemEnableInterrupt();
+    if (!available) break;
+    midi_message_t message;
+    if (!MidiCompactToMessage(&event.message, &message)) continue;
+    MidiCallOnQueuedMessageCallback(
+        queue->callbacks, event.event_id, event.rx_event_id,
+        event.has_time ? &event.time : NULL, event.timestamp, &message);
+    ++drained;
+  }
+  return drained;
+}
@@ -0,0 +1,104 @@
+/*
+ * MIDI Controller - MIDI Deferred Event Queue
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MIDI_EVENT_QUEUE_H_
+#define _MIDI_EVENT_QUEUE_H_
+
+#include "base.h"
+#include "scheduler.h"
+
+#include "midi_callback.h"
+#include "midi_compact.h"
+#include "midi_message.h"
+#include "midi_time.h"
+
+C_SECTION_BEGIN;
+
+/* Maximum number of events held by the queue. */
+#ifndef MIDI_EVENT_QUEUE_SIZE
+#define MIDI_EVENT_QUEUE_SIZE 16
+#endif
+
+/* Overflow policies, applied when an event is captured while the queue
+ * is full. */
+/* The oldest queued event is dropped to make room. */
+#define MIDI_EVENT_QUEUE_DROP_OLDEST  0x00
+/* The new event is dropped. */
+#define MIDI_EVENT_QUEUE_DROP_NEWEST  0x01
+/* A new control change replaces the value of the most recent queued
+ * control change for the same channel and controller.  Other events
+ * (and control changes without a match) are dropped. */
+#define MIDI_EVENT_QUEUE_COALESCE_CC  0x02
+typedef uint8_t midi_event_queue_policy_t;
+
+typedef struct {
+  /* Event counters at the time the message was captured. */
+  uint32_t event_id;
+  uint32_t rx_event_id;
+  midi_time_t time;
+  bool_t has_time;
+  midi_timestamp_t timestamp;
+  midi_compact_message_t message;
+} midi_queued_event_t;
+
+/*
+ *  MIDI Deferred Event Queue.
+ *    Once set with MidiSetEventQueue(), messages passed to the
+ *    callbacks are captured with their event IDs and time instead of
+ *    being dispatched.  Capturing only copies 4 bytes of message, so
+ *    the receive path (which may be an interrupt) stays short; the
+ *    callbacks are called later from the main loop when the queue is
+ *    drained.
+ *
+ *    A single producer (the receive path) and a single consumer (the
+ *    drain) are supported.  The consumer disables interrupts only
+ *    while removing each event.
+ */
+typedef struct midi_event_queue_s {
+  /* Not owned by the queue. */
+  midi_callbacks_t *callbacks;
+  scheduler_t *scheduler;
+  scheduler_event_id_t scheduler_event;
+  midi_event_queue_policy_t policy;
+  midi_queued_event_t events[MIDI_EVENT_QUEUE_SIZE];
+  size_t head;
+  size_t count;
+  /* Statistics. */
+  uint32_t dropped;
+  uint32_t coalesced;
+  size_t max_count;
+} midi_event_queue_t;
+
+bool_t MidiInitializeEventQueue(
+  midi_event_queue_t *queue, midi_callbacks_t *callbacks,
+  midi_event_queue_policy_t policy);
+
+#define MidiEventQueueCount(queue) ((queue)->count)
+#define MidiEventQueueIsEmpty(queue) ((queue)->count == 0)
+
+/* Registers a reoccuring |scheduler| event callback which drains the
+ * queue, and triggers |event| each time a message is captured. */
+bool_t MidiEventQueueAttachScheduler(
+  midi_event_queue_t *queue, scheduler_t *scheduler,
+  scheduler_event_id_t event);
+
+/* Used by MidiCallOnMessageCallback(), which assigns the event IDs.
+ * Returns false if the message cannot be queued (SysEx, System Reset
+ * or invalid), in which case it is dispatched directly.  A message
+ * dropped by the overflow policy is considered captured. */
+bool_t MidiEventQueueCapture(
+  midi_event_queue_t *queue, uint32_t event_id, uint32_t rx_event_id,
+  midi_time_t const *time, midi_timestamp_t timestamp,
+  midi_message_t const *message);
+
+/* Dispatches up to |max_events| queued events to the callbacks, in the
+ * order they were captured.  Returns the number dispatched. */
+size_t MidiDrainEventQueue(midi_event_queue_t *queue, size_t max_events);
+
+C_SECTION_END;
+
+#endif  /* _MIDI_EVENT_QUEUE_H_ */
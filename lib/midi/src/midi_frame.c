@@ -25,6 +25,31 @@ bool_t MidiFrameBufferEmpty(midi_frame_buffer_t const *frame) {
   return frame->size == 0;
 }
 
+/* Copies |data_size| bytes into the buffer, starting at index |fi|
+ * and wrapping around the end.  At most two memcpy() calls. */
+static void MidiCopyToFrameBuffer(
+    midi_frame_buffer_t *frame, size_t fi,
+    uint8_t const *data, size_t data_size) {
+  size_t const first = (data_size < MIDI_FRAME_BUFFER_SIZE - fi)
+      ? data_size : (MIDI_FRAME_BUFFER_SIZE - fi);
+  memcpy(&frame->buffer[fi], data, first);
+  memcpy(frame->buffer, &data[first], data_size - first);
+}
+
+static void MidiCopyFromFrameBuffer(
+    midi_frame_buffer_t const *frame, size_t fi,
+    uint8_t *data, size_t data_size) {
+  size_t const first = (data_size < MIDI_FRAME_BUFFER_SIZE - fi)
+      ? data_size : (MIDI_FRAME_BUFFER_SIZE - fi);
+  memcpy(data, &frame->buffer[fi], first);
+  memcpy(&data[first], frame->buffer, data_size - first);
+}
+
+static inline void MidiResetFrameBuffer(midi_frame_buffer_t *frame) {
+  frame->front = 0;
+  frame->size = 0;
+}
+
 size_t MidiPutFrameBufferData(
     uint8_t const *data, size_t data_size,
     midi_frame_buffer_t *frame) {
@@ -40,12 +65,9 @@ size_t MidiPutFrameBufferData(
   size_t const size = (size_t) frame->size;
   size_t const front = (size_t) frame->front;
   size_t const back = (front + size) % MIDI_FRAME_BUFFER_SIZE;
-  for (size_t di = 0; di < data_size; ++di) {
-    uint8_t const fi = (uint8_t) ((back + di) % MIDI_FRAME_BUFFER_SIZE);
-    frame->buffer[fi] = data[di];
-  }
+  MidiCopyToFrameBuffer(frame, back, data, data_size);
   if (size + data_size > MIDI_FRAME_BUFFER_SIZE) {
-    frame->front = (front + (MIDI_FRAME_BUFFER_SIZE - data_size))
+    frame->front = (front + (size + data_size - MIDI_FRAME_BUFFER_SIZE))
         % MIDI_FRAME_BUFFER_SIZE;
     frame->size = MIDI_FRAME_BUFFER_SIZE;
   } else {
@@ -63,12 +85,9 @@ size_t MidiPeakFrameBufferData(
   if (frame == NULL || data == NULL) return 0;
   if (data_size == 0 || frame->size == 0) return 0;
   size_t const size = (size_t) frame->size;
-  size_t const front = (size_t) frame->front;
-  for (size_t di = 0; di < data_size && di < size; ++di) {
-    size_t const fi = (di + front) % MIDI_FRAME_BUFFER_SIZE;
-    data[di] = frame->buffer[fi];
-  }
-  return (data_size >= size) ? size : data_size;
+  size_t const to_copy = (data_size >= size) ? size : data_size;
+  MidiCopyFromFrameBuffer(frame, frame->front, data, to_copy);
+  return to_copy;
 }
 
 size_t MidiTakeFrameBufferData(
@@ -77,7 +96,7 @@ size_t MidiTakeFrameBufferData(
   if (taken == 0) return 0;
   size_t const size = frame->size;
   if (taken == size) {
-    MidiClearAllFrameBufferData(frame);
+    MidiResetFrameBuffer(frame);
   } else {
     frame->front = (taken + frame->front) % MIDI_FRAME_BUFFER_SIZE;
     frame->size -= taken;
@@ -90,7 +109,7 @@ size_t MidiClearFrameBufferData(
   if (frame == NULL || data_size == 0) return 0;
   size_t const size = frame->size;
   if (data_size >= size) {
-    MidiClearAllFrameBufferData(frame);
+    MidiResetFrameBuffer(frame);
     return size;
   }
   frame->front = (data_size + frame->front) % MIDI_FRAME_BUFFER_SIZE;
@@ -105,3 +124,35 @@ size_t MidiClearAllFrameBufferData(
   memset(frame, 0, sizeof(midi_frame_buffer_t));
   return size;
 }
+
+size_t MidiGetFrameBufferWriteSpan(
+    midi_frame_buffer_t *frame, uint8_t **span) {
+  if (frame == NULL || span == NULL) return 0;
+  size_t const size = (size_t) frame->size;
+  if (size == 0) MidiResetFrameBuffer(frame);
+  size_t const back = ((size_t) frame->front + size) % MIDI_FRAME_BUFFER_SIZE;
+  *span = &frame->buffer[back];
+  if (size == MIDI_FRAME_BUFFER_SIZE) return 0;
+  /* Free space ends at either the end of the buffer, or the front. */
+  return (back >= frame->front) ? (MIDI_FRAME_BUFFER_SIZE - back)
+      : (frame->front - back);
+}
+
+size_t MidiCommitFrameBufferData(
+    midi_frame_buffer_t *frame, size_t data_size) {
+  if (frame == NULL) return 0;
+  size_t const space = MIDI_FRAME_BUFFER_SIZE - (size_t) frame->size;
+  size_t const committed = (data_size > space) ? space : data_size;
+  frame->size += committed;
+  return committed;
+}
+
+size_t MidiGetFrameBufferReadSpan(
+    midi_frame_buffer_t const *frame, uint8_t const **span) {
+  if (frame == NULL || span == NULL) return 0;
+  size_t const front = (size_t) frame->front;
+  size_t const size = (size_t) frame->size;
+  *span = &frame->buffer[front];
+  return (front + size > MIDI_FRAME_BUFFER_SIZE)
+      ? (MIDI_FRAME_BUFFER_SIZE - front) : size;
+}
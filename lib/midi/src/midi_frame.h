@@ -40,6 +40,26 @@ size_t MidiClearFrameBufferData(
 size_t MidiClearAllFrameBufferData(
     midi_frame_buffer_t *frame);
 
+/* Contiguous spans.
+ *  Allows data to be written to or read from the buffer in place.
+ *  MidiGetFrameBufferWriteSpan() sets |span| to the free space after
+ *  the last byte and returns the number of contiguous bytes that can
+ *  be written; MidiCommitFrameBufferData() then adds the written
+ *  bytes to the buffer.  Unlike MidiPutFrameBufferData(), old data
+ *  is never overwritten.
+ *  MidiGetFrameBufferReadSpan() sets |span| to the first byte and
+ *  returns the number of contiguous bytes that can be read;
+ *  MidiClearFrameBufferData() then consumes them.
+ *  If the data wraps around the end of the buffer, a second span is
+ *  available after the first is committed or consumed.
+ */
+size_t MidiGetFrameBufferWriteSpan(
+    midi_frame_buffer_t *frame, uint8_t **span);
+size_t MidiCommitFrameBufferData(
+    midi_frame_buffer_t *frame, size_t data_size);
+size_t MidiGetFrameBufferReadSpan(
+    midi_frame_buffer_t const *frame, uint8_t const **span);
+
 C_SECTION_END;
 
 #endif  /* _MIDI_FRAME_H_ */
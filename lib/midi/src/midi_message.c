@@ -13,26 +13,22 @@
 /* MIDI Message Functions. */
 
 midi_message_type_t MidiStatusToMessageType(midi_status_t status_byte) {
-  if (!MidiIsStatusByte(status_byte)) return MIDI_NONE;
-  /* Non-channel based messages. */
-  if ((status_byte & 0xF0) == 0xF0) return (midi_message_type_t) status_byte;
-  /* Channel-base (remove lower 4 bits) */
-  return status_byte & 0xF0;
+  midi_status_info_t info;
+  MidiGetStatusInfo(status_byte, &info);
+  return info.type;
 }
 
 bool_t MidiIsValidMessageType(midi_message_type_t message_type) {
-  if (!MidiIsStatusByte(message_type)) return false;
-  if (MidiIsChannelMessageType(message_type)) {
-    /* For channel messages, the message type should not have a channel
-     * value set. */
-    return (message_type & 0x0F) == 0x00;
-  }
-  return true;
+  if (message_type == MIDI_NONE) return false;
+  /* For channel messages, the message type should not have a channel
+   * value set. */
+  return MidiStatusToMessageType(message_type) == message_type;
 }
 
 bool_t MidiIsChannelMessageType(midi_message_type_t message_type) {
-  if (!MidiIsStatusByte(message_type)) return false;
-  return (message_type & 0xF0) != 0xF0;
+  midi_status_info_t info;
+  MidiGetStatusInfo(message_type, &info);
+  return MidiStatusInfoIsChannel(&info);
 }
 
 midi_status_t MidiChannelStatusByte(
@@ -44,7 +40,7 @@ midi_status_t MidiChannelStatusByte(
 }
 
 midi_channel_number_t MidiChannelFromStatusByte(midi_status_t status_byte) {
-  if (!MidiIsChannelMessageType(MidiStatusToMessageType(status_byte))) return 0;
+  if (!MidiIsChannelMessageType(status_byte)) return 0;
   return status_byte & 0x0F;
 }
 
@@ -16,15 +16,12 @@
 #include "midi_notation.h"
 #include "midi_note.h"
 #include "midi_program.h"
+#include "midi_status.h"
 #include "midi_sys_ex.h"
 #include "midi_time.h"
 
 C_SECTION_BEGIN;
 
-/* MIDI message related types. */
-typedef uint8_t midi_status_t;
-typedef uint8_t midi_message_type_t;
-
 /* Strips out channel information from status byte. */
 midi_message_type_t MidiStatusToMessageType(midi_status_t status_byte);
 
@@ -11,32 +11,11 @@
 #include "midi_serialize.h"
 
 size_t MidiMessageDataSize(midi_message_type_t type) {
-  if (!MidiIsValidMessageType(type)) return 0;
-  if (type == MIDI_SYSTEM_EXCLUSIVE) return 0;
-  switch (type) {
-    case MIDI_TUNE_REQUEST:
-    case MIDI_END_SYSTEM_EXCLUSIVE:
-    case MIDI_TIMING_CLOCK:
-    case MIDI_START:
-    case MIDI_CONTINUE:
-    case MIDI_STOP:
-    case MIDI_ACTIVE_SENSING:
-    case MIDI_SYSTEM_RESET:
-      return 0;
-    case MIDI_PROGRAM_CHANGE:
-    case MIDI_CHANNEL_PRESSURE:
-    case MIDI_TIME_CODE:
-    case MIDI_SONG_SELECT:
-      return 1;
-    case MIDI_NOTE_OFF:
-    case MIDI_NOTE_ON:
-    case MIDI_KEY_PRESSURE:
-    case MIDI_CONTROL_CHANGE:
-    case MIDI_PITCH_WHEEL:
-    case MIDI_SONG_POSITION_POINTER:
-      return 2;
-  }
-  return 0;
+  if (type == MIDI_NONE) return 0;
+  midi_status_info_t info;
+  MidiGetStatusInfo(type, &info);
+  if (info.type != type) return 0;
+  return MidiStatusInfoDataSize(&info);
 }
 
 /* MIDI Serializing Functions */
@@ -47,6 +26,9 @@ size_t MidiSerializeMessage(
   if (data == NULL && data_size > 0) return 0;
   if (!MidiIsValidMessage(message)) return 0;
   if (message->type == MIDI_NONE) return 0;
+  midi_status_info_t info;
+  MidiGetStatusInfo(message->type, &info);
+  if (!MidiStatusInfoIsDefined(&info)) return 0;
   uint8_t *message_data = data;
   size_t message_data_size = data_size;
   size_t data_used = 0;
@@ -59,89 +41,58 @@ size_t MidiSerializeMessage(
     data_used = 1;
   }
   /* Data Bytes */
+  if (MidiStatusInfoIsVariableSize(&info)) {
+    size_t const sys_ex_size = MidiSerializeSysEx(
+        &message->sys_ex, message_data, message_data_size);
+    if (sys_ex_size == 0) return 0;
+    data_used += sys_ex_size;
+    if (message_data_size >= (sys_ex_size + 1)) {
+      message_data[sys_ex_size] = MIDI_END_SYSTEM_EXCLUSIVE;
+    }
+    return data_used + 1;
+  }
+  size_t const message_size = MidiStatusInfoDataSize(&info);
+  data_used += message_size;
+  /* Truncated, only the required size is reported. */
+  if (message_data_size < message_size) return data_used;
   switch (message->type) {
     case MIDI_NOTE_OFF:
     case MIDI_NOTE_ON:
-      if (message_data_size >= 2) {
-        message_data[0] = message->note.key;
-        message_data[1] = message->note.velocity;
-      }
-      data_used += 2;
+      message_data[0] = message->note.key;
+      message_data[1] = message->note.velocity;
       break;
     case MIDI_KEY_PRESSURE:
-      if (message_data_size >= 2) {
-        message_data[0] = message->note.key;
-        message_data[1] = message->note.pressure;
-      }
-      data_used += 2;
+      message_data[0] = message->note.key;
+      message_data[1] = message->note.pressure;
       break;
     case MIDI_CONTROL_CHANGE:
-      if (message_data_size >= 2) {
-        message_data[0] = message->control.number;
-        message_data[1] = message->control.value;
-      }
-      data_used += 2;
+      message_data[0] = message->control.number;
+      message_data[1] = message->control.value;
       break;
     case MIDI_PROGRAM_CHANGE:
-      if (message_data_size >= 1)
-        message_data[0] = message->program;
-      ++data_used;
+      message_data[0] = message->program;
       break;
     case MIDI_CHANNEL_PRESSURE:
-      if (message_data_size >= 1)
-        message_data[0] = message->pressure;
-      ++data_used;
+      message_data[0] = message->pressure;
       break;
     case MIDI_PITCH_WHEEL:
-      if (message_data_size >= 2) {
-        message_data[0] = MidiGetDataWordLsb(message->pitch);
-        message_data[1] = MidiGetDataWordMsb(message->pitch);
-      }
-      data_used += 2;
+      message_data[0] = MidiGetDataWordLsb(message->pitch);
+      message_data[1] = MidiGetDataWordMsb(message->pitch);
       break;
-    case MIDI_SYSTEM_EXCLUSIVE: {
-      size_t const sys_ex_size = MidiSerializeSysEx(
-          &message->sys_ex, message_data, message_data_size);
-      if (sys_ex_size == 0) return 0;
-      data_used += sys_ex_size;
-      if (message_data_size >= (sys_ex_size + 1)) {
-        message_data[sys_ex_size] = MIDI_END_SYSTEM_EXCLUSIVE;
-      }
-      ++data_used;
-    } break;
     case MIDI_TIME_CODE:
-      if (message_data_size >= 1) {
-        if (!MidiSerializeTimeCode(&message->time_code, message_data))
-          return 0;
-      }
-      ++data_used;
+      if (!MidiSerializeTimeCode(&message->time_code, message_data))
+        return 0;
       break;
     case MIDI_SONG_POSITION_POINTER:
-      if (message_data_size >= 2) {
-        message_data[0] = MidiGetDataWordLsb(message->song_position);
-        message_data[1] = MidiGetDataWordMsb(message->song_position);
-      }
-      data_used += 2;
+      message_data[0] = MidiGetDataWordLsb(message->song_position);
+      message_data[1] = MidiGetDataWordMsb(message->song_position);
       break;
     case MIDI_SONG_SELECT:
-      if (message_data_size >= 1) {
-        message_data[0] = message->song_number;
-      }
-      ++data_used;
-      break;
-    /* Data-less */
-    case MIDI_TUNE_REQUEST:
-    case MIDI_END_SYSTEM_EXCLUSIVE:
-    case MIDI_TIMING_CLOCK:
-    case MIDI_START:
-    case MIDI_CONTINUE:
-    case MIDI_STOP:
-    case MIDI_ACTIVE_SENSING:
-    case MIDI_SYSTEM_RESET:
-      message_data_size = 0;
+      message_data[0] = message->song_number;
       break;
     default:
-      return 0;
+      /* Data-less */
+      break;
   }  /* switch (message->type) */
   return data_used;
 }
@@ -166,22 +117,24 @@ size_t MidiDeserializeMessage(
   if (message == NULL) return 0;
   memset(message, 0, sizeof(*message));
   size_t data_used = 0;
-  if (status_override != MIDI_NONE) {
-    if (!MidiIsStatusByte(status_override)) return 0;
-    message->type = MidiStatusToMessageType(status_override);
-    message->channel = MidiChannelFromStatusByte(status_override);
-  } else {
+  midi_status_t status_byte = status_override;
+  if (status_override == MIDI_NONE) {
     if (data_size == 0) return 1;
-    midi_status_t const status_byte = data[0];
+    status_byte = data[0];
     data_used = 1;
-    if (!MidiIsStatusByte(status_byte)) return 0;
-    message->type = MidiStatusToMessageType(status_byte);
-    message->channel = MidiChannelFromStatusByte(status_byte);
+  }
+  midi_status_info_t info;
+  MidiGetStatusInfo(status_byte, &info);
+  /* Data byte or reserved status. */
+  if (!MidiStatusInfoIsDefined(&info)) return 0;
+  message->type = info.type;
+  if (MidiStatusInfoIsChannel(&info)) {
+    message->channel = status_byte & 0x0F;
   }
   uint8_t const *message_data = (data == NULL) ? NULL : &data[data_used];
   size_t message_data_size = data_size - data_used;
 
-  if (message->type == MIDI_SYSTEM_EXCLUSIVE) {
+  if (MidiStatusInfoIsVariableSize(&info)) {
     size_t const sys_ex_size = MidiDeserializeSysEx(
         message_data, message_data_size, &message->sys_ex);
     if (sys_ex_size == 0) goto deserialize_error;
@@ -193,92 +146,63 @@ size_t MidiDeserializeMessage(
         return 0;
       /* Drop byte. */
     }
-    ++data_used;
-  } else switch (message->type) {
+    return data_used + 1;
+  }
+  size_t const message_size = MidiStatusInfoDataSize(&info);
+  data_used += message_size;
+  /* Incomplete, only the message type is populated. */
+  if (message_data_size < message_size) return data_used;
+  switch (message->type) {
     case MIDI_NOTE_OFF:
     case MIDI_NOTE_ON:
-      if (message_data_size >= 2) {
-        if (!MidiNote(&message->note, message_data[0], message_data[1]))
-          goto deserialize_error;
-      }
-      data_used += 2;
+      if (!MidiNote(&message->note, message_data[0], message_data[1]))
+        goto deserialize_error;
       break;
     case MIDI_KEY_PRESSURE:
-      if (message_data_size >= 2) {
-        if (!MidiNotePressure(&message->note, message_data[0], message_data[1]))
-          goto deserialize_error;
-      }
-      data_used += 2;
+      if (!MidiNotePressure(&message->note, message_data[0], message_data[1]))
+        goto deserialize_error;
       break;
     case MIDI_CONTROL_CHANGE:
-      if (message_data_size >= 2) {
-        if (!MidiControlChange(&message->control, message_data[0], message_data[1]))
-          goto deserialize_error;
-      }
-      data_used += 2;
+      if (!MidiControlChange(&message->control, message_data[0], message_data[1]))
+        goto deserialize_error;
       break;
     case MIDI_PROGRAM_CHANGE:
-      if (message_data_size >= 1) {
-        if (!MidiIsValidProgramNumber(message_data[0]))
-          goto deserialize_error;
-        message->program = message_data[0];
-      }
-      ++data_used;
+      if (!MidiIsValidProgramNumber(message_data[0]))
+        goto deserialize_error;
+      message->program = message_data[0];
       break;
     case MIDI_CHANNEL_PRESSURE:
-      if (message_data_size >= 1) {
-        if (!MidiIsValidChannelPressure(message_data[0]))
-          goto deserialize_error;
-        message->pressure = message_data[0];
-      }
-      ++data_used;
+      if (!MidiIsValidChannelPressure(message_data[0]))
+        goto deserialize_error;
+      message->pressure = message_data[0];
       break;
     case MIDI_PITCH_WHEEL:
-      if (message_data_size >= 2) {
-        if (!MidiIsDataArray(message_data, 2))
-          goto deserialize_error;
-        message->pitch =
-            MidiDataWordFromBytes(message_data[1], message_data[0]);
-      }
-      data_used += 2;
+      if (!MidiIsDataArray(message_data, 2))
+        goto deserialize_error;
+      message->pitch =
+          MidiDataWordFromBytes(message_data[1], message_data[0]);
       break;
     case MIDI_TIME_CODE:
-      if (message_data_size >= 1) {
-        if (!MidiDeserializeTimeCode(&message->time_code, message_data[0]))
-          goto deserialize_error;
-      }
-      ++data_used;
+      if (!MidiDeserializeTimeCode(&message->time_code, message_data[0]))
+        goto deserialize_error;
       break;
     case MIDI_SONG_POSITION_POINTER:
-      if (message_data_size >= 2) {
-        if (!MidiIsDataArray(message_data, 2))
-          goto deserialize_error;
-        message->song_position = MidiDataWordFromBytes(
-            message_data[1], message_data[0]);
-        /* Song position has specialized checks. */
-        if (!MidiIsValidSongPosition(message->song_position))
-          goto deserialize_error;
-      }
-      data_used += 2;
+      if (!MidiIsDataArray(message_data, 2))
+        goto deserialize_error;
+      message->song_position = MidiDataWordFromBytes(
+          message_data[1], message_data[0]);
+      /* Song position has specialized checks. */
+      if (!MidiIsValidSongPosition(message->song_position))
+        goto deserialize_error;
       break;
     case MIDI_SONG_SELECT:
       if (!MidiIsValidSongNumber(message_data[0]))
         goto deserialize_error;
       message->song_number = message_data[0];
-      ++data_used;
-      break;
-    case MIDI_TUNE_REQUEST:
-    case MIDI_END_SYSTEM_EXCLUSIVE:
-    case MIDI_TIMING_CLOCK:
-    case MIDI_START:
-    case MIDI_CONTINUE:
-    case MIDI_STOP:
-    case MIDI_ACTIVE_SENSING:
-    case MIDI_SYSTEM_RESET:
       break;
     default:
-      /* WUT? Reserved maybe. */
-      goto deserialize_error;
+      /* Data-less */
+      break;
   }
   return data_used;
 deserialize_error:
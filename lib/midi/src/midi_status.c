@@ -0,0 +1,71 @@
+/*
+ * MIDI Controller - MIDI Status Byte Info
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "program_memory.h"
+
+#include "midi_status.h"
+
+#define DATA_ENTRY 0
+#define DATA_ROW \
+  DATA_ENTRY, DATA_ENTRY, DATA_ENTRY, DATA_ENTRY, \
+  DATA_ENTRY, DATA_ENTRY, DATA_ENTRY, DATA_ENTRY, \
+  DATA_ENTRY, DATA_ENTRY, DATA_ENTRY, DATA_ENTRY, \
+  DATA_ENTRY, DATA_ENTRY, DATA_ENTRY, DATA_ENTRY
+
+#define CHANNEL_ENTRY(data_size) \
+  (MIDI_STATUS_DEFINED | MIDI_STATUS_CHANNEL | (data_size))
+#define CHANNEL_ROW(data_size) \
+  CHANNEL_ENTRY(data_size), CHANNEL_ENTRY(data_size), \
+  CHANNEL_ENTRY(data_size), CHANNEL_ENTRY(data_size), \
+  CHANNEL_ENTRY(data_size), CHANNEL_ENTRY(data_size), \
+  CHANNEL_ENTRY(data_size), CHANNEL_ENTRY(data_size), \
+  CHANNEL_ENTRY(data_size), CHANNEL_ENTRY(data_size), \
+  CHANNEL_ENTRY(data_size), CHANNEL_ENTRY(data_size), \
+  CHANNEL_ENTRY(data_size), CHANNEL_ENTRY(data_size), \
+  CHANNEL_ENTRY(data_size), CHANNEL_ENTRY(data_size)
+
+#define SYSTEM_ENTRY(data_size) \
+  (MIDI_STATUS_DEFINED | MIDI_STATUS_SYSTEM | (data_size))
+#define REALTIME_ENTRY \
+  (MIDI_STATUS_DEFINED | MIDI_STATUS_SYSTEM | MIDI_STATUS_REALTIME)
+/* Reserved system status bytes are still considered to be message
+ * types, they just cannot be deserialized. */
+#define RESERVED_ENTRY MIDI_STATUS_SYSTEM
+#define RESERVED_REALTIME_ENTRY (MIDI_STATUS_SYSTEM | MIDI_STATUS_REALTIME)
+
+/* Indexed by the status byte. */
+uint8_t const kMidiStatusFlagsTable[256] __ROM_SECTION = {
+  /* 0x00 - 0x7F */
+  DATA_ROW, DATA_ROW, DATA_ROW, DATA_ROW,
+  DATA_ROW, DATA_ROW, DATA_ROW, DATA_ROW,
+  /* 0x80 - 0xEF */
+  CHANNEL_ROW(2),  /* MIDI_NOTE_OFF */
+  CHANNEL_ROW(2),  /* MIDI_NOTE_ON */
+  CHANNEL_ROW(2),  /* MIDI_KEY_PRESSURE */
+  CHANNEL_ROW(2),  /* MIDI_CONTROL_CHANGE */
+  CHANNEL_ROW(1),  /* MIDI_PROGRAM_CHANGE */
+  CHANNEL_ROW(1),  /* MIDI_CHANNEL_PRESSURE */
+  CHANNEL_ROW(2),  /* MIDI_PITCH_WHEEL */
+  /* 0xF0 - 0xFF */
+  /* MIDI_SYSTEM_EXCLUSIVE */
+  MIDI_STATUS_DEFINED | MIDI_STATUS_SYSTEM | MIDI_STATUS_VARIABLE_SIZE,
+  SYSTEM_ENTRY(1),  /* MIDI_TIME_CODE */
+  SYSTEM_ENTRY(2),  /* MIDI_SONG_POSITION_POINTER */
+  SYSTEM_ENTRY(1),  /* MIDI_SONG_SELECT */
+  RESERVED_ENTRY,  /* 0xF4 */
+  RESERVED_ENTRY,  /* 0xF5 */
+  SYSTEM_ENTRY(0),  /* MIDI_TUNE_REQUEST */
+  SYSTEM_ENTRY(0),  /* MIDI_END_SYSTEM_EXCLUSIVE */
+  REALTIME_ENTRY,  /* MIDI_TIMING_CLOCK */
+  RESERVED_REALTIME_ENTRY,  /* 0xF9 */
+  REALTIME_ENTRY,  /* MIDI_START */
+  REALTIME_ENTRY,  /* MIDI_CONTINUE */
+  REALTIME_ENTRY,  /* MIDI_STOP */
+  RESERVED_REALTIME_ENTRY,  /* 0xFD */
+  REALTIME_ENTRY,  /* MIDI_ACTIVE_SENSING */
+  REALTIME_ENTRY  /* MIDI_SYSTEM_RESET */
+};
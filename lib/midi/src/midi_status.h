@@ -0,0 +1,102 @@
+/*
+ * MIDI Controller - MIDI Status Byte Info
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MIDI_STATUS_H_
+#define _MIDI_STATUS_H_
+
+#include "base.h"
+#include "midi_defs.h"
+
+C_SECTION_BEGIN;
+
+/* MIDI message related types. */
+typedef uint8_t midi_status_t;
+typedef uint8_t midi_message_type_t;
+
+/* Status info flags. */
+/* Number of data bytes which follow the status byte (0 to 2).  Not
+ * valid for variable sized messages. */
+#define MIDI_STATUS_DATA_SIZE_MASK  0x03
+/* Status byte maps to a defined message type (not reserved). */
+#define MIDI_STATUS_DEFINED         0x04
+#define MIDI_STATUS_CHANNEL         0x08
+#define MIDI_STATUS_SYSTEM          0x10
+#define MIDI_STATUS_REALTIME        0x20
+/* Message data is terminated by MIDI_END_SYSTEM_EXCLUSIVE. */
+#define MIDI_STATUS_VARIABLE_SIZE   0x40
+
+/* Info associated with every possible byte value.  For data bytes
+ * the |type| is MIDI_NONE and there are no |flags| set. */
+typedef struct {
+  midi_message_type_t type;
+  uint8_t flags;
+} midi_status_info_t;
+
+/* Status info flags of every byte value, indexed by the byte.  Stored
+ * in ROM, so on AVR it cannot be indexed directly; it must be read
+ * through MidiReadStatusFlags() (or MidiGetStatusInfo()).  It is only
+ * exported for the inline lookup below. */
+extern uint8_t const kMidiStatusFlagsTable[256];
+
+/* Reads the status info flags of |status_byte| from ROM. */
+
+#ifdef _PLATFORM_AVR
+#include <avr/pgmspace.h>
+#define MidiReadStatusFlags(status_byte) \
+  ((uint8_t) pgm_read_byte(&kMidiStatusFlagsTable[(status_byte)]))
+#else
+#define MidiReadStatusFlags(status_byte) \
+  (kMidiStatusFlagsTable[(status_byte)])
+#endif
+
+/* Looks up the status info of |status_byte|.  Only the flags are
+ * stored in ROM (a single byte read), the message type is derived
+ * from the status byte. */
+static inline void MidiGetStatusInfo(
+    midi_status_t status_byte, midi_status_info_t *info) {
+  if (info == NULL) return;
+  uint8_t const flags = MidiReadStatusFlags(status_byte);
+  info->flags = flags;
+  if (flags & MIDI_STATUS_CHANNEL) {
+    info->type = status_byte & 0xF0;
+  } else if (flags & MIDI_STATUS_SYSTEM) {
+    info->type = status_byte;
+  } else {
+    info->type = MIDI_NONE;
+  }
+}
+
+/* System realtime status bytes (0xF8 - 0xFF) may appear anywhere in
+ * the data stream, including between the data bytes of other
+ * messages. */
+#define MidiIsRealtimeStatus(status) ((status) >= 0xF8)
+
+/* Dense index of a message type, for tables with an entry per message
+ * type.  Channel message types (0x80 - 0xE0) map to 0 - 6, and system
+ * message types (0xF0 - 0xFF) map to 7 - 22.  Only valid for status
+ * bytes with the channel stripped. */
+#define MIDI_MESSAGE_TYPE_COUNT 23
+#define MIDI_CHANNEL_MESSAGE_TYPE_COUNT 7
+#define MidiMessageTypeIndex(type) \
+  ((size_t) (((type) < 0xF0) ? (((type) >> 4) - 0x08) : ((type) - 0xE9)))
+
+#define MidiStatusInfoDataSize(info) \
+  ((size_t) ((info)->flags & MIDI_STATUS_DATA_SIZE_MASK))
+#define MidiStatusInfoIsDefined(info) \
+  (((info)->flags & MIDI_STATUS_DEFINED) != 0)
+#define MidiStatusInfoIsChannel(info) \
+  (((info)->flags & MIDI_STATUS_CHANNEL) != 0)
+#define MidiStatusInfoIsSystem(info) \
+  (((info)->flags & MIDI_STATUS_SYSTEM) != 0)
+#define MidiStatusInfoIsRealtime(info) \
+  (((info)->flags & MIDI_STATUS_REALTIME) != 0)
+#define MidiStatusInfoIsVariableSize(info) \
+  (((info)->flags & MIDI_STATUS_VARIABLE_SIZE) != 0)
+
+C_SECTION_END;
+
+#endif  /* _MIDI_STATUS_H_ */
@@ -152,7 +152,6 @@ bool_t MidiInitializeSysUni(
   if (real_time) {
     if (!MidiIsValidRealtimeSubId(sub_id)) return false;
     sys_ex->id[0] = MIDI_REAL_TIME_ID;
-    return true;
   } else {
     if (!MidiIsValidNonRealtimeSubId(sub_id)) return false;
     sys_ex->id[0] = MIDI_NON_REAL_TIME_ID;
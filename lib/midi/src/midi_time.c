@@ -330,12 +330,20 @@ size_t MidiSerializeTime(
   return data_used;
 }
 
+/* Drop frame skips frames 0 and 1 at the start of each minute, except
+ * for minutes 00, 10, 20, 30, 40 and 50. */
+#define MIDI_DROP_FRAME_COUNT 2
+#define MidiIsDroppedMinute(time) \
+    ((time)->fps == MIDI_30_FPS_DROP_FRAME && \
+     (time)->seconds == 0 && ((time)->minutes % 10) != 0)
+
 bool_t MidiIncrementTimeFrame(midi_time_t *time) {
   if (!MidiIsValidTime(time)) return false;
   ++time->frame;
   if (time->frame >= MidiFpsValue(time->fps)) {
     time->frame = 0;
-    return MidiIncrementTimeSeconds(time);
+    if (!MidiIncrementTimeSeconds(time)) return false;
+    if (MidiIsDroppedMinute(time)) time->frame = MIDI_DROP_FRAME_COUNT;
   }
   return true;
 }
@@ -368,3 +376,162 @@ bool_t MidiIncrementTimeHours(midi_time_t *time) {
   }
   return true;
 }
+
+bool_t MidiDecrementTimeFrame(midi_time_t *time) {
+  if (!MidiIsValidTime(time)) return false;
+  uint8_t const first_frame =
+      MidiIsDroppedMinute(time) ? MIDI_DROP_FRAME_COUNT : 0;
+  if (time->frame <= first_frame) {
+    time->frame = MidiFpsValue(time->fps) - 1;
+    return MidiDecrementTimeSeconds(time);
+  }
+  --time->frame;
+  return true;
+}
+
+bool_t MidiDecrementTimeSeconds(midi_time_t *time) {
+  if (!MidiIsValidTime(time)) return false;
+  if (time->seconds == 0) {
+    time->seconds = MIDI_SECONDS_COUNT_MAX;
+    return MidiDecrementTimeMinutes(time);
+  }
+  --time->seconds;
+  return true;
+}
+
+bool_t MidiDecrementTimeMinutes(midi_time_t *time) {
+  if (!MidiIsValidTime(time)) return false;
+  if (time->minutes == 0) {
+    time->minutes = MIDI_MINUTES_COUNT_MAX;
+    return MidiDecrementTimeHours(time);
+  }
+  --time->minutes;
+  return true;
+}
+
+bool_t MidiDecrementTimeHours(midi_time_t *time) {
+  if (!MidiIsValidTime(time)) return false;
+  if (time->hours == 0) {
+    time->hours = MIDI_HOURS_COUNT_MAX;
+  } else {
+    --time->hours;
+  }
+  return true;
+}
+
+/*
+ *  MIDI Frame Count.
+ */
+#define MIDI_SECONDS_PER_DAY            86400ul
+#define MIDI_MINUTES_PER_DAY            1440ul
+#define MIDI_NANOSECONDS_PER_SECOND     1000000000ull
+/* At 30 fps drop frame, 2 frames are dropped in 9 of every 10 minutes. */
+#define MIDI_DROP_FRAME_PER_MINUTE      (30ul * 60ul - MIDI_DROP_FRAME_COUNT)
+#define MIDI_DROP_FRAME_PER_10_MINUTES  \
+    (30ul * 600ul - 9ul * MIDI_DROP_FRAME_COUNT)
+
+/* Frames per second is |rate| / |scale|. */
+typedef struct {
+  uint16_t rate;
+  uint16_t scale;
+} midi_frame_rate_t;
+
+/* Indexed by fps >> 5. */
+static midi_frame_rate_t const kMidiFrameRates[] = {
+  { 24, 1 },        /* MIDI_24_FPS */
+  { 25, 1 },        /* MIDI_25_FPS */
+  { 30000, 1001 },  /* MIDI_30_FPS_DROP_FRAME */
+  { 30, 1 }         /* MIDI_30_FPS_NON_DROP */
+};
+
+#define MidiFrameRate(fps) (&kMidiFrameRates[(fps) >> 5])
+
+/* Number of frames dropped before the start of |minutes| (counted from
+ * 00:00). */
+#define MidiDroppedFrames(minutes) \
+    (MIDI_DROP_FRAME_COUNT * ((minutes) - (minutes) / 10))
+
+midi_frame_count_t MidiFrameCountPerDay(uint8_t fps) {
+  if (!MidiIsValidTimeFps(fps)) return 0;
+  midi_frame_count_t const frames = MIDI_SECONDS_PER_DAY * MidiFpsValue(fps);
+  if (fps == MIDI_30_FPS_DROP_FRAME) {
+    return frames - MidiDroppedFrames(MIDI_MINUTES_PER_DAY);
+  }
+  return frames;
+}
+
+bool_t MidiTimeToFrameCount(
+    midi_time_t const *time, midi_frame_count_t *frames) {
+  if (!MidiIsValidTime(time) || frames == NULL) return false;
+  if (time->frame >= MidiFpsValue(time->fps)) return false;
+  if (MidiIsDroppedMinute(time) && time->frame < MIDI_DROP_FRAME_COUNT) {
+    return false;
+  }
+  uint32_t const minutes = (uint32_t) time->hours * 60 + time->minutes;
+  uint32_t const seconds = minutes * 60 + time->seconds;
+  *frames = seconds * MidiFpsValue(time->fps) + time->frame;
+  if (time->fps == MIDI_30_FPS_DROP_FRAME) {
+    *frames -= MidiDroppedFrames(minutes);
+  }
+  return true;
+}
+
+bool_t MidiFrameCountToTime(
+    midi_frame_count_t frames, uint8_t fps, midi_time_t *time) {
+  if (time == NULL) return false;
+  if (frames >= MidiFrameCountPerDay(fps)) return false;
+  if (fps == MIDI_30_FPS_DROP_FRAME) {
+    /* Add back the dropped frame numbers, then count as 30 fps. */
+    uint32_t const tens = frames / MIDI_DROP_FRAME_PER_10_MINUTES;
+    uint32_t const remainder = frames % MIDI_DROP_FRAME_PER_10_MINUTES;
+    frames += 9 * MIDI_DROP_FRAME_COUNT * tens;
+    if (remainder >= MIDI_DROP_FRAME_COUNT) {
+      frames += MIDI_DROP_FRAME_COUNT
+              * ((remainder - MIDI_DROP_FRAME_COUNT)
+                 / MIDI_DROP_FRAME_PER_MINUTE);
+    }
+  }
+  uint8_t const fps_value = MidiFpsValue(fps);
+  uint32_t const seconds = frames / fps_value;
+  time->frame = frames % fps_value;
+  time->seconds = seconds % 60;
+  time->minutes = (seconds / 60) % 60;
+  time->hours = seconds / 3600;
+  time->fps = fps;
+  return true;
+}
+
+bool_t MidiOffsetTime(midi_time_t *time, int32_t frames) {
+  midi_frame_count_t count;
+  if (!MidiTimeToFrameCount(time, &count)) return false;
+  midi_frame_count_t const per_day = MidiFrameCountPerDay(time->fps);
+  /* Reduce the offset first so the sum cannot overflow. */
+  int32_t offset = frames % (int32_t) per_day;
+  if (offset < 0) offset += (int32_t) per_day;
+  count = (count + (midi_frame_count_t) offset) % per_day;
+  return MidiFrameCountToTime(count, time->fps, time);
+}
+
+/* Products are split into whole seconds of frames and a remainder so
+ * the intermediate values do not overflow. */
+bool_t MidiFrameCountToNanoseconds(
+    midi_frame_count_t frames, uint8_t fps, uint64_t *ns) {
+  if (!MidiIsValidTimeFps(fps) || ns == NULL) return false;
+  midi_frame_rate_t const *rate = MidiFrameRate(fps);
+  uint64_t const ns_per_rate = MIDI_NANOSECONDS_PER_SECOND * rate->scale;
+  *ns = (uint64_t) (frames / rate->rate) * ns_per_rate
+      + ((uint64_t) (frames % rate->rate) * ns_per_rate) / rate->rate;
+  return true;
+}
+
+bool_t MidiNanosecondsToFrameCount(
+    uint64_t ns, uint8_t fps, midi_frame_count_t *frames) {
+  if (!MidiIsValidTimeFps(fps) || frames == NULL) return false;
+  midi_frame_rate_t const *rate = MidiFrameRate(fps);
+  uint64_t const ns_per_rate = MIDI_NANOSECONDS_PER_SECOND * rate->scale;
+  uint64_t const count = (ns / ns_per_rate) * rate->rate
+      + ((ns % ns_per_rate) * rate->rate) / ns_per_rate;
+  if (count > UINT32_MAX) return false;
+  *frames = (midi_frame_count_t) count;
+  return true;
+}
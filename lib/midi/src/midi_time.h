@@ -71,6 +71,45 @@ bool_t MidiIncrementTimeSeconds(midi_time_t *time);
 bool_t MidiIncrementTimeMinutes(midi_time_t *time);
 bool_t MidiIncrementTimeHours(midi_time_t *time);
 
+/* Frame increments and decrements skip the frame numbers dropped at
+ * 30 fps drop frame (frames 0 and 1 of each minute, except for every
+ * tenth minute).  Hours roll over in both directions. */
+bool_t MidiDecrementTimeFrame(midi_time_t *time);
+bool_t MidiDecrementTimeSeconds(midi_time_t *time);
+bool_t MidiDecrementTimeMinutes(midi_time_t *time);
+bool_t MidiDecrementTimeHours(midi_time_t *time);
+
+/*
+ *  MIDI Frame Count.
+ *    Absolute number of frames since 00:00:00:00, for a given fps.  At
+ *    30 fps drop frame, the dropped frame numbers are not counted, so
+ *    consecutive frames always differ by one.  Frame counts of the same
+ *    fps can be added, subtracted and compared directly.
+ */
+typedef uint32_t midi_frame_count_t;
+
+/* Number of frames in 24 hours, or 0 if |fps| is invalid. */
+midi_frame_count_t MidiFrameCountPerDay(uint8_t fps);
+
+/* Fails if the frame does not exist at |time|'s fps (including the
+ * dropped frame numbers at 30 fps drop frame). */
+bool_t MidiTimeToFrameCount(
+  midi_time_t const *time, midi_frame_count_t *frames);
+/* Fails if |frames| is not within a day. */
+bool_t MidiFrameCountToTime(
+  midi_frame_count_t frames, uint8_t fps, midi_time_t *time);
+
+/* Moves |time| by |frames| (may be negative), rolling over at 24 hours. */
+bool_t MidiOffsetTime(midi_time_t *time, int32_t frames);
+
+/* Conversions to and from the real time elapsed since 00:00:00:00.
+ * 30 fps drop frame runs at 29.97 fps.  Nanoseconds are rounded down to
+ * the start of the frame. */
+bool_t MidiFrameCountToNanoseconds(
+  midi_frame_count_t frames, uint8_t fps, uint64_t *ns);
+bool_t MidiNanosecondsToFrameCount(
+  uint64_t ns, uint8_t fps, midi_frame_count_t *frames);
+
 C_SECTION_END;
 
 #endif  /* _MIDI_TIME_H_ */
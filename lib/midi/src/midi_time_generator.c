@@ -0,0 +1,203 @@
+/*
+ * MIDI Controller - MIDI Time Code Generator
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <string.h>
+
+#include "midi_defs.h"
+#include "midi_time_generator.h"
+
+/* Quarter frame intervals are not whole nanoseconds for most frame
+ * rates; the fraction (|carry| / |divisor|) is carried between
+ * intervals. */
+typedef struct {
+  uint32_t interval_ns;
+  uint8_t carry;
+  uint8_t divisor;
+} midi_quarter_frame_interval_t;
+
+/* Indexed by fps >> 5. */
+static midi_quarter_frame_interval_t const kMidiQuarterFrameIntervals[] = {
+  /* 24 fps: 1 / 96 s */
+  { 10416666, 2, 3 },
+  /* 25 fps: 1 / 100 s */
+  { 10000000, 0, 1 },
+  /* 29.97 fps drop frame: 1001 / 120000 s */
+  { 8341666, 2, 3 },
+  /* 30 fps: 1 / 120 s */
+  { 8333333, 1, 3 }
+};
+
+#define MidiQuarterFrameInterval(fps) (&kMidiQuarterFrameIntervals[(fps) >> 5])
+#define MIDI_QUARTER_FRAMES_PER_FRAME 4
+
+static bool_t MidiIsValidTimeDirection(midi_time_direction_t direction) {
+  return direction == MIDI_TIME_FORWARD || direction == MIDI_TIME_REVERSE;
+}
+
+bool_t MidiInitializeTimeGenerator(
+    midi_time_generator_t *generator, scheduler_t *scheduler,
+    midi_device_id_t device_id, midi_time_generator_send_t send,
+    void *send_ctx) {
+  if (generator == NULL || scheduler == NULL || send == NULL) return false;
+  if (!MidiIsValidDeviceId(device_id)) return false;
+  memset(generator, 0, sizeof(midi_time_generator_t));
+  generator->scheduler = scheduler;
+  generator->send = send;
+  generator->send_ctx = send_ctx;
+  generator->device_id = device_id;
+  generator->direction = MIDI_TIME_FORWARD;
+  MidiInitializeTime(&generator->time);
+  generator->timer = SCHEDULER_TIMER_HANDLE_NULL;
+  return true;
+}
+
+bool_t MidiTimeGeneratorLocate(
+    midi_time_generator_t *generator, midi_time_t const *time) {
+  if (generator == NULL || !MidiIsValidTime(time)) return false;
+  midi_message_t message;
+  if (!MidiSystemExclusiveMessage(&message, NULL)) return false;
+  if (!MidiInitializeSysUni(
+      &message.sys_ex, true, generator->device_id, MIDI_RT_TIME_CODE)) {
+    return false;
+  }
+  if (!MidiInitializeFullTimeCodeMessage(
+      &message.sys_ex.rt_time_code, time)) {
+    return false;
+  }
+  memcpy(&generator->time, time, sizeof(midi_time_t));
+  generator->quarter_frame = 0;
+  generator->send(generator->send_ctx, &message);
+  return true;
+}
+
+static void MidiTimeGeneratorUpdateStats(
+    midi_time_generator_t *generator, system_time_t const *time) {
+  midi_time_generator_stats_t *stats = &generator->stats;
+  uint32_t jitter_us;
+  if (!SystemTimeMicrosecondsDelta(&generator->deadline, time, &jitter_us)) {
+    jitter_us = UINT32_MAX;
+  }
+  ++stats->quarter_frames;
+  stats->last_jitter_us = jitter_us;
+  if (jitter_us > stats->max_jitter_us) stats->max_jitter_us = jitter_us;
+  stats->total_jitter_us = (jitter_us > UINT32_MAX - stats->total_jitter_us)
+      ? UINT32_MAX : stats->total_jitter_us + jitter_us;
+  midi_quarter_frame_interval_t const *interval =
+      MidiQuarterFrameInterval(generator->time.fps);
+  if (jitter_us >= interval->interval_ns / 1000) ++stats->late;
+}
+
+static void MidiTimeGeneratorSendQuarterFrame(
+    midi_time_generator_t *generator) {
+  if (generator->quarter_frame == 0) {
+    /* Latch the time of the new cycle. */
+    MidiSerializeTime(
+        &generator->time, generator->direction,
+        generator->cycle, sizeof(generator->cycle));
+  }
+  midi_time_code_t time_code;
+  midi_message_t message;
+  if (MidiDeserializeTimeCode(
+          &time_code, generator->cycle[generator->quarter_frame]) &&
+      MidiTimeCodeMessage(&message, &time_code)) {
+    generator->send(generator->send_ctx, &message);
+  }
+  ++generator->quarter_frame;
+  if ((generator->quarter_frame % MIDI_QUARTER_FRAMES_PER_FRAME) == 0) {
+    if (generator->direction == MIDI_TIME_REVERSE) {
+      MidiDecrementTimeFrame(&generator->time);
+    } else {
+      MidiIncrementTimeFrame(&generator->time);
+    }
+  }
+  if (generator->quarter_frame == MIDI_SERIALIZED_TIME_PAYLOAD_SIZE) {
+    generator->quarter_frame = 0;
+  }
+}
+
+static void MidiTimeGeneratorAdvanceDeadline(
+    midi_time_generator_t *generator) {
+  midi_quarter_frame_interval_t const *interval =
+      MidiQuarterFrameInterval(generator->time.fps);
+  uint32_t interval_ns = interval->interval_ns;
+  generator->carry += interval->carry;
+  if (generator->carry >= interval->divisor) {
+    generator->carry -= interval->divisor;
+    ++interval_ns;
+  }
+  SystemTimeIncrementNanoseconds(&generator->deadline, interval_ns);
+}
+
+static void MidiTimeGeneratorTimerCallback(
+    void *ctx, system_time_t const *time) {
+  midi_time_generator_t *generator = (midi_time_generator_t *) ctx;
+  MidiTimeGeneratorUpdateStats(generator, time);
+  MidiTimeGeneratorSendQuarterFrame(generator);
+  MidiTimeGeneratorAdvanceDeadline(generator);
+  /* Timers cannot be set before the scheduler's last update; a missed
+   * deadline is due again immediately. */
+  system_time_t const *deadline =
+      SystemTimeLessThan(&generator->deadline, time)
+      ? NULL : &generator->deadline;
+  SchedulerRescheduleTimerMicroseconds(
+      generator->scheduler, generator->timer, 0, deadline);
+}
+
+bool_t MidiTimeGeneratorStart(
+    midi_time_generator_t *generator, midi_time_direction_t direction,
+    system_time_t const *current_time) {
+  if (generator == NULL || !MidiIsValidTimeDirection(direction)) {
+    return false;
+  }
+  generator->direction = direction;
+  generator->quarter_frame = 0;
+  if (MidiIsTimeGeneratorRunning(generator)) return true;
+  if (current_time == NULL) {
+    memcpy(&generator->deadline, &generator->scheduler->last_update,
+           sizeof(system_time_t));
+  } else {
+    memcpy(&generator->deadline, current_time, sizeof(system_time_t));
+  }
+  generator->carry = 0;
+  generator->timer = SchedulerSetDelayedCallbackMicroseconds(
+      generator->scheduler, 0, current_time,
+      MidiTimeGeneratorTimerCallback, generator);
+  return generator->timer != SCHEDULER_TIMER_HANDLE_NULL;
+}
+
+bool_t MidiTimeGeneratorStop(midi_time_generator_t *generator) {
+  if (generator == NULL) return false;
+  SchedulerCancelTimer(generator->scheduler, generator->timer);
+  generator->timer = SCHEDULER_TIMER_HANDLE_NULL;
+  return true;
+}
+
+bool_t MidiIsTimeGeneratorRunning(midi_time_generator_t const *generator) {
+  if (generator == NULL) return false;
+  return SchedulerIsTimerPending(generator->scheduler, generator->timer);
+}
+
+bool_t MidiGetTimeGeneratorTime(
+    midi_time_generator_t const *generator, midi_time_t *time) {
+  if (generator == NULL || time == NULL) return false;
+  memcpy(time, &generator->time, sizeof(midi_time_t));
+  return true;
+}
+
+bool_t MidiGetTimeGeneratorStats(
+    midi_time_generator_t const *generator,
+    midi_time_generator_stats_t *stats) {
+  if (generator == NULL || stats == NULL) return false;
+  memcpy(stats, &generator->stats, sizeof(midi_time_generator_stats_t));
+  return true;
+}
+
+bool_t MidiResetTimeGeneratorStats(midi_time_generator_t *generator) {
+  if (generator == NULL) return false;
+  memset(&generator->stats, 0, sizeof(midi_time_generator_stats_t));
+  return true;
+}
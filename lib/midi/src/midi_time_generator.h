@@ -0,0 +1,107 @@
+/*
+ * MIDI Controller - MIDI Time Code Generator
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MIDI_TIME_GENERATOR_H_
+#define _MIDI_TIME_GENERATOR_H_
+
+#include "base.h"
+#include "scheduler.h"
+#include "system_time.h"
+
+#include "midi_message.h"
+#include "midi_sys_ex.h"
+#include "midi_time.h"
+
+C_SECTION_BEGIN;
+
+/* Called for each message generated.  Quarter frames are generated from
+ * a scheduler timer callback. */
+typedef void (*midi_time_generator_send_t)
+  (void */* ctx */, midi_message_t const */* message */);
+
+typedef struct {
+  /* Number of quarter frames sent since the stats were reset. */
+  uint32_t quarter_frames;
+  /* Jitter is the time, in us, that a quarter frame was sent after its
+   * ideal time. */
+  uint32_t last_jitter_us;
+  uint32_t max_jitter_us;
+  /* Saturates at UINT32_MAX. */
+  uint32_t total_jitter_us;
+  /* Quarter frames sent a full quarter frame or more late. */
+  uint32_t late;
+} midi_time_generator_stats_t;
+
+/*
+ *  MIDI Time Code Generator.
+ *    Sends the 8 quarter frame cycle of |time| while running, one
+ *    quarter frame per scheduler timer callback.  The time of each
+ *    quarter frame is kept to the nanosecond, including the fractional
+ *    intervals of 24, 29.97 (drop frame) and 30 fps, so the time code
+ *    does not drift from system time.
+ *
+ *    Forward, the cycle is sent in order, starting with the frame LSN,
+ *    and |time| advances by one frame every 4 quarter frames.  Reverse,
+ *    the cycle is sent in reverse order and |time| goes back.  Each
+ *    cycle sends the time at the start of the cycle.
+ *
+ *    If the scheduler falls behind, the missed quarter frames are sent
+ *    immediately to catch back up.
+ */
+typedef struct {
+  /* Not owned by the generator. */
+  scheduler_t *scheduler;
+  midi_time_generator_send_t send;
+  void *send_ctx;
+  midi_device_id_t device_id;
+  /* Current time and direction. */
+  midi_time_t time;
+  midi_time_direction_t direction;
+  /* Time code data bytes of the current cycle, in order sent. */
+  uint8_t cycle[MIDI_SERIALIZED_TIME_PAYLOAD_SIZE];
+  uint8_t quarter_frame;
+  /* Ideal time of the next quarter frame, and the fractional nanoseconds
+   * carried between intervals. */
+  system_time_t deadline;
+  uint8_t carry;
+  scheduler_timer_handle_t timer;
+  midi_time_generator_stats_t stats;
+} midi_time_generator_t;
+
+/* Full time code messages are addressed to |device_id| (MIDI_ALL_CALL
+ * for all devices). */
+bool_t MidiInitializeTimeGenerator(
+  midi_time_generator_t *generator, scheduler_t *scheduler,
+  midi_device_id_t device_id, midi_time_generator_send_t send,
+  void *send_ctx);
+
+/* Sets the time and sends a full time code message.  If running, the
+ * next quarter frame starts a new cycle from |time|. */
+bool_t MidiTimeGeneratorLocate(
+  midi_time_generator_t *generator, midi_time_t const *time);
+
+/* Starts sending quarter frames, the first at |current_time| (or the
+ * scheduler's last update if NULL).  If already running, the next
+ * quarter frame starts a new cycle in |direction|. */
+bool_t MidiTimeGeneratorStart(
+  midi_time_generator_t *generator, midi_time_direction_t direction,
+  system_time_t const *current_time);
+bool_t MidiTimeGeneratorStop(midi_time_generator_t *generator);
+
+bool_t MidiIsTimeGeneratorRunning(midi_time_generator_t const *generator);
+
+bool_t MidiGetTimeGeneratorTime(
+  midi_time_generator_t const *generator, midi_time_t *time);
+
+bool_t MidiGetTimeGeneratorStats(
+  midi_time_generator_t const *generator,
+  midi_time_generator_stats_t *stats);
+bool_t MidiResetTimeGeneratorStats(midi_time_generator_t *generator);
+
+C_SECTION_END;
+
+#endif  /* _MIDI_TIME_GENERATOR_H_ */
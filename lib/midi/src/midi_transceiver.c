@@ -9,6 +9,7 @@
 
 #include "logging.h"
 
+#include "midi_callback_internal.h"
 #include "midi_defs.h"
 #include "midi_serialize.h"
 #include "midi_transceiver.h"
@@ -32,21 +33,117 @@
 /* Receiver is in SysEx mode, all data bytes will be consumed until
 *  the EndSysEx byte. */
 #define MIDI_RX_SYS_EX_MODE   0x01
+/* Stream SysEx mode only, the SysEx start event has been emitted. */
+#define MIDI_RX_SYS_EX_STARTED  0x02
+
+#define MidiReceiverBufferData(rx_ctx) (&(rx_ctx)->buffer[(rx_ctx)->head])
+
+/* The start timestamp of the message being received has been set. */
+#define MIDI_RX_START_TIMESTAMPED  0x04
+
+/* Receive timestamp of the byte at |byte_ptr|, which must be within the
+ * data passed to MidiReceiveTimestampedData(). */
+#define MidiReceiverByteTimestamp(rx_ctx, byte_ptr) \
+  (((rx_ctx)->timestamps == NULL) ? 0 : \
+   (rx_ctx)->timestamps[(byte_ptr) - (rx_ctx)->timestamp_data])
 
 bool_t MidiInitializeReceiverCtx(midi_rx_ctx_t *rx_ctx) {
   if (rx_ctx == NULL) return false;
-  memset(rx_ctx->buffer, 0,  MIDI_RX_BUFFER_SIZE);
-  rx_ctx->size = 0;
+  rx_ctx->head = 0;
+  rx_ctx->tail = 0;
   rx_ctx->status = MIDI_NONE;
   rx_ctx->flags = MIDI_NONE;
+  rx_ctx->sys_ex_mode = MIDI_RX_SYS_EX_DECODE;
+  rx_ctx->callbacks = NULL;
+  rx_ctx->timestamp = 0;
+  rx_ctx->start_timestamp = 0;
+  rx_ctx->timestamp_data = NULL;
+  rx_ctx->timestamps = NULL;
   return true;
 }
 
-static size_t MidiSeekStatusInternal(
+static inline void MidiReceiverClearBuffer(midi_rx_ctx_t *rx_ctx) {
+  rx_ctx->head = 0;
+  rx_ctx->tail = 0;
+}
+
+/* Drops |count| bytes from the front of the receiver buffer.  Once
+ * empty, the buffer is rewound to the start. */
+static inline void MidiReceiverConsumeBuffer(
+    midi_rx_ctx_t *rx_ctx, size_t count) {
+  rx_ctx->head += count;
+  if (rx_ctx->head >= rx_ctx->tail) {
+    MidiReceiverClearBuffer(rx_ctx);
+  }
+}
+
+/* Appends a single byte to the receiver buffer.  The pending data is
+ * only moved to the front of the buffer if the end of the buffer has
+ * been reached and there is space at the front.  Returns false if the
+ * buffer is full. */
+static inline bool_t MidiReceiverPushBuffer(
+    midi_rx_ctx_t *rx_ctx, uint8_t byte) {
+  if (rx_ctx->tail >= MIDI_RX_BUFFER_SIZE) {
+    if (rx_ctx->head == 0) return false;
+    size_t const size = MidiReceiverBufferSize(rx_ctx);
+    LOG_RX_DEBUG("Rewinding receiver buffer: head = %zu, size = %zu",
+        rx_ctx->head, size);
+    memmove(rx_ctx->buffer, MidiReceiverBufferData(rx_ctx), size);
+    rx_ctx->head = 0;
+    rx_ctx->tail = size;
+  }
+  rx_ctx->buffer[rx_ctx->tail++] = byte;
+  return true;
+}
+
+static bool_t MidiReceiverPushBufferData(
     midi_rx_ctx_t *rx_ctx, uint8_t const *data, size_t data_size) {
+  for (size_t i = 0; i < data_size; ++i) {
+    if (!MidiReceiverPushBuffer(rx_ctx, data[i])) return false;
+  }
+  return true;
+}
+
+/* Realtime bytes are handled as soon as they are received, without
+ * changing the receiver state, so that any in-progress message or
+ * running status is preserved.  If callbacks are attached, the
+ * realtime message is dispatched directly; otherwise it is returned
+ * through |message|.  Reserved realtime bytes are ignored. */
+static void MidiReceiveRealtimeInternal(
+    midi_rx_ctx_t *rx_ctx, uint8_t const *status_byte,
+    midi_message_t *message) {
+  midi_status_t const status = *status_byte;
+  LOG_RX_DEBUG("Realtime: status = 0x%02x", status);
+  midi_status_info_t info;
+  MidiGetStatusInfo(status, &info);
+  if (!MidiStatusInfoIsDefined(&info)) return;
+  midi_timestamp_t const timestamp =
+      MidiReceiverByteTimestamp(rx_ctx, status_byte);
+  if (rx_ctx->callbacks == NULL) {
+    memset(message, 0, sizeof(midi_message_t));
+    message->type = status;
+    rx_ctx->timestamp = timestamp;
+    return;
+  }
+  midi_message_t const realtime = { .type = status };
+  if (status == MIDI_SYSTEM_RESET) {
+    /* The receiver has nothing that is affected by a soft reset. */
+    bool_t soft_reset = false;
+    MidiCallOnSystemResetCallback(
+        rx_ctx->callbacks, NULL, &realtime, &soft_reset);
+  } else {
+    MidiCallOnTimestampedMessageCallback(
+        rx_ctx->callbacks, NULL, timestamp, &realtime);
+  }
+}
+
+static size_t MidiSeekStatusInternal(
+    midi_rx_ctx_t *rx_ctx, uint8_t const *data, size_t data_size,
+    midi_message_t *message) {
   LOG_RX_TRACE("rx_ctx = %p, data = %p, data_size = %zu",
                rx_ctx, data, data_size);
-  LOG_RX_DEBUG("rx_ctx->size = %zu", rx_ctx->size);
+  LOG_RX_DEBUG("rx_ctx->head = %zu, rx_ctx->tail = %zu",
+      rx_ctx->head, rx_ctx->tail);
   LOG_RX_DEBUG("rx_ctx->status = 0x%02x", rx_ctx->status);
   LOG_RX_DEBUG("rx_ctx->flags = %s",
                (rx_ctx->flags & MIDI_RX_SYS_EX_MODE) ?
@@ -54,15 +151,24 @@ static size_t MidiSeekStatusInternal(
   /* Assume all variables are valid. |data| != NULL and |data_size| > 0. */
   rx_ctx->status = MIDI_NONE;
   rx_ctx->flags = MIDI_NONE;
-  if (rx_ctx->size > 0) {
-    LOG_RX_DEBUG("Clearing receiver buffer");
-    memset(rx_ctx->buffer, 0, MIDI_RX_BUFFER_SIZE);
-    rx_ctx->size = 0;
-  }
+  MidiReceiverClearBuffer(rx_ctx);
   for (size_t i = 0; i < data_size;  ++i) {
     if (data[i] == MIDI_END_SYSTEM_EXCLUSIVE) continue;
+    if (MidiIsRealtimeStatus(data[i])) {
+      MidiReceiveRealtimeInternal(rx_ctx, &data[i], message);
+      if (message->type != MIDI_NONE) return i + 1;
+      continue;
+    }
     if (MidiIsStatusByte(data[i])) {
+      if (rx_ctx->callbacks != NULL &&
+          MidiIsMaskedChannelStatus(rx_ctx->callbacks, data[i])) {
+        /* The data bytes that follow are skipped by the seek. */
+        LOG_RX_DEBUG("Channel masked: data[%zu] = 0x%02x", i, data[i]);
+        continue;
+      }
       rx_ctx->status = data[i];
+      rx_ctx->start_timestamp = MidiReceiverByteTimestamp(rx_ctx, &data[i]);
+      rx_ctx->flags |= MIDI_RX_START_TIMESTAMPED;
       LOG_RX_DEBUG("Status found: data[%zu] = 0x%02x", i, data[i]);
       if (rx_ctx->status == MIDI_SYSTEM_EXCLUSIVE) {
         LOG_RX_DEBUG("Starting SysEx mode");
@@ -77,10 +183,12 @@ static size_t MidiSeekStatusInternal(
 }
 
 static size_t MidiReceiveSysExDataInternal(
-    midi_rx_ctx_t *rx_ctx, uint8_t const *data, size_t data_size) {
+    midi_rx_ctx_t *rx_ctx, uint8_t const *data, size_t data_size,
+    midi_message_t *message) {
   LOG_RX_TRACE("rx_ctx = %p, data = %p, data_size = %zu",
                rx_ctx, data, data_size);
-  LOG_RX_DEBUG("rx_ctx->size = %zu", rx_ctx->size);
+  LOG_RX_DEBUG("rx_ctx->head = %zu, rx_ctx->tail = %zu",
+      rx_ctx->head, rx_ctx->tail);
   LOG_RX_DEBUG("rx_ctx->status = 0x%02x", rx_ctx->status);
   LOG_RX_DEBUG("rx_ctx->flags = %s",
       (rx_ctx->flags & MIDI_RX_SYS_EX_MODE) ? "MIDI_RX_SYS_EX_MODE" : "0");
@@ -88,6 +196,11 @@ static size_t MidiReceiveSysExDataInternal(
   rx_ctx->status = MIDI_SYSTEM_EXCLUSIVE;
   size_t i;
   for (i = 0; i < data_size && (rx_ctx->flags & MIDI_RX_SYS_EX_MODE); ++i) {
+    if (MidiIsRealtimeStatus(data[i])) {
+      MidiReceiveRealtimeInternal(rx_ctx, &data[i], message);
+      if (message->type != MIDI_NONE) return i + 1;
+      continue;
+    }
     if (data[i] == MIDI_END_SYSTEM_EXCLUSIVE) {
       LOG_RX_DEBUG("Ending SysEx mode: index = %zu", i);
       rx_ctx->flags &= ~MIDI_RX_SYS_EX_MODE;
@@ -96,51 +209,189 @@ static size_t MidiReceiveSysExDataInternal(
       rx_ctx->status = MIDI_NONE;
       break;
     }
-    if (rx_ctx->size >= MIDI_RX_BUFFER_SIZE) {
+    if (!MidiReceiverPushBuffer(rx_ctx, data[i])) {
       LOG_RX_DEBUG("Receiver overflow in SysEx: index = %zu", i);
       rx_ctx->status = MIDI_NONE;
       break;
     }
-    rx_ctx->buffer[rx_ctx->size++] = data[i];
   }
   /* If still in SysEx mode, then more data is needed. */
   if (rx_ctx->flags & MIDI_RX_SYS_EX_MODE) return data_size + 1;
-  LOG_RX_DEBUG("SysEx complete: rx_ctx->size = %zu", rx_ctx->size);
+  LOG_RX_DEBUG("SysEx complete: size = %zu", MidiReceiverBufferSize(rx_ctx));
   return i;
 }
 
+static void MidiReceiverResetSysEx(midi_rx_ctx_t *rx_ctx) {
+  rx_ctx->status = MIDI_NONE;
+  rx_ctx->flags &= ~(MIDI_RX_SYS_EX_MODE | MIDI_RX_SYS_EX_STARTED);
+  MidiReceiverClearBuffer(rx_ctx);
+}
+
+/* Ends a SysEx stream which has been started, as incomplete, on the
+ * currently attached callbacks. */
+static void MidiReceiverAbortSysExStream(midi_rx_ctx_t *rx_ctx) {
+  if (rx_ctx->sys_ex_mode != MIDI_RX_SYS_EX_STREAM) return;
+  if (!(rx_ctx->flags & MIDI_RX_SYS_EX_STARTED)) return;
+  LOG_RX_DEBUG("SysEx stream aborted");
+  MidiCallOnSysExEndCallback(rx_ctx->callbacks, NULL, false);
+  MidiReceiverResetSysEx(rx_ctx);
+}
+
+bool_t MidiReceiverSetSysExMode(
+    midi_rx_ctx_t *rx_ctx, midi_rx_sys_ex_mode_t sys_ex_mode) {
+  if (rx_ctx == NULL) return false;
+  switch (sys_ex_mode) {
+    case MIDI_RX_SYS_EX_DECODE:
+      break;
+    case MIDI_RX_SYS_EX_RAW:
+    case MIDI_RX_SYS_EX_STREAM:
+      if (rx_ctx->callbacks == NULL) return false;
+      break;
+    default:
+      return false;
+  }
+  if (rx_ctx->sys_ex_mode == sys_ex_mode) return true;
+  MidiReceiverAbortSysExStream(rx_ctx);
+  rx_ctx->sys_ex_mode = sys_ex_mode;
+  rx_ctx->status = MIDI_NONE;
+  rx_ctx->flags = MIDI_NONE;
+  MidiReceiverClearBuffer(rx_ctx);
+  return true;
+}
+
+bool_t MidiReceiverSetCallbacks(
+    midi_rx_ctx_t *rx_ctx, midi_callbacks_t *callbacks) {
+  if (rx_ctx == NULL) return false;
+  if (callbacks != NULL && !MidiIsValidCallbacks(callbacks)) return false;
+  if (callbacks != rx_ctx->callbacks) MidiReceiverAbortSysExStream(rx_ctx);
+  rx_ctx->callbacks = callbacks;
+  if (callbacks == NULL && rx_ctx->sys_ex_mode != MIDI_RX_SYS_EX_DECODE) {
+    MidiReceiverSetSysExMode(rx_ctx, MIDI_RX_SYS_EX_DECODE);
+  }
+  return true;
+}
+
+/* Raw SysEx mode.  A SysEx which is complete in |data| and has not
+ * been staged is passed to the callback directly from |data|.
+ * Otherwise, the SysEx data is staged in the receiver buffer until
+ * the EndSysEx byte is received.  The EndSysEx byte is never staged. */
+static size_t MidiReceiveRawSysExDataInternal(
+    midi_rx_ctx_t *rx_ctx, uint8_t const *data, size_t data_size,
+    midi_message_t *message) {
+  LOG_RX_TRACE("rx_ctx = %p, data = %p, data_size = %zu",
+               rx_ctx, data, data_size);
+  LOG_RX_DEBUG("rx_ctx->head = %zu, rx_ctx->tail = %zu",
+      rx_ctx->head, rx_ctx->tail);
+  rx_ctx->status = MIDI_SYSTEM_EXCLUSIVE;
+  size_t start = 0, i;
+  for (i = 0; i < data_size; ++i) {
+    if (data[i] == MIDI_END_SYSTEM_EXCLUSIVE) break;
+    if (MidiIsDataByte(data[i])) continue;
+    if (!MidiIsRealtimeStatus(data[i])) {
+      /* The status byte is left for the next seek. */
+      LOG_RX_DEBUG("Non-data byte in SysEx: data[%zu] = 0x%02x", i, data[i]);
+      MidiReceiverResetSysEx(rx_ctx);
+      return i;
+    }
+    /* The SysEx data is no longer contiguous, stage what came before
+     * the realtime byte. */
+    if (!MidiReceiverPushBufferData(rx_ctx, &data[start], i - start)) {
+      LOG_RX_DEBUG("Receiver overflow in SysEx: index = %zu", i);
+      MidiReceiverResetSysEx(rx_ctx);
+      return i;
+    }
+    start = i + 1;
+    MidiReceiveRealtimeInternal(rx_ctx, &data[i], message);
+    if (message->type != MIDI_NONE) return start;
+  }
+  if (i == data_size || MidiReceiverBufferSize(rx_ctx) > 0) {
+    if (!MidiReceiverPushBufferData(rx_ctx, &data[start], i - start)) {
+      LOG_RX_DEBUG("Receiver overflow in SysEx: index = %zu", i);
+      MidiReceiverResetSysEx(rx_ctx);
+      return i;
+    }
+    if (i == data_size) return data_size + 1;
+    LOG_RX_DEBUG("Staged SysEx complete: size = %zu",
+        MidiReceiverBufferSize(rx_ctx));
+    MidiCallOnSysExDataCallback(
+        rx_ctx->callbacks, NULL, MidiReceiverBufferData(rx_ctx),
+        MidiReceiverBufferSize(rx_ctx));
+  } else {
+    LOG_RX_DEBUG("SysEx complete: size = %zu", i - start);
+    MidiCallOnSysExDataCallback(
+        rx_ctx->callbacks, NULL, &data[start], i - start);
+  }
+  MidiReceiverResetSysEx(rx_ctx);
+  return i + 1;
+}
+
+/* Stream SysEx mode.  Nothing is staged, all SysEx data bytes in
+ * |data| are passed as a single chunk, unless split by realtime
+ * bytes. */
+static size_t MidiReceiveStreamSysExDataInternal(
+    midi_rx_ctx_t *rx_ctx, uint8_t const *data, size_t data_size,
+    midi_message_t *message) {
+  LOG_RX_TRACE("rx_ctx = %p, data = %p, data_size = %zu",
+               rx_ctx, data, data_size);
+  rx_ctx->status = MIDI_SYSTEM_EXCLUSIVE;
+  if (!(rx_ctx->flags & MIDI_RX_SYS_EX_STARTED)) {
+    LOG_RX_DEBUG("SysEx stream start");
+    rx_ctx->flags |= MIDI_RX_SYS_EX_STARTED;
+    MidiCallOnSysExStartCallback(rx_ctx->callbacks, NULL);
+  }
+  size_t start = 0, i;
+  for (i = 0; i < data_size; ++i) {
+    if (MidiIsDataByte(data[i])) continue;
+    if (!MidiIsRealtimeStatus(data[i])) break;
+    if (i > start) {
+      MidiCallOnSysExChunkCallback(
+          rx_ctx->callbacks, NULL, &data[start], i - start);
+    }
+    start = i + 1;
+    MidiReceiveRealtimeInternal(rx_ctx, &data[i], message);
+    if (message->type != MIDI_NONE) return start;
+  }
+  if (i > start) {
+    LOG_RX_DEBUG("SysEx stream chunk: size = %zu", i - start);
+    MidiCallOnSysExChunkCallback(
+        rx_ctx->callbacks, NULL, &data[start], i - start);
+  }
+  if (i == data_size) return data_size + 1;
+  bool_t const complete = (data[i] == MIDI_END_SYSTEM_EXCLUSIVE);
+  LOG_RX_DEBUG("SysEx stream end: complete = %d", complete);
+  MidiCallOnSysExEndCallback(rx_ctx->callbacks, NULL, complete);
+  MidiReceiverResetSysEx(rx_ctx);
+  /* An interrupting status byte is left for the next seek. */
+  return complete ? i + 1 : i;
+}
+
 static size_t MidiReceiverDeserializeMessage(
     midi_rx_ctx_t *rx_ctx, midi_message_t *message) {
   LOG_RX_TRACE("rx_ctx = %p, message = %p", rx_ctx, message);
-  LOG_RX_DEBUG("rx_ctx->size = %zu", rx_ctx->size);
+  LOG_RX_DEBUG("rx_ctx->head = %zu, rx_ctx->tail = %zu",
+      rx_ctx->head, rx_ctx->tail);
   LOG_RX_DEBUG("rx_ctx->status = 0x%02x", rx_ctx->status);
   LOG_RX_DEBUG("rx_ctx->flags = %s",
       (rx_ctx->flags & MIDI_RX_SYS_EX_MODE) ? "MIDI_RX_SYS_EX_MODE" : "0");
+  size_t const size = MidiReceiverBufferSize(rx_ctx);
   size_t const res = MidiDeserializeMessage(
-      rx_ctx->buffer, rx_ctx->size, rx_ctx->status, message);
+      MidiReceiverBufferData(rx_ctx), size, rx_ctx->status, message);
   if (res == 0 || res > MIDI_RX_BUFFER_SIZE) {
     /* Either no data required, error, or message is beyond buffer data
      * limit (unlikely).  In any case, the receiver status needs to be
      * cleared.  If the message doesn't require any data, then status-run
      * should be prevented. */
     rx_ctx->status = MIDI_NONE;
-    if (rx_ctx->size > 0) {
-      LOG_RX_DEBUG("Clearing receiver buffer");
-      memset(rx_ctx->buffer, 0, MIDI_RX_BUFFER_SIZE);
-      rx_ctx->size = 0;
-    }
+    MidiReceiverClearBuffer(rx_ctx);
     if (res > MIDI_RX_BUFFER_SIZE) {
       LOG_RX_DEBUG("Deserialization overflow: required_size = %zu", res);
       message->type = MIDI_NONE;
     }
-  } else if (res <= rx_ctx->size) {
+  } else if (res <= size) {
     /* Complete */
-    LOG_RX_DEBUG("Shifting buffer: shift = %zu, new_size = %zu",
-        res, rx_ctx->size - res);
-    for (size_t i = 0; i < (rx_ctx->size - res); ++i) {
-      rx_ctx->buffer[i] = rx_ctx->buffer[i + res];
-    }
-    rx_ctx->size -= res;
+    LOG_RX_DEBUG("Consuming buffer: consumed = %zu, new_size = %zu",
+        res, size - res);
+    MidiReceiverConsumeBuffer(rx_ctx, res);
     if (rx_ctx->status == MIDI_SYSTEM_EXCLUSIVE) {
       LOG_RX_DEBUG("Force clearing SysEx status");
       rx_ctx->status = MIDI_NONE;
@@ -158,14 +409,16 @@ static size_t MidiReceiveDataInternal(
     midi_message_t *message) {
   LOG_RX_TRACE("rx_ctx = %p, data = %p, data_size = %zu, message = %p",
       rx_ctx, data, data_size, message);
-  LOG_RX_DEBUG("rx_ctx->size = %zu", rx_ctx->size);
+  LOG_RX_DEBUG("rx_ctx->head = %zu, rx_ctx->tail = %zu",
+      rx_ctx->head, rx_ctx->tail);
   LOG_RX_DEBUG("rx_ctx->status = 0x%02x", rx_ctx->status);
   LOG_RX_DEBUG("rx_ctx->flags = %s",
       (rx_ctx->flags & MIDI_RX_SYS_EX_MODE) ? "MIDI_RX_SYS_EX_MODE" : "0");
   /* Assume all variables are valid. |data| != NULL and |data_size| > 0. */
   size_t di = 0;
   if (rx_ctx->status == MIDI_NONE) {
-    size_t const res = MidiSeekStatusInternal(rx_ctx, data, data_size);
+    size_t const res = MidiSeekStatusInternal(
+        rx_ctx, data, data_size, message);
     if (res > data_size) {
       LOG_RX_DEBUG("Incomplete seek: res = %zu", res);
       return res;
@@ -173,11 +426,29 @@ static size_t MidiReceiveDataInternal(
     LOG_RX_DEBUG("Increament data index: prev_index = %zu, post_index = %zu",
         di, di + res);
     di += res;
+    if (message->type != MIDI_NONE) return di;
   }
   /* If in SysEx mode, seek for EndSysEx. */
   if (rx_ctx->flags & MIDI_RX_SYS_EX_MODE) {
-    size_t const res = MidiReceiveSysExDataInternal(
-        rx_ctx, &data[di], data_size - di);
+    size_t res;
+    switch (rx_ctx->sys_ex_mode) {
+      case MIDI_RX_SYS_EX_RAW:
+        res = MidiReceiveRawSysExDataInternal(
+            rx_ctx, &data[di], data_size - di, message);
+        break;
+      case MIDI_RX_SYS_EX_STREAM:
+        res = MidiReceiveStreamSysExDataInternal(
+            rx_ctx, &data[di], data_size - di, message);
+        break;
+      default:
+        res = MidiReceiveSysExDataInternal(
+            rx_ctx, &data[di], data_size - di, message);
+        break;
+    }
+    if (message->type != MIDI_NONE) {
+      LOG_RX_DEBUG("Realtime during SysEx: data_used = %zu", di + res);
+      return di + res;
+    }
     if (res > (data_size - di)) {
       LOG_RX_DEBUG("Incomplete SysEx: res = %zu", di + res);
       return di + res;
@@ -196,24 +467,44 @@ static size_t MidiReceiveDataInternal(
   if (res == 0 || message->type != MIDI_NONE) {
     if (message->type != MIDI_NONE) {
       LOG_RX_DEBUG("Deserialization complete: data_used = %zu", di);
+      rx_ctx->timestamp = rx_ctx->start_timestamp;
+      /* Any running status message is stamped by its first data byte. */
+      rx_ctx->flags &= ~MIDI_RX_START_TIMESTAMPED;
     }
     return di;
   }
 
   LOG_RX_DEBUG("Consuming data: required_data = %zu, available_data = %zu",
-      res - rx_ctx->size, data_size - di);
-  while (di < data_size && rx_ctx->size < res) {
+      res - MidiReceiverBufferSize(rx_ctx), data_size - di);
+  while (di < data_size && MidiReceiverBufferSize(rx_ctx) < res) {
+    if (MidiIsRealtimeStatus(data[di])) {
+      MidiReceiveRealtimeInternal(rx_ctx, &data[di++], message);
+      if (message->type != MIDI_NONE) return di;
+      continue;
+    }
     if (!MidiIsDataByte(data[di])) {
       LOG_RX_DEBUG("Unexpected non-data byte: data[%zu] = 0x%02x",
                    di, data[di]);
       rx_ctx->status = MIDI_NONE;
       return di;
     }
-    rx_ctx->buffer[rx_ctx->size++] = data[di++];
+    if (!MidiReceiverPushBuffer(rx_ctx, data[di])) {
+      /* The partial message is dropped, the remaining data bytes are
+       * skipped by the next seek. */
+      LOG_RX_DEBUG("Receiver overflow: data[%zu] = 0x%02x", di, data[di]);
+      rx_ctx->status = MIDI_NONE;
+      MidiReceiverClearBuffer(rx_ctx);
+      return di;
+    }
+    if (!(rx_ctx->flags & MIDI_RX_START_TIMESTAMPED)) {
+      rx_ctx->start_timestamp = MidiReceiverByteTimestamp(rx_ctx, &data[di]);
+      rx_ctx->flags |= MIDI_RX_START_TIMESTAMPED;
+    }
+    ++di;
   }
   LOG_RX_DEBUG("Return: data_used = %zu, required_data = %zu",
-      di, res - rx_ctx->size);
-  return di + (res - rx_ctx->size);
+      di, res - MidiReceiverBufferSize(rx_ctx));
+  return di + (res - MidiReceiverBufferSize(rx_ctx));
 }
 
 size_t MidiReceiveData(
@@ -231,17 +522,18 @@ size_t MidiReceiveData(
    * needed for the message. */
   if (data_size == 0) {
     if (rx_ctx->status == MIDI_NONE) return 1;
+    size_t const size = MidiReceiverBufferSize(rx_ctx);
     size_t const res = MidiDeserializeMessage(
-        rx_ctx->buffer, rx_ctx->size, rx_ctx->status, message);
+        MidiReceiverBufferData(rx_ctx), size, rx_ctx->status, message);
     LOG_RX_DEBUG("Receive peak: res = %zu", res);
-    if (res > rx_ctx->size) {
+    if (res > size) {
       message->type = MIDI_NONE;
     }
     if (res == 0) {
       return (message->type == MIDI_NONE) ? 1 : 0;
     }
-    LOG_RX_DEBUG("Receiver peak: required_data = %zu", res - rx_ctx->size);
-    return res - rx_ctx->size;
+    LOG_RX_DEBUG("Receiver peak: required_data = %zu", res - size);
+    return res - size;
   }
 
   size_t res = 0;
@@ -254,6 +546,136 @@ size_t MidiReceiveData(
   return res;
 }
 
+size_t MidiReceiveTimestampedData(
+    midi_rx_ctx_t *rx_ctx, uint8_t const *data,
+    midi_timestamp_t const *timestamps, size_t data_size,
+    midi_message_t *message) {
+  if (rx_ctx == NULL) return 0;
+  if (timestamps == NULL && data_size > 0) return 0;
+  rx_ctx->timestamp_data = data;
+  rx_ctx->timestamps = timestamps;
+  size_t const res = MidiReceiveData(rx_ctx, data, data_size, message);
+  rx_ctx->timestamp_data = NULL;
+  rx_ctx->timestamps = NULL;
+  return res;
+}
+
+size_t MidiReceiveDataBatch(
+    midi_rx_ctx_t *rx_ctx,
+    uint8_t const *data, size_t data_size,
+    midi_message_t *messages, size_t max_messages, size_t *consumed) {
+  LOG_RX_TRACE("rx_ctx = %p, data = %p, data_size = %zu, messages = %p, "
+      "max_messages = %zu", rx_ctx, data, data_size, messages, max_messages);
+  if (consumed != NULL) *consumed = 0;
+  if (rx_ctx == NULL || messages == NULL || max_messages == 0) return 0;
+  if (data == NULL && data_size > 0) return 0;
+
+  /* Similar to MidiReceiveData(), the final message of |data| is only
+   * deserialized once all of |data| has been consumed. */
+  size_t di = 0, mi = 0;
+  while (di <= data_size && mi < max_messages) {
+    midi_message_t *message = &messages[mi];
+    message->type = MIDI_NONE;
+    uint8_t const *message_data = (data == NULL) ? NULL : &data[di];
+    size_t const res = MidiReceiveDataInternal(
+        rx_ctx, message_data, data_size - di, message);
+    if (res > (data_size - di)) {
+      /* All remaining data is held by the receiver. */
+      di = data_size;
+      break;
+    }
+    di += res;
+    if (message->type != MIDI_NONE) ++mi;
+  }
+  LOG_RX_DEBUG("Receiver batch done: messages = %zu, data_used = %zu", mi, di);
+  if (consumed != NULL) *consumed = di;
+  return mi;
+}
+
+/*
+ *  Compact Receiver Context
+ */
+
+bool_t MidiInitializeCompactReceiverCtx(
+    midi_compact_rx_ctx_t *rx_ctx, midi_callbacks_t *callbacks) {
+  if (rx_ctx == NULL) return false;
+  if (callbacks != NULL && !MidiIsValidCallbacks(callbacks)) return false;
+  memset(rx_ctx, 0, sizeof(midi_compact_rx_ctx_t));
+  rx_ctx->callbacks = callbacks;
+  return true;
+}
+
+static bool_t MidiCompactReceiverComplete(
+    midi_compact_rx_ctx_t *rx_ctx, midi_status_t status,
+    midi_compact_message_t *message) {
+  message->status = status;
+  message->data_size = rx_ctx->data_count;
+  message->data[0] = rx_ctx->data[0];
+  message->data[1] = rx_ctx->data[1];
+  rx_ctx->data_count = 0;
+  rx_ctx->data[0] = rx_ctx->data[1] = 0;
+  if (rx_ctx->callbacks != NULL) {
+    MidiCallOnCompactMessageCallback(rx_ctx->callbacks, NULL, message);
+  }
+  return true;
+}
+
+bool_t MidiReceiveCompactByte(
+    midi_compact_rx_ctx_t *rx_ctx, uint8_t byte,
+    midi_compact_message_t *message) {
+  if (rx_ctx == NULL || message == NULL) return false;
+  if (MidiIsDataByte(byte)) {
+    /* Also drops SysEx data. */
+    if (rx_ctx->status == MIDI_NONE) return false;
+    rx_ctx->data[rx_ctx->data_count++] = byte;
+    if (rx_ctx->data_count < rx_ctx->data_size) return false;
+    /* Status is kept for running status. */
+    return MidiCompactReceiverComplete(rx_ctx, rx_ctx->status, message);
+  }
+  midi_status_info_t info;
+  MidiGetStatusInfo(byte, &info);
+  if (MidiStatusInfoIsRealtime(&info)) {
+    if (!MidiStatusInfoIsDefined(&info)) return false;
+    /* Does not affect the message being received. */
+    *message = (midi_compact_message_t) { .status = byte };
+    if (rx_ctx->callbacks != NULL) {
+      MidiCallOnCompactMessageCallback(rx_ctx->callbacks, NULL, message);
+    }
+    return true;
+  }
+  rx_ctx->data_count = 0;
+  rx_ctx->data[0] = rx_ctx->data[1] = 0;
+  if (!MidiStatusInfoIsDefined(&info) ||
+      MidiStatusInfoIsVariableSize(&info) ||
+      byte == MIDI_END_SYSTEM_EXCLUSIVE ||
+      (rx_ctx->callbacks != NULL &&
+       MidiIsMaskedChannelStatus(rx_ctx->callbacks, byte))) {
+    rx_ctx->status = MIDI_NONE;
+    return false;
+  }
+  rx_ctx->data_size = (uint8_t) MidiStatusInfoDataSize(&info);
+  if (rx_ctx->data_size > 0) {
+    rx_ctx->status = byte;
+    return false;
+  }
+  rx_ctx->status = MIDI_NONE;
+  return MidiCompactReceiverComplete(rx_ctx, byte, message);
+}
+
+size_t MidiReceiveCompactData(
+    midi_compact_rx_ctx_t *rx_ctx, uint8_t const *data, size_t data_size,
+    midi_compact_message_t *messages, size_t max_messages, size_t *consumed) {
+  if (consumed != NULL) *consumed = 0;
+  if (rx_ctx == NULL || messages == NULL || max_messages == 0) return 0;
+  if (data == NULL) return 0;
+  size_t di = 0, mi = 0;
+  while (di < data_size && mi < max_messages) {
+    if (MidiReceiveCompactByte(rx_ctx, data[di++], &messages[mi])) ++mi;
+  }
+  if (consumed != NULL) *consumed = di;
+  return mi;
+}
+
 /*
  *  Transmitter Context
  */
@@ -301,6 +723,25 @@ size_t MidiTransmitterSerializeMessage(
       tx_ctx, message, data, data_size);
 }
 
+size_t MidiTransmitterSerializeCompactMessage(
+    midi_tx_ctx_t *tx_ctx, midi_compact_message_t const *compact,
+    uint8_t *data, size_t data_size) {
+  if (tx_ctx == NULL) return 0;
+  if (data == NULL && data_size > 0) return 0;
+  if (!MidiIsValidCompactMessage(compact)) return 0;
+  bool_t const skip_status =
+      MidiTransmitterRunEnabled(tx_ctx) &&
+      compact->status == tx_ctx->status;
+  size_t const data_used = MidiSerializeCompactMessage(
+      compact, skip_status, data, data_size);
+  if (MidiTransmitterRunEnabled(tx_ctx) && compact->data_size > 0) {
+    tx_ctx->status = compact->status;
+  } else {
+    tx_ctx->status = MIDI_NONE;
+  }
+  return data_used;
+}
+
 size_t MidiTransmitterSerializeMessages(
     midi_tx_ctx_t *tx_ctx,
     midi_message_t const *messages, size_t message_count,
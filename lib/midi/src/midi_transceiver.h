@@ -9,6 +9,8 @@
 #define _MIDI_TRANSCEIVER_H_
 
 #include "base.h"
+#include "midi_callback.h"
+#include "midi_compact.h"
 #include "midi_message.h"
 
 C_SECTION_BEGIN;
@@ -18,16 +20,71 @@ C_SECTION_BEGIN;
 /*
  *  Receiver Context
  */
+
+/* SysEx receive modes. */
+/* SysEx messages are buffered and deserialized into a midi_message_t
+ * (default). */
+#define MIDI_RX_SYS_EX_DECODE   0x00
+/* SysEx messages are not deserialized.  The raw SysEx data is passed
+ * to the OnSysExData() callback.  If the message is received whole
+ * within a single call to the receiver, the callback is given a
+ * pointer into the receiver's input data, no copies are made.  Only
+ * messages that span multiple calls are staged in the receiver buffer. */
+#define MIDI_RX_SYS_EX_RAW      0x01
+/* SysEx messages are not deserialized nor buffered.  The SysEx data
+ * is passed to the OnSysExStart(), OnSysExChunk() and OnSysExEnd()
+ * callbacks as it is received, allowing messages of any size in
+ * constant memory.  Each call to the receiver produces at most one
+ * chunk per SysEx, unless the SysEx data is split by realtime bytes. */
+#define MIDI_RX_SYS_EX_STREAM   0x02
+typedef uint8_t midi_rx_sys_ex_mode_t;
+
 typedef struct {
-  /* Buffer only contains data bytes. */
+  /* Buffer only contains data bytes.  The pending data is located
+   * between |head| (inclusive) and |tail| (exclusive).  Consumed bytes
+   * are dropped by advancing |head|, they are never shifted or
+   * cleared. */
   uint8_t buffer[MIDI_RX_BUFFER_SIZE];
-  size_t size;
+  size_t head;
+  size_t tail;
   /* The current status type being processed.. */
   midi_status_t status;
   uint8_t flags;
+  midi_rx_sys_ex_mode_t sys_ex_mode;
+  /* Optional, not owned by the receiver. */
+  midi_callbacks_t *callbacks;
+  /* Receive timestamp of the last message received, and of the first
+   * byte of the message being received. */
+  midi_timestamp_t timestamp;
+  midi_timestamp_t start_timestamp;
+  /* Only set during MidiReceiveTimestampedData(). */
+  uint8_t const *timestamp_data;
+  midi_timestamp_t const *timestamps;
 } midi_rx_ctx_t;
 
+/* Number of data bytes currently held by the receiver. */
+#define MidiReceiverBufferSize(rx_ctx) \
+  ((size_t) ((rx_ctx)->tail - (rx_ctx)->head))
+
 bool_t MidiInitializeReceiverCtx(midi_rx_ctx_t *rx_ctx);
+/* Attaches a callback set to the receiver.  |callbacks| may be NULL
+ * to detach, in which case the SysEx mode is reset to decode.
+ *
+ * System realtime messages may be received at any point, even
+ * between the data bytes of another message, without interrupting
+ * the message being received.  When callbacks are attached, realtime
+ * messages are dispatched to them as soon as they are received and are
+ * not returned by the receive functions.  Channel messages on channels
+ * outside of the callbacks' |channel_mask| are skipped at the status
+ * byte and are not returned. */
+bool_t MidiReceiverSetCallbacks(
+  midi_rx_ctx_t *rx_ctx, midi_callbacks_t *callbacks);
+/* Changes the SysEx receive mode.  Raw and stream modes require
+ * callbacks to be attached.  Any partially received message is dropped;
+ * a started SysEx stream is ended as incomplete.  Changing or detaching
+ * the callbacks does the same. */
+bool_t MidiReceiverSetSysExMode(
+  midi_rx_ctx_t *rx_ctx, midi_rx_sys_ex_mode_t sys_ex_mode);
 /* Will consume bytes from |data| until the first full message can be
  * formed, or |data_size| is reached.
  * Returns values:
@@ -39,6 +96,60 @@ bool_t MidiInitializeReceiverCtx(midi_rx_ctx_t *rx_ctx);
 size_t MidiReceiveData(
   midi_rx_ctx_t *rx_ctx, uint8_t const *data, size_t data_size,
   midi_message_t *message);
+/* Same as MidiReceiveData(), where |timestamps| holds the receive
+ * timestamp of each byte of |data|.  The timestamp of the first byte
+ * of a received message (its status byte, or first data byte for
+ * running status) is stored in |rx_ctx->timestamp|, and is passed to
+ * the callbacks for realtime messages. */
+size_t MidiReceiveTimestampedData(
+  midi_rx_ctx_t *rx_ctx, uint8_t const *data,
+  midi_timestamp_t const *timestamps, size_t data_size,
+  midi_message_t *message);
+/* Consumes bytes from |data| until either |data_size| bytes have been
+ * consumed or |max_messages| messages have been received.  Received
+ * messages are stored in order in |messages|.
+ * Returns the number of messages stored in |messages|.  If |consumed|
+ * is not NULL, it is set to the number of bytes consumed from |data|.
+ * Any bytes of an incomplete message are kept by the receiver, and
+ * are counted as consumed. */
+size_t MidiReceiveDataBatch(
+  midi_rx_ctx_t *rx_ctx, uint8_t const *data, size_t data_size,
+  midi_message_t *messages, size_t max_messages, size_t *consumed);
+
+/*
+ *  Compact Receiver Context
+ *    A byte-at-a-time receiver which produces midi_compact_message_t.
+ *    Handles running status and realtime bytes between data bytes.
+ *    System Exclusive messages are skipped, use midi_rx_ctx_t to
+ *    receive SysEx data.  Small enough to be used directly from a
+ *    serial interrupt.
+ */
+typedef struct {
+  midi_status_t status;
+  /* Number of data bytes required by |status|. */
+  uint8_t data_size;
+  uint8_t data_count;
+  uint8_t data[2];
+  /* Optional, not owned by the receiver. */
+  midi_callbacks_t *callbacks;
+} midi_compact_rx_ctx_t;
+
+/* |callbacks| may be NULL.  If provided, each received message is
+ * passed to the OnCompactMessage() callback, and channel messages on
+ * channels outside of the callbacks' |channel_mask| are skipped. */
+bool_t MidiInitializeCompactReceiverCtx(
+  midi_compact_rx_ctx_t *rx_ctx, midi_callbacks_t *callbacks);
+/* Returns true if |byte| completed a message, which is stored in
+ * |message|. */
+bool_t MidiReceiveCompactByte(
+  midi_compact_rx_ctx_t *rx_ctx, uint8_t byte,
+  midi_compact_message_t *message);
+/* Consumes bytes from |data| until either |data_size| bytes have been
+ * consumed or |max_messages| messages have been received.  Same
+ * conventions as MidiReceiveDataBatch(). */
+size_t MidiReceiveCompactData(
+  midi_compact_rx_ctx_t *rx_ctx, uint8_t const *data, size_t data_size,
+  midi_compact_message_t *messages, size_t max_messages, size_t *consumed);
 
 /*
  *  Transmitter Context
@@ -55,6 +166,9 @@ size_t MidiTransmitterSerializeMessage(
 size_t MidiTransmitterSerializeMessages(
   midi_tx_ctx_t *tx_ctx, midi_message_t const *messages, size_t message_count,
   uint8_t *data, size_t data_size);
+size_t MidiTransmitterSerializeCompactMessage(
+  midi_tx_ctx_t *tx_ctx, midi_compact_message_t const *compact,
+  uint8_t *data, size_t data_size);
 
 C_SECTION_END;
 
@@ -0,0 +1,156 @@
+/*
+ * MIDI Controller - MIDI Transmitter Priority Lanes
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <string.h>
+
+#include "midi_callback_internal.h"
+#include "midi_defs.h"
+#include "midi_serialize.h"
+#include "midi_tx_lanes.h"
+
+bool_t MidiInitializeTxLanes(
+    midi_tx_lanes_t *lanes, midi_tx_ctx_t *tx_ctx,
+    midi_callbacks_t *callbacks, uint32_t max_voice_latency_ms) {
+  if (lanes == NULL) return false;
+  memset(lanes, 0, sizeof(midi_tx_lanes_t));
+  if (!MidiInitializeTxQueue(
+      &lanes->voice, tx_ctx, callbacks, max_voice_latency_ms)) {
+    return false;
+  }
+  lanes->tx_ctx = tx_ctx;
+  lanes->callbacks = callbacks;
+  return true;
+}
+
+static void MidiTxLaneQueued(midi_tx_lane_stats_t *stats, uint16_t depth) {
+  ++stats->queued;
+  stats->depth = depth;
+  if (depth > stats->max_depth) stats->max_depth = depth;
+}
+
+static void MidiTxLaneWritten(
+    midi_tx_lane_stats_t *stats, uint32_t count, uint16_t depth,
+    uint32_t latency_ms) {
+  stats->written += count;
+  stats->depth = depth;
+  stats->last_latency_ms = latency_ms;
+  if (latency_ms > stats->max_latency_ms) stats->max_latency_ms = latency_ms;
+}
+
+static void MidiTxLanesFlushVoice(midi_tx_lanes_t *lanes, uint32_t now_ms) {
+  size_t const count = MidiTxQueueCount(&lanes->voice);
+  if (count == 0) return;
+  uint32_t const latency_ms = now_ms - lanes->voice.first_ms;
+  MidiTxQueueFlush(&lanes->voice);
+  MidiTxLaneWritten(
+      &lanes->stats[MIDI_TX_LANE_VOICE], count, 0, latency_ms);
+}
+
+/* Writes up to |max_size| bytes of the head bulk packet. */
+static void MidiTxLanesWriteBulk(
+    midi_tx_lanes_t *lanes, size_t max_size, uint32_t now_ms) {
+  if (lanes->bulk_count == 0) return;
+  midi_tx_bulk_packet_t const *packet = &lanes->bulk[lanes->bulk_head];
+  midi_tx_lane_stats_t *stats = &lanes->stats[MIDI_TX_LANE_BULK];
+  size_t const remaining = packet->size - lanes->bulk_offset;
+  size_t const size = (remaining < max_size) ? remaining : max_size;
+  if (lanes->bulk_offset == 0) {
+    /* Transmitter running status is broken by the SysEx. */
+    lanes->tx_ctx->status = MIDI_NONE;
+    stats->last_latency_ms = now_ms - packet->queued_ms;
+    if (stats->last_latency_ms > stats->max_latency_ms) {
+      stats->max_latency_ms = stats->last_latency_ms;
+    }
+  }
+  MidiCallOnWriteDataCallback(
+      lanes->callbacks, NULL, NULL, &packet->data[lanes->bulk_offset], size);
+  lanes->bulk_offset += size;
+  if (lanes->bulk_offset < packet->size) return;
+  /* Packet complete. */
+  lanes->bulk_offset = 0;
+  lanes->bulk_head = (lanes->bulk_head + 1) % MIDI_TX_BULK_LANE_SIZE;
+  --lanes->bulk_count;
+  ++stats->written;
+  stats->depth = lanes->bulk_count;
+}
+
+static bool_t MidiTxLanesWriteRealtime(
+    midi_tx_lanes_t *lanes, midi_message_t const *message) {
+  uint8_t const status = message->type;
+  midi_tx_lane_stats_t *stats = &lanes->stats[MIDI_TX_LANE_REALTIME];
+  MidiTxLaneQueued(stats, 1);
+  if (!MidiCallOnWriteRealtimeCallback(
+      lanes->callbacks, NULL, message, &status, 1)) {
+    stats->depth = 0;
+    return false;
+  }
+  MidiTxLaneWritten(stats, 1, 0, 0);
+  return true;
+}
+
+bool_t MidiTxLanesEnqueue(
+    midi_tx_lanes_t *lanes, midi_message_t const *message, uint32_t now_ms) {
+  if (lanes == NULL || !MidiIsValidMessage(message)) return false;
+  if (MidiIsRealtimeStatus(message->type)) {
+    return MidiTxLanesWriteRealtime(lanes, message);
+  }
+  midi_tx_queue_t *voice = &lanes->voice;
+  if (!MidiTxQueueHasRoom(voice, message)) {
+    /* Voice data cannot be written within a bulk packet; the caller
+     * must poll until the packet is complete and retry. */
+    if (lanes->bulk_offset > 0) return false;
+    MidiTxLanesFlushVoice(lanes, now_ms);
+  }
+  if (!MidiTxQueueEnqueue(voice, message, now_ms)) return false;
+  MidiTxLaneQueued(
+      &lanes->stats[MIDI_TX_LANE_VOICE], MidiTxQueueCount(voice));
+  return true;
+}
+
+bool_t MidiTxLanesEnqueueBulk(
+    midi_tx_lanes_t *lanes, uint8_t const *data, size_t data_size,
+    uint32_t now_ms) {
+  if (lanes == NULL || data == NULL || data_size < 2) return false;
+  if (data[0] != MIDI_SYSTEM_EXCLUSIVE ||
+      data[data_size - 1] != MIDI_END_SYSTEM_EXCLUSIVE) return false;
+  if (lanes->bulk_count == MIDI_TX_BULK_LANE_SIZE) return false;
+  size_t const index =
+      (lanes->bulk_head + lanes->bulk_count) % MIDI_TX_BULK_LANE_SIZE;
+  lanes->bulk[index].data = data;
+  lanes->bulk[index].size = data_size;
+  lanes->bulk[index].queued_ms = now_ms;
+  ++lanes->bulk_count;
+  MidiTxLaneQueued(&lanes->stats[MIDI_TX_LANE_BULK], lanes->bulk_count);
+  return true;
+}
+
+void MidiTxLanesPoll(midi_tx_lanes_t *lanes, uint32_t now_ms) {
+  if (lanes == NULL) return;
+  if (lanes->bulk_offset == 0) {
+    /* Between bulk packets; voice goes first.  If there is no bulk
+     * data waiting, voice data is allowed to coalesce. */
+    if (lanes->bulk_count > 0 ||
+        (now_ms - lanes->voice.first_ms) >= lanes->voice.max_latency_ms) {
+      MidiTxLanesFlushVoice(lanes, now_ms);
+    }
+  }
+  MidiTxLanesWriteBulk(lanes, MIDI_TX_BULK_CHUNK_SIZE, now_ms);
+}
+
+bool_t MidiTxLanesIsIdle(midi_tx_lanes_t const *lanes) {
+  if (lanes == NULL) return true;
+  return MidiTxQueueIsEmpty(&lanes->voice) && lanes->bulk_count == 0;
+}
+
+bool_t MidiGetTxLaneStats(
+    midi_tx_lanes_t const *lanes, midi_tx_lane_t lane,
+    midi_tx_lane_stats_t *stats) {
+  if (lanes == NULL || stats == NULL) return false;
+  if (lane >= MIDI_TX_LANE_COUNT) return false;
+  memcpy(stats, &lanes->stats[lane], sizeof(midi_tx_lane_stats_t));
+  return true;
+}
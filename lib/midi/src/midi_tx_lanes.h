@@ -0,0 +1,107 @@
+/*
+ * MIDI Controller - MIDI Transmitter Priority Lanes
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MIDI_TX_LANES_H_
+#define _MIDI_TX_LANES_H_
+
+#include "base.h"
+#include "midi_callback.h"
+#include "midi_message.h"
+#include "midi_transceiver.h"
+#include "midi_tx_queue.h"
+
+C_SECTION_BEGIN;
+
+/* Maximum number of bulk packets waiting to be sent. */
+#ifndef MIDI_TX_BULK_LANE_SIZE
+#define MIDI_TX_BULK_LANE_SIZE 4
+#endif
+
+/* Maximum number of bulk bytes written per MidiTxLanesPoll().  At
+ * 31.25 kbaud, each byte takes 320 us. */
+#ifndef MIDI_TX_BULK_CHUNK_SIZE
+#define MIDI_TX_BULK_CHUNK_SIZE 16
+#endif
+
+/* Transmitter lanes, from highest to lowest priority. */
+#define MIDI_TX_LANE_REALTIME   0
+#define MIDI_TX_LANE_VOICE      1
+#define MIDI_TX_LANE_BULK       2
+#define MIDI_TX_LANE_COUNT      3
+typedef uint8_t midi_tx_lane_t;
+
+typedef struct {
+  /* Total number of items queued and written in the lane.  Items are
+   * messages, except for the bulk lane, where items are packets. */
+  uint32_t queued;
+  uint32_t written;
+  /* Number of items currently waiting in the lane. */
+  uint16_t depth;
+  uint16_t max_depth;
+  /* Time, in ms, that the oldest item of the last write waited. */
+  uint32_t last_latency_ms;
+  uint32_t max_latency_ms;
+} midi_tx_lane_stats_t;
+
+typedef struct {
+  uint8_t const *data;
+  size_t size;
+  uint32_t queued_ms;
+} midi_tx_bulk_packet_t;
+
+/*
+ *  MIDI Transmitter Lanes.
+ *    Realtime: System realtime messages are written immediately using
+ *      the WriteRealtime() callback (if set), which may place them
+ *      between the bytes of any in-progress message.
+ *    Voice: All other messages are passed through a coalescing
+ *      midi_tx_queue_t.  Voice messages are written between bulk
+ *      packets, never within them.
+ *    Bulk: Complete, pre-serialized System Exclusive packets (0xF0 to
+ *      0xF7) which are written MIDI_TX_BULK_CHUNK_SIZE bytes per poll.
+ *      The packet data is not copied and must remain valid until
+ *      the packet has been written.
+ */
+typedef struct {
+  midi_tx_ctx_t *tx_ctx;
+  midi_callbacks_t *callbacks;
+  midi_tx_queue_t voice;
+  midi_tx_bulk_packet_t bulk[MIDI_TX_BULK_LANE_SIZE];
+  size_t bulk_head;
+  size_t bulk_count;
+  /* Bytes of the head bulk packet already written. */
+  size_t bulk_offset;
+  midi_tx_lane_stats_t stats[MIDI_TX_LANE_COUNT];
+} midi_tx_lanes_t;
+
+bool_t MidiInitializeTxLanes(
+  midi_tx_lanes_t *lanes, midi_tx_ctx_t *tx_ctx,
+  midi_callbacks_t *callbacks, uint32_t max_voice_latency_ms);
+
+/* Realtime messages are written immediately, all others are queued
+ * in the voice lane.  If the voice lane is full while a bulk packet is
+ * partly written, the message is not queued and false is returned;
+ * MidiTxLanesPoll() must be called until the packet is complete before
+ * retrying. */
+bool_t MidiTxLanesEnqueue(
+  midi_tx_lanes_t *lanes, midi_message_t const *message, uint32_t now_ms);
+bool_t MidiTxLanesEnqueueBulk(
+  midi_tx_lanes_t *lanes, uint8_t const *data, size_t data_size,
+  uint32_t now_ms);
+
+/* Must be called regularly, writes pending voice and bulk data. */
+void MidiTxLanesPoll(midi_tx_lanes_t *lanes, uint32_t now_ms);
+
+bool_t MidiTxLanesIsIdle(midi_tx_lanes_t const *lanes);
+
+bool_t MidiGetTxLaneStats(
+  midi_tx_lanes_t const *lanes, midi_tx_lane_t lane,
+  midi_tx_lane_stats_t *stats);
+
+C_SECTION_END;
+
+#endif  /* _MIDI_TX_LANES_H_ */
@@ -0,0 +1,105 @@
+/*
+ * MIDI Controller - MIDI Transmitter Queue
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <string.h>
+
+#include "midi_callback_internal.h"
+#include "midi_defs.h"
+#include "midi_serialize.h"
+#include "midi_tx_queue.h"
+
+/* Flushing tracks sent messages in a 32-bit set. */
+#if MIDI_TX_QUEUE_SIZE > 32
+# error "MIDI_TX_QUEUE_SIZE must not be larger than 32"
+#endif
+
+bool_t MidiInitializeTxQueue(
+    midi_tx_queue_t *queue, midi_tx_ctx_t *tx_ctx,
+    midi_callbacks_t *callbacks, uint32_t max_latency_ms) {
+  if (queue == NULL || tx_ctx == NULL) return false;
+  if (!MidiIsValidCallbacks(callbacks)) return false;
+  if (callbacks->tx.WriteData == NULL) return false;
+  memset(queue, 0, sizeof(midi_tx_queue_t));
+  queue->tx_ctx = tx_ctx;
+  queue->callbacks = callbacks;
+  queue->max_latency_ms = max_latency_ms;
+  return true;
+}
+
+static bool_t MidiTxQueueHasRoomForSize(
+    midi_tx_queue_t const *queue, size_t message_size) {
+  return queue->count < MIDI_TX_QUEUE_SIZE &&
+      (queue->pending_size + message_size) <= MIDI_TX_QUEUE_BUFFER_SIZE;
+}
+
+bool_t MidiTxQueueHasRoom(
+    midi_tx_queue_t const *queue, midi_message_t const *message) {
+  if (queue == NULL || !MidiIsValidMessage(message)) return false;
+  size_t const message_size = MidiSerializeMessage(message, false, NULL, 0);
+  if (message_size == 0) return false;
+  return MidiTxQueueHasRoomForSize(queue, message_size);
+}
+
+bool_t MidiTxQueueEnqueue(
+    midi_tx_queue_t *queue, midi_message_t const *message, uint32_t now_ms) {
+  if (queue == NULL || !MidiIsValidMessage(message)) return false;
+  size_t const message_size = MidiSerializeMessage(message, false, NULL, 0);
+  if (message_size == 0 || message_size > MIDI_TX_QUEUE_BUFFER_SIZE)
+    return false;
+  if (!MidiTxQueueHasRoomForSize(queue, message_size)) {
+    MidiTxQueueFlush(queue);
+  }
+  if (queue->count == 0) queue->first_ms = now_ms;
+  memcpy(&queue->messages[queue->count++], message, sizeof(midi_message_t));
+  queue->pending_size += message_size;
+  return true;
+}
+
+bool_t MidiTxQueuePoll(midi_tx_queue_t *queue, uint32_t now_ms) {
+  if (queue == NULL || queue->count == 0) return false;
+  /* Unsigned difference handles wrap around. */
+  if ((now_ms - queue->first_ms) < queue->max_latency_ms) return false;
+  MidiTxQueueFlush(queue);
+  return true;
+}
+
+static size_t MidiTxQueueSerializeMessage(
+    midi_tx_queue_t *queue, midi_message_t const *message, size_t di) {
+  return MidiTransmitterSerializeMessage(
+      queue->tx_ctx, message, &queue->buffer[di],
+      MIDI_TX_QUEUE_BUFFER_SIZE - di);
+}
+
+size_t MidiTxQueueFlush(midi_tx_queue_t *queue) {
+  if (queue == NULL || queue->count == 0) return 0;
+  /* Bit set for each message that has been serialized. */
+  uint32_t sent = 0;
+  size_t di = 0;
+  for (size_t i = 0; i < queue->count; ++i) {
+    if (sent & (1ul << i)) continue;
+    midi_message_t const *message = &queue->messages[i];
+    di += MidiTxQueueSerializeMessage(queue, message, di);
+    sent |= (1ul << i);
+    if (!MidiIsChannelMessageType(message->type)) continue;
+    /* Pull forward later messages with the same status, stopping at
+     * the first system message or other message of the same channel. */
+    for (size_t j = i + 1; j < queue->count; ++j) {
+      if (sent & (1ul << j)) continue;
+      midi_message_t const *next = &queue->messages[j];
+      if (!MidiIsChannelMessageType(next->type)) break;
+      if (next->channel != message->channel) continue;
+      if (next->type != message->type) break;
+      di += MidiTxQueueSerializeMessage(queue, next, di);
+      sent |= (1ul << j);
+    }
+  }
+  queue->count = 0;
+  queue->pending_size = 0;
+  MidiCallOnWriteDataCallback(
+      queue->callbacks, NULL, NULL, queue->buffer, di);
+  return di;
+}
@@ -0,0 +1,91 @@
+/*
+ * MIDI Controller - MIDI Transmitter Queue
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MIDI_TX_QUEUE_H_
+#define _MIDI_TX_QUEUE_H_
+
+#include "base.h"
+#include "midi_callback.h"
+#include "midi_message.h"
+#include "midi_transceiver.h"
+
+C_SECTION_BEGIN;
+
+/* Maximum number of messages held by the queue. */
+#ifndef MIDI_TX_QUEUE_SIZE
+#define MIDI_TX_QUEUE_SIZE 16
+#endif
+
+/* Maximum number of bytes written in a single flush.  Messages which
+ * serialize to more than this cannot be queued. */
+#ifndef MIDI_TX_QUEUE_BUFFER_SIZE
+#define MIDI_TX_QUEUE_BUFFER_SIZE 64
+#endif
+
+/*
+ *  MIDI Transmitter Queue.
+ *    Accumulates messages from any number of producers and writes
+ *    them out in a single WriteData() call when flushed.
+ *
+ *    On flush, channel messages with the same status are grouped
+ *    together to make the best use of the transmitter's running
+ *    status.  A message is only moved ahead of messages from other
+ *    channels; messages of the same channel are always sent in the
+ *    order they were queued.  System messages are never reordered,
+ *    and no message is moved across a system message.
+ *
+ *    The queue is flushed when:
+ *      - A message does not fit in the queue,
+ *      - The oldest queued message has waited |max_latency_ms|,
+ *        checked by MidiTxQueuePoll(),
+ *      - MidiTxQueueFlush() is called.
+ */
+typedef struct {
+  /* Not owned by the queue. */
+  midi_tx_ctx_t *tx_ctx;
+  midi_callbacks_t *callbacks;
+  midi_message_t messages[MIDI_TX_QUEUE_SIZE];
+  size_t count;
+  /* Worst case serialized size (no running status) of the queued
+   * messages. */
+  size_t pending_size;
+  /* Time at which the oldest queued message was queued. */
+  uint32_t first_ms;
+  uint32_t max_latency_ms;
+  uint8_t buffer[MIDI_TX_QUEUE_BUFFER_SIZE];
+} midi_tx_queue_t;
+
+/* The |callbacks| must provide a WriteData() callback. */
+bool_t MidiInitializeTxQueue(
+  midi_tx_queue_t *queue, midi_tx_ctx_t *tx_ctx,
+  midi_callbacks_t *callbacks, uint32_t max_latency_ms);
+
+#define MidiTxQueueCount(queue) ((queue)->count)
+#define MidiTxQueueIsEmpty(queue) ((queue)->count == 0)
+
+/* Returns true if |message| can be queued without first flushing the
+ * queued messages.  Returns false if the queue is full, or if the
+ * message is invalid or too large to ever be queued. */
+bool_t MidiTxQueueHasRoom(
+  midi_tx_queue_t const *queue, midi_message_t const *message);
+
+/* Queues a copy of |message|.  |now_ms| is any monotonic millisecond
+ * time used only for the latency flush.  May flush the queue to make
+ * room.  Returns false if the message is invalid or too large. */
+bool_t MidiTxQueueEnqueue(
+  midi_tx_queue_t *queue, midi_message_t const *message, uint32_t now_ms);
+
+/* Flushes the queue if the oldest message has been waiting for at
+ * least |max_latency_ms|.  Returns true if flushed. */
+bool_t MidiTxQueuePoll(midi_tx_queue_t *queue, uint32_t now_ms);
+
+/* Writes all queued messages.  Returns the number of bytes written. */
+size_t MidiTxQueueFlush(midi_tx_queue_t *queue);
+
+C_SECTION_END;
+
+#endif  /* _MIDI_TX_QUEUE_H_ */
@@ -8,12 +8,15 @@
 #ifdef _PLATFORM_NATIVE
 
 #include <errno.h>
+#include <signal.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
 
 #include "logging.h"
 
 #include "system_interrupt.h"
+#include "system_sleep.h"
 #include "system_storage.h"
 #include "system_time.h"
 
@@ -26,9 +29,19 @@
 static uint8_t sNativeStorage[NATIVE_STORAGE_SIZE];
 static bool_t sNativeStorageInitialized = false;
 
-/* System Time. */
-bool_t SystemTimeNow(system_time_t *system_time) {
-  if (system_time == NULL) return false;
+/* System Time.
+ *  The native clock is either CLOCK_MONOTONIC or a virtual clock, which
+ *  only moves when advanced. */
+#define NATIVE_NS_PER_SECOND 1000000000ull
+
+static bool_t gVirtualClock = false;
+static uint64_t gVirtualClockNs = 0;
+
+static bool_t NativeClockNow(uint64_t *ns) {
+  if (gVirtualClock) {
+    *ns = gVirtualClockNs;
+    return true;
+  }
   struct timespec ts;
   if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
     int const err = errno;
@@ -39,13 +52,75 @@ bool_t SystemTimeNow(system_time_t *system_time) {
     }
     return false;
   }
-  system_time->seconds = ts.tv_sec;
-  system_time->nanoseconds = ts.tv_nsec;
+  *ns = ((uint64_t) ts.tv_sec) * NATIVE_NS_PER_SECOND + ts.tv_nsec;
+  return true;
+}
+
+bool_t SystemTimeNow(system_time_t *system_time) {
+  if (system_time == NULL) return false;
+  uint64_t ns;
+  if (!NativeClockNow(&ns)) return false;
+  system_time->seconds = ns / NATIVE_NS_PER_SECOND;
+  system_time->nanoseconds = ns % NATIVE_NS_PER_SECOND;
   LOG_DEBUG(
       "Now: time = %u.%09u", system_time->seconds, system_time->nanoseconds);
   return true;
 }
 
+/* The native timestamp has the resolution of the 16 MHz ATmega328P. */
+#define NATIVE_TIMESTAMP_RESOLUTION_NS 25000u
+
+system_timestamp_t SystemTimestamp(void) {
+  uint64_t ns;
+  if (!NativeClockNow(&ns)) return 0;
+  return (system_timestamp_t) (ns / NATIVE_TIMESTAMP_RESOLUTION_NS);
+}
+
+uint32_t SystemTimestampResolution(void) {
+  return NATIVE_TIMESTAMP_RESOLUTION_NS;
+}
+
+system_ticks_t SystemTicksNow(void) {
+  uint64_t ns;
+  if (!NativeClockNow(&ns)) return 0;
+  return ns / SYSTEM_TICK_NS;
+}
+
+bool_t SystemTimeEnableVirtualClock(system_time_t const *start) {
+  if (start == NULL || start->nanoseconds >= NATIVE_NS_PER_SECOND) {
+    return false;
+  }
+  gVirtualClockNs =
+      ((uint64_t) start->seconds) * NATIVE_NS_PER_SECOND + start->nanoseconds;
+  gVirtualClock = true;
+  return true;
+}
+
+void SystemTimeDisableVirtualClock(void) {
+  gVirtualClock = false;
+}
+
+bool_t SystemTimeIsVirtualClock(void) {
+  return gVirtualClock;
+}
+
+bool_t SystemTimeAdvanceVirtualClock(uint32_t microseconds) {
+  if (!gVirtualClock) return false;
+  gVirtualClockNs += ((uint64_t) microseconds) * 1000u;
+  return true;
+}
+
+bool_t SystemTimeSetVirtualClock(system_time_t const *time) {
+  if (!gVirtualClock || time == NULL) return false;
+  if (time->nanoseconds >= NATIVE_NS_PER_SECOND) return false;
+  uint64_t const ns =
+      ((uint64_t) time->seconds) * NATIVE_NS_PER_SECOND + time->nanoseconds;
+  /* Monotonic. */
+  if (ns < gVirtualClockNs) return false;
+  gVirtualClockNs = ns;
+  return true;
+}
+
 void SystemTimeInitialize(void) {}
 
 /* Interrupts */
@@ -61,6 +136,57 @@ void SystemEnableInterrupt(void) {
   gSignalEnabled = true;
 }
 
+system_interrupt_state_t SystemSaveDisableInterrupt(void) {
+  system_interrupt_state_t const state = gSignalEnabled;
+  gSignalEnabled = false;
+  return state;
+}
+
+void SystemRestoreInterrupt(system_interrupt_state_t state) {
+  gSignalEnabled = state;
+}
+
+/* Sleep.  Signal handlers may call SystemWakeUp(), which interrupts the
+ * sleep with EINTR.  With the virtual clock, sleeping advances the clock
+ * to the deadline without waiting. */
+static volatile sig_atomic_t gWakeUp = 0;
+
+void SystemWakeUp(void) {
+  gWakeUp = 1;
+}
+
+bool_t SystemSleepUntil(system_time_t const *deadline) {
+  SystemEnableInterrupt();
+  if (gVirtualClock) {
+    if (gWakeUp || deadline == NULL) {
+      gWakeUp = 0;
+      return false;
+    }
+    SystemTimeSetVirtualClock(deadline);
+    return true;
+  }
+  struct timespec ts;
+  if (deadline != NULL) {
+    ts.tv_sec = deadline->seconds;
+    ts.tv_nsec = deadline->nanoseconds;
+  }
+  while (!gWakeUp) {
+    if (deadline == NULL) {
+      pause();
+      continue;
+    }
+    int const res = clock_nanosleep(
+        CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+    if (res == 0) return true;
+    if (res != EINTR) {
+      LOG_ERROR("Unknown error: clock_nanosleep() = %d", res);
+      return true;
+    }
+  }
+  gWakeUp = 0;
+  return false;
+}
+
 /* System Storage. */
 
 size_t SystemStorageSize(void) {
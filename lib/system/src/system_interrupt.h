@@ -10,8 +10,17 @@
 
 #ifdef _PLATFORM_AVR
 #include <avr/interrupt.h>
+#include <avr/io.h>
+#include "base.h"
 #define SystemDisableInterrupt() cli()
 #define SystemEnableInterrupt() sei()
+typedef uint8_t system_interrupt_state_t;
+static inline system_interrupt_state_t SystemSaveDisableInterrupt(void) {
+  uint8_t const sreg = SREG;
+  cli();
+  return sreg;
+}
+#define SystemRestoreInterrupt(state) (SREG = (state))
 #else  /* else !_PLATFORM_AVR */
 #include "base.h"
 C_SECTION_BEGIN;
@@ -21,6 +30,12 @@ C_SECTION_BEGIN;
  */
 void SystemDisableInterrupt(void);
 void SystemEnableInterrupt(void);
+/* Disables global interrupts, returning the previous state to be passed
+ * to SystemRestoreInterrupt().  Unlike the above, these may be called
+ * from within an interrupt. */
+typedef bool_t system_interrupt_state_t;
+system_interrupt_state_t SystemSaveDisableInterrupt(void);
+void SystemRestoreInterrupt(system_interrupt_state_t state);
 C_SECTION_END;
 #endif  /* not _PLATFORM_AVR */
 
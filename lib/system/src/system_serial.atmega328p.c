@@ -11,8 +11,10 @@
 #include <avr/interrupt.h>
 #include <avr/io.h>
 
-#include "byte_buffer.h"
+#include "byte_ring.h"
 #include "system_serial.h"
+#include "system_sleep.h"
+#include "system_time.h"
 
 /*
  *  ATmega328 Serial
@@ -82,37 +84,129 @@
 #define SYSTEM_TX_SIZE  128
 #endif
 
+/* Number of receive timestamps which can be waiting to be read. */
+#ifndef SYSTEM_RX_TIMESTAMP_SIZE
+#define SYSTEM_RX_TIMESTAMP_SIZE  16
+#endif
+
+#ifndef SYSTEM_TX_REALTIME_SIZE
+#define SYSTEM_TX_REALTIME_SIZE  8
+#endif
+
+/* The buffers are byte rings, shared between the USART interrupts and
+ * the main loop without disabling interrupts. */
+#if (SYSTEM_RX_SIZE & (SYSTEM_RX_SIZE - 1)) != 0 || \
+    SYSTEM_RX_SIZE > BYTE_RING_MAX_CAPACITY
+#error SYSTEM_RX_SIZE must be a power of two, at most 128
+#endif
+#if (SYSTEM_RX_TIMESTAMP_SIZE & (SYSTEM_RX_TIMESTAMP_SIZE - 1)) != 0 || \
+    SYSTEM_RX_TIMESTAMP_SIZE > 128
+#error SYSTEM_RX_TIMESTAMP_SIZE must be a power of two, at most 128
+#endif
+#if (SYSTEM_TX_SIZE & (SYSTEM_TX_SIZE - 1)) != 0 || \
+    SYSTEM_TX_SIZE > BYTE_RING_MAX_CAPACITY
+#error SYSTEM_TX_SIZE must be a power of two, at most 128
+#endif
+#if (SYSTEM_TX_REALTIME_SIZE & (SYSTEM_TX_REALTIME_SIZE - 1)) != 0 || \
+    SYSTEM_TX_REALTIME_SIZE > BYTE_RING_MAX_CAPACITY
+#error SYSTEM_TX_REALTIME_SIZE must be a power of two, at most 128
+#endif
+
 static uint8_t sSystemRxData[SYSTEM_RX_SIZE];
-static byte_buffer_t sSystemRxBuffer;
+static byte_ring_t sSystemRxBuffer;
+
+/* Receive timestamps.
+ *  The receive interrupt stamps each byte which starts a MIDI message:
+ *  status bytes, and the first data byte of a running status message.
+ *  Each timestamp is stored with the position of its byte in the
+ *  receive stream (modulo 256), which is matched by the reader.  Bytes
+ *  without a timestamp (if the timestamp queue was full) are given the
+ *  timestamp of the previous byte.  Like the byte rings, a single
+ *  producer (the interrupt) and consumer are supported. */
+static system_timestamp_t sSystemRxTimestamps[SYSTEM_RX_TIMESTAMP_SIZE];
+static uint8_t sSystemRxTimestampPositions[SYSTEM_RX_TIMESTAMP_SIZE];
+static volatile uint8_t sSystemRxTimestampHead = 0;
+static volatile uint8_t sSystemRxTimestampTail = 0;
+/* Receive stream positions of the next byte written and read. */
+static uint8_t sSystemRxWritePosition = 0;
+static uint8_t sSystemRxReadPosition = 0;
+static system_timestamp_t sSystemRxLastTimestamp = 0;
+/* Data bytes expected by the running status, and remaining in the
+ * current message. */
+static uint8_t sSystemRxRunningSize = 0;
+static uint8_t sSystemRxRemaining = 0;
+
+#define SYSTEM_RX_TIMESTAMP_MASK (SYSTEM_RX_TIMESTAMP_SIZE - 1)
 
 static uint8_t sSystemTxData[SYSTEM_TX_SIZE];
-static byte_buffer_t sSystemTxBuffer;
+static byte_ring_t sSystemTxBuffer;
+
+/* Realtime bytes are always transmitted before the standard Tx data. */
+static uint8_t sSystemTxRealtimeData[SYSTEM_TX_REALTIME_SIZE];
+static byte_ring_t sSystemTxRealtimeBuffer;
 
 static bool_t sSystemSerialInitialized = false;
 
+/* Returns true if |data| starts a MIDI message.  Only tracks enough
+ * state to find running status messages. */
+static inline bool_t SystemSerialRxIsMessageStart(uint8_t data) {
+  if (data >= 0xF8) return true;  /* Realtime, no state change. */
+  if (data >= 0xF0) {
+    /* System common and SysEx cancel running status. */
+    sSystemRxRunningSize = 0;
+    sSystemRxRemaining = 0;
+    return true;
+  }
+  if (data & 0x80) {
+    /* Program change and channel pressure have one data byte. */
+    sSystemRxRunningSize = ((data & 0xE0) == 0xC0) ? 1 : 2;
+    sSystemRxRemaining = sSystemRxRunningSize;
+    return true;
+  }
+  bool_t const start = (sSystemRxRemaining == 0 && sSystemRxRunningSize > 0);
+  if (start) sSystemRxRemaining = sSystemRxRunningSize;
+  if (sSystemRxRemaining > 0) --sSystemRxRemaining;
+  return start;
+}
+
 ISR(USART_RX_vect) {
+  SystemWakeUp();
   while (UCSR0A & _BV(RXC0)) {
     uint8_t const data = UDR0;
-    ByteBufferEnqueueByte(&sSystemRxBuffer, data);
+    if (!ByteRingEnqueueByte(&sSystemRxBuffer, data)) continue;
+    uint8_t const position = sSystemRxWritePosition++;
+    if (!SystemSerialRxIsMessageStart(data)) continue;
+    uint8_t const head = sSystemRxTimestampHead;
+    if ((uint8_t) (head - sSystemRxTimestampTail) >= SYSTEM_RX_TIMESTAMP_SIZE)
+      continue;
+    sSystemRxTimestamps[head & SYSTEM_RX_TIMESTAMP_MASK] = SystemTimestamp();
+    sSystemRxTimestampPositions[head & SYSTEM_RX_TIMESTAMP_MASK] = position;
+    sSystemRxTimestampHead = head + 1;
   }
 }
 
 ISR(USART_UDRE_vect) {
-  if (ByteBufferIsEmpty(&sSystemTxBuffer)) {
+  uint8_t data = 0x00;
+  if (ByteRingDequeueByte(&sSystemTxRealtimeBuffer, &data)) {
+    UDR0 = data;
+    return;
+  }
+  if (!ByteRingDequeueByte(&sSystemTxBuffer, &data)) {
     /* If no data to transmit, disable interrupt. */
     UCSR0B &= ~_BV(UDRIE0);
     return;
   }
-  uint8_t data = 0x00;
-  if (!ByteBufferDequeueByte(&sSystemTxBuffer, &data)) return;
   UDR0 = data;
 }
 
 void SystemSerialInitialize(void) {
   if (sSystemSerialInitialized) return;
   cli();
-  ByteBufferInitialize(&sSystemRxBuffer, sSystemRxData, SYSTEM_RX_SIZE);
-  ByteBufferInitialize(&sSystemTxBuffer, sSystemTxData, SYSTEM_TX_SIZE);
+  ByteRingInitialize(&sSystemRxBuffer, sSystemRxData, SYSTEM_RX_SIZE);
+  ByteRingInitialize(&sSystemTxBuffer, sSystemTxData, SYSTEM_TX_SIZE);
+  ByteRingInitialize(
+      &sSystemTxRealtimeBuffer, sSystemTxRealtimeData,
+      SYSTEM_TX_REALTIME_SIZE);
   /* Baud Rate Counter */
   UBRR0 = USART_COUNTER;
   /* Control Register A */
@@ -127,26 +221,70 @@ void SystemSerialInitialize(void) {
 
 size_t SystemSerialWrite(uint8_t const *data, size_t count) {
   if (data == NULL || count == 0 || !sSystemSerialInitialized) return 0;
-  cli();
-  size_t const queued = ByteBufferEnqueueBytes(&sSystemTxBuffer, data, count);
+  size_t const queued = ByteRingEnqueueBytes(&sSystemTxBuffer, data, count);
+  /* If the UDRE interrupt disables itself between the read and write
+   * of UCSR0B, it is re-enabled here, which is the desired result. */
   UCSR0B |= _BV(UDRIE0);
-  sei();
   return queued;
 }
 
+size_t SystemSerialWriteRealtime(uint8_t const *data, size_t count) {
+  if (data == NULL || count == 0 || !sSystemSerialInitialized) return 0;
+  size_t const queued = ByteRingEnqueueBytes(
+      &sSystemTxRealtimeBuffer, data, count);
+  UCSR0B |= _BV(UDRIE0);
+  return queued;
+}
+
+size_t SystemSerialWritePending(void) {
+  if (!sSystemSerialInitialized) return 0;
+  return ByteRingSize(&sSystemTxBuffer) +
+      ByteRingSize(&sSystemTxRealtimeBuffer);
+}
+
+/* Dequeues up to |data_size| received bytes, advancing the read
+ * position and dropping the timestamps of the bytes passed, so that
+ * SystemSerialRead() and SystemSerialReadTimestamped() can be mixed
+ * freely.  |timestamps| may be NULL. */
+static size_t SystemSerialDequeue(
+    uint8_t *data, system_timestamp_t *timestamps, size_t data_size) {
+  size_t const count =
+      ByteRingDequeueBytes(&sSystemRxBuffer, data, data_size);
+  for (size_t i = 0; i < count; ++i) {
+    uint8_t const position = sSystemRxReadPosition++;
+    while (sSystemRxTimestampTail != sSystemRxTimestampHead) {
+      uint8_t const tail = sSystemRxTimestampTail & SYSTEM_RX_TIMESTAMP_MASK;
+      int8_t const ahead =
+          (int8_t) (sSystemRxTimestampPositions[tail] - position);
+      if (ahead > 0) break;
+      if (ahead == 0) sSystemRxLastTimestamp = sSystemRxTimestamps[tail];
+      ++sSystemRxTimestampTail;
+    }
+    if (timestamps != NULL) timestamps[i] = sSystemRxLastTimestamp;
+  }
+  return count;
+}
+
 size_t SystemSerialRead(uint8_t *data, size_t data_size) {
   if (data == NULL || data_size == 0 || !sSystemSerialInitialized) return 0;
-  cli();
-  size_t const dequeued = ByteBufferDequeueBytes(
-      &sSystemRxBuffer, data, data_size);
-  sei();
-  return dequeued;
+  return SystemSerialDequeue(data, NULL, data_size);
+}
+
+size_t SystemSerialReadTimestamped(
+    uint8_t *data, system_timestamp_t *timestamps, size_t data_size) {
+  if (data == NULL || timestamps == NULL || data_size == 0 ||
+      !sSystemSerialInitialized) {
+    return 0;
+  }
+  return SystemSerialDequeue(data, timestamps, data_size);
 }
 
 void SystemSerialFlush(void) {
   if (!sSystemSerialInitialized) return;
   cli();
-  ByteBufferClear(&sSystemRxBuffer);
+  ByteRingClear(&sSystemRxBuffer);
+  sSystemRxTimestampTail = sSystemRxTimestampHead;
+  sSystemRxReadPosition = sSystemRxWritePosition;
   sei();
 }
 
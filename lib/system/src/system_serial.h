@@ -9,6 +9,7 @@
 #define _SYSTEM_SERIAL_H_
 
 #include "base.h"
+#include "system_time.h"
 
 C_SECTION_BEGIN;
 
@@ -19,6 +20,24 @@ void SystemSerialInitialize(void);
 size_t SystemSerialWrite(uint8_t const *data, size_t count);
 size_t SystemSerialRead(uint8_t *data, size_t data_size);
 
+/* Same as SystemSerialRead(), but also stores the receive timestamp of
+ * each byte in |timestamps|, which must hold |data_size| entries.  Only
+ * bytes which start a MIDI message (status bytes and the first byte
+ * of a running status message) are stamped by the receive interrupt,
+ * other bytes are given the timestamp of the byte before them.
+ * Both read functions consume the same stream and may be mixed; bytes
+ * read with SystemSerialRead() have their timestamps dropped. */
+size_t SystemSerialReadTimestamped(
+  uint8_t *data, system_timestamp_t *timestamps, size_t data_size);
+
+/* Writes MIDI system realtime bytes ahead of any data pending from
+ * SystemSerialWrite().  Realtime bytes may be sent at any point in
+ * the MIDI stream, including within a System Exclusive message. */
+size_t SystemSerialWriteRealtime(uint8_t const *data, size_t count);
+
+/* Number of bytes waiting to be transmitted. */
+size_t SystemSerialWritePending(void);
+
 /* Flushes the read buffer. */
 void SystemSerialFlush(void);
 
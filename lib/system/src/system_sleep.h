@@ -0,0 +1,32 @@
+/*
+ * MIDI Controller - System Sleep
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _SYSTEM_SLEEP_H_
+#define _SYSTEM_SLEEP_H_
+
+#include "base.h"
+#include "system_time.h"
+
+C_SECTION_BEGIN;
+
+/* Puts the processor to sleep until the system time reaches |deadline|,
+ * or indefinitely if |deadline| is NULL.  Sleep ends early once
+ * SystemWakeUp() is called.
+ * Must be called with interrupts disabled, so that work signalled by an
+ * interrupt after the caller last checked is not missed.  Interrupts are
+ * enabled on return.
+ * Returns true if the deadline was reached, false if woken early.
+ * Implementation is platform specific. */
+bool_t SystemSleepUntil(system_time_t const *deadline);
+
+/* Ends the current (or next) SystemSleepUntil().  Safe to call from
+ * interrupts. */
+void SystemWakeUp(void);
+
+C_SECTION_END;
+
+#endif  /* _SYSTEM_SLEEP_H_ */
@@ -10,8 +10,10 @@
 
 #include <avr/interrupt.h>
 #include <avr/io.h>
+#include <avr/sleep.h>
 
 #include "base.h"
+#include "system_sleep.h"
 #include "system_time.h"
 
 /*
@@ -95,14 +97,30 @@
 #error "Unsupported CPU speed"
 #endif
 
+#if (RESOLUTION_NS % SYSTEM_TICK_NS) != 0
+#error "SYSTEM_TICK_NS must divide the timer resolution"
+#endif
+
 static system_time_t sSystemTime = {
   .seconds = 0,
   .nanoseconds = 0
 };
 
+/* Number of timer interrupts.  The timestamp is the low 16 bits, and
+ * the system ticks are derived from the count when read, keeping the
+ * interrupt to a single 32-bit increment.  The high word only changes
+ * when the count wraps around (every 29 hours at 40 kHz). */
+static volatile uint32_t sSystemInterruptCount = 0;
+static volatile uint32_t sSystemInterruptCountHigh = 0;
+
+#define SYSTEM_TICKS_PER_INTERRUPT (RESOLUTION_NS / SYSTEM_TICK_NS)
+
 static bool_t sSystemTimeInitialized = false;
 
 ISR(TIMER0_COMPA_vect) {
+  uint32_t const count = sSystemInterruptCount + 1;
+  sSystemInterruptCount = count;
+  if (count == 0) ++sSystemInterruptCountHigh;
   SystemTimeIncrementNanoseconds(&sSystemTime, RESOLUTION_NS);
 }
 
@@ -128,5 +146,66 @@ bool_t SystemTimeNow(system_time_t *time) {
   return true;
 }
 
+system_timestamp_t SystemTimestamp(void) {
+  /* May be called with interrupts already disabled. */
+  uint8_t const sreg = SREG;
+  cli();
+  system_timestamp_t const timestamp =
+      (system_timestamp_t) sSystemInterruptCount;
+  SREG = sreg;
+  return timestamp;
+}
+
+uint32_t SystemTimestampResolution(void) {
+  return RESOLUTION_NS;
+}
+
+system_ticks_t SystemTicksNow(void) {
+  /* May be called with interrupts already disabled. */
+  uint8_t const sreg = SREG;
+  cli();
+  uint32_t const count = sSystemInterruptCount;
+  uint32_t const count_high = sSystemInterruptCountHigh;
+  SREG = sreg;
+  return ((((system_ticks_t) count_high) << 32) | count) *
+      SYSTEM_TICKS_PER_INTERRUPT;
+}
+
+/*
+ *  ATmega328 Sleep
+ *    Idle mode is the only mode which keeps timer 0 running, so the
+ *    processor is woken on every system time tick and returns to sleep
+ *    until the deadline is reached.
+ */
+static volatile bool_t sSystemWakeUp = false;
+
+void SystemWakeUp(void) {
+  sSystemWakeUp = true;
+}
+
+bool_t SystemSleepUntil(system_time_t const *deadline) {
+  /* Interrupts are disabled on entry. */
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  for (;;) {
+    if (sSystemWakeUp) {
+      sSystemWakeUp = false;
+      sei();
+      return false;
+    }
+    if (deadline != NULL &&
+        SystemTimeLessThanOrEqual(deadline, &sSystemTime)) {
+      sei();
+      return true;
+    }
+    sleep_enable();
+    /* The instruction after sei() is always executed before any pending
+     * interrupt, so a wake up cannot be missed. */
+    sei();
+    sleep_cpu();
+    sleep_disable();
+    cli();
+  }
+}
+
 #endif  /* _PLATFORM_ARDUINO */
 #endif  /* _PLATFORM_AVR */
@@ -417,3 +417,28 @@ bool_t SystemTimeDecrementNanoseconds(
   }
   return true;
 }
+
+/*
+ *  Tick Conversions
+ */
+
+bool_t SystemTicksFromTime(system_time_t const *time, system_ticks_t *ticks) {
+  if (!SystemTimeIsValid(time) || ticks == NULL) return false;
+  *ticks = SystemTicksFromSeconds(time->seconds) +
+           (time->nanoseconds / SYSTEM_TICK_NS);
+  return true;
+}
+
+bool_t SystemTimeFromTicks(system_ticks_t ticks, system_time_t *time) {
+  if (time == NULL) return false;
+  system_ticks_t const seconds = ticks / SYSTEM_TICKS_PER_SECOND;
+  if (seconds > MAX_SECONDS) {
+    SystemTimeSetMax(time);
+    return true;
+  }
+  time->seconds = (uint32_t) seconds;
+  time->nanoseconds =
+      (uint32_t) (ticks - (seconds * SYSTEM_TICKS_PER_SECOND)) *
+      SYSTEM_TICK_NS;
+  return true;
+}
@@ -26,6 +26,30 @@ typedef struct {
 /* Implementation is platform specific. */
 bool_t SystemTimeNow(system_time_t *time);
 
+/* Compact, free running timestamp, suitable for stamping events from
+ * an interrupt.  Counts in units of SystemTimestampResolution()
+ * nanoseconds and wraps around; only the difference between two
+ * nearby timestamps is meaningful.  Safe to call from interrupts. */
+typedef uint16_t system_timestamp_t;
+
+system_timestamp_t SystemTimestamp(void);
+uint32_t SystemTimestampResolution(void);
+
+#ifdef _PLATFORM_NATIVE
+/* Native Virtual Clock.
+ *    Once enabled, the system time, timestamps and ticks are read from a
+ *    virtual clock which only moves when advanced or set, instead of
+ *    CLOCK_MONOTONIC.  SystemSleepUntil() moves the virtual clock to its
+ *    deadline without waiting (and returns immediately if there is no
+ *    deadline), so timing behaviour can be simulated much faster than
+ *    real time.  The virtual clock never moves backwards. */
+bool_t SystemTimeEnableVirtualClock(system_time_t const *start);
+void SystemTimeDisableVirtualClock(void);
+bool_t SystemTimeIsVirtualClock(void);
+bool_t SystemTimeAdvanceVirtualClock(uint32_t microseconds);
+bool_t SystemTimeSetVirtualClock(system_time_t const *time);
+#endif  /* _PLATFORM_NATIVE */
+
 /* Total Orderings */
 bool_t SystemTimeLessThan(
   system_time_t const *time_a, system_time_t const *time_b);
@@ -69,6 +93,50 @@ bool_t SystemTimeDecrementMilliseconds(system_time_t *time, uint32_t ms);
 bool_t SystemTimeDecrementMicroseconds(system_time_t *time, uint32_t us);
 bool_t SystemTimeDecrementNanoseconds(system_time_t *time, uint32_t ns);
 
+/*
+ *  Tick Based Time.
+ *    A single monotonic count of SYSTEM_TICK_NS nanosecond ticks.  Unlike
+ *    system_time_t, comparisons, sums and differences are plain integer
+ *    operations, without validation, branches or carries.  Ticks are
+ *    64-bit and do not wrap in practice (over 500,000 years at 1 us).
+ */
+#ifndef SYSTEM_TICK_NS
+#define SYSTEM_TICK_NS 1000u
+#endif
+
+#if SYSTEM_TICK_NS == 0 || (1000u % SYSTEM_TICK_NS) != 0
+#error "SYSTEM_TICK_NS must divide 1000"
+#endif
+
+#define SYSTEM_TICKS_PER_SECOND (1000000000u / SYSTEM_TICK_NS)
+#define SYSTEM_TICKS_PER_MICROSECOND (1000u / SYSTEM_TICK_NS)
+
+typedef uint64_t system_ticks_t;
+
+/* Implementation is platform specific.  Safe to call from interrupts. */
+system_ticks_t SystemTicksNow(void);
+
+#define SystemTicksLessThan(ticks_a, ticks_b) ((ticks_a) < (ticks_b))
+#define SystemTicksLessThanOrEqual(ticks_a, ticks_b) ((ticks_a) <= (ticks_b))
+/* Ticks elapsed from |ticks_a| to |ticks_b|.  Unlike the system time
+ * deltas, |ticks_a| must not be after |ticks_b|. */
+#define SystemTicksDelta(ticks_a, ticks_b) \
+  ((system_ticks_t) ((ticks_b) - (ticks_a)))
+#define SystemTicksAdd(ticks, delta) ((system_ticks_t) ((ticks) + (delta)))
+
+#define SystemTicksFromSeconds(s) \
+  (((system_ticks_t) (s)) * SYSTEM_TICKS_PER_SECOND)
+#define SystemTicksFromMicroseconds(us) \
+  (((system_ticks_t) (us)) * SYSTEM_TICKS_PER_MICROSECOND)
+#define SystemTicksToMicroseconds(ticks) \
+  ((ticks) / SYSTEM_TICKS_PER_MICROSECOND)
+
+/* Conversions to and from system_time_t.  Nanoseconds are rounded down
+ * to whole ticks.  Converting ticks beyond the maximum system time will
+ * set the time to its maximum value. */
+bool_t SystemTicksFromTime(system_time_t const *time, system_ticks_t *ticks);
+bool_t SystemTimeFromTicks(system_ticks_t ticks, system_time_t *time);
+
 C_SECTION_END;
 
 #endif  /* _SYSTEM_TIME_H_ */
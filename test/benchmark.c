@@ -0,0 +1,52 @@
+/*
+ * MIDI Controller - Benchmark Utilities
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <stdio.h>
+
+#include "benchmark.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+# include <x86intrin.h>
+# define BenchmarkCycles() ((uint64_t) __rdtsc())
+# define BENCHMARK_HAS_CYCLES
+#elif defined(_PLATFORM_AVR)
+/* Derived from the system ticks, so only as precise as the system
+ * timer; benchmarks should run for many timer periods. */
+# define BenchmarkCycles() \
+  (SystemTicksNow() * (F_CPU / SYSTEM_TICKS_PER_SECOND))
+# define BENCHMARK_HAS_CYCLES
+#else
+# define BenchmarkCycles() ((uint64_t) 0)
+#endif
+
+uint32_t volatile gBenchmarkSink = 0;
+
+void BenchmarkStart(benchmark_t *benchmark, char const *name) {
+  if (benchmark == NULL) return;
+  benchmark->name = name;
+  SystemTimeNow(&benchmark->start);
+  benchmark->start_cycles = BenchmarkCycles();
+}
+
+void BenchmarkStop(benchmark_t const *benchmark, uint32_t iterations) {
+  uint64_t const stop_cycles = BenchmarkCycles();
+  system_time_t stop;
+  SystemTimeNow(&stop);
+  if (benchmark == NULL || iterations == 0) return;
+  uint64_t const ns =
+      ((uint64_t) (stop.seconds - benchmark->start.seconds)) * 1000000000ull
+      + stop.nanoseconds - benchmark->start.nanoseconds;
+  printf("BENCHMARK %-40s %10.3f ns/iter",
+      benchmark->name, (double) ns / iterations);
+#ifdef BENCHMARK_HAS_CYCLES
+  printf(" %8.2f cycles/iter",
+      (double) (stop_cycles - benchmark->start_cycles) / iterations);
+#else
+  (void) stop_cycles;
+#endif
+  printf("\n");
+}
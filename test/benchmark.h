@@ -0,0 +1,36 @@
+/*
+ * MIDI Controller - Benchmark Utilities
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#include "base.h"
+#include "system_time.h"
+
+C_SECTION_BEGIN;
+
+/* Benchmarks are only built with -D_BENCHMARK_ENABLED (see the
+ * native-benchmark environment), and should be built with
+ * optimizations enabled. */
+
+typedef struct {
+  char const *name;
+  system_time_t start;
+  uint64_t start_cycles;
+} benchmark_t;
+
+/* Used to prevent the compiler from optimizing away the benchmarked
+ * work. */
+extern uint32_t volatile gBenchmarkSink;
+
+void BenchmarkStart(benchmark_t *benchmark, char const *name);
+/* Prints the average time (and cycles, if available) per iteration. */
+void BenchmarkStop(benchmark_t const *benchmark, uint32_t iterations);
+
+C_SECTION_END;
+
+#endif  /* _BENCHMARK_H_ */
@@ -167,9 +167,60 @@ static void TestByteBuffer_MultiBytes(void) {
   TEST_ASSERT_TRUE(ByteBufferIsEmpty(&buffer));
 }
 
+static void TestByteBuffer_Spans(void) {
+  buffer_data_t data;
+  byte_buffer_t buffer;
+  uint8_t *write_span = NULL;
+  uint8_t const *read_span = NULL;
+  TEST_ASSERT_TRUE(ByteBufferInitialize(&buffer, data, sizeof(data)));
+  TEST_ASSERT_EQUAL(0, ByteBufferGetWriteSpan(NULL, &write_span));
+  TEST_ASSERT_EQUAL(0, ByteBufferGetWriteSpan(&buffer, NULL));
+  TEST_ASSERT_EQUAL(0, ByteBufferGetReadSpan(NULL, &read_span));
+  TEST_ASSERT_EQUAL(0, ByteBufferCommitBytes(NULL, 1));
+
+  buffer_data_t test_data;
+  FillArray(test_data, sizeof(test_data));
+
+  TEST_ASSERT_EQUAL(0, ByteBufferGetReadSpan(&buffer, &read_span));
+  TEST_ASSERT_EQUAL(
+      TEST_BUFFER_SIZE, ByteBufferGetWriteSpan(&buffer, &write_span));
+  memcpy(write_span, test_data, 8);
+  TEST_ASSERT_EQUAL(8, ByteBufferCommitBytes(&buffer, 8));
+  TEST_ASSERT_EQUAL(8, ByteBufferGetReadSpan(&buffer, &read_span));
+  TEST_ASSERT_EQUAL_MEMORY(test_data, read_span, 8);
+  TEST_ASSERT_EQUAL(6, ByteBufferClearBytes(&buffer, 6));
+
+  /* Free space wraps around the end. */
+  TEST_ASSERT_EQUAL(
+      TEST_BUFFER_SIZE - 8, ByteBufferGetWriteSpan(&buffer, &write_span));
+  memcpy(write_span, &test_data[8], TEST_BUFFER_SIZE - 8);
+  TEST_ASSERT_EQUAL(
+      TEST_BUFFER_SIZE - 8,
+      ByteBufferCommitBytes(&buffer, TEST_BUFFER_SIZE - 8));
+  TEST_ASSERT_EQUAL(6, ByteBufferGetWriteSpan(&buffer, &write_span));
+  TEST_ASSERT_EQUAL_PTR(data, write_span);
+  memcpy(write_span, test_data, 6);
+  /* Cannot commit more than is available. */
+  TEST_ASSERT_EQUAL(6, ByteBufferCommitBytes(&buffer, 7));
+  TEST_ASSERT_TRUE(ByteBufferIsFull(&buffer));
+  TEST_ASSERT_EQUAL(0, ByteBufferGetWriteSpan(&buffer, &write_span));
+
+  /* Data wraps around the end. */
+  TEST_ASSERT_EQUAL(
+      TEST_BUFFER_SIZE - 6, ByteBufferGetReadSpan(&buffer, &read_span));
+  TEST_ASSERT_EQUAL_MEMORY(&test_data[6], read_span, TEST_BUFFER_SIZE - 6);
+  TEST_ASSERT_EQUAL(
+      TEST_BUFFER_SIZE - 6, ByteBufferClearBytes(&buffer, TEST_BUFFER_SIZE - 6));
+  TEST_ASSERT_EQUAL(6, ByteBufferGetReadSpan(&buffer, &read_span));
+  TEST_ASSERT_EQUAL_MEMORY(test_data, read_span, 6);
+  TEST_ASSERT_EQUAL(6, ByteBufferClearBytes(&buffer, 6));
+  TEST_ASSERT_TRUE(ByteBufferIsEmpty(&buffer));
+}
+
 void ByteBufferTest(void) {
   RUN_TEST(TestByteBuffer_Initialize);
   RUN_TEST(TestByteBuffer_SingleByte);
   RUN_TEST(TestByteBuffer_ByteByByte);
   RUN_TEST(TestByteBuffer_MultiBytes);
+  RUN_TEST(TestByteBuffer_Spans);
 }
@@ -0,0 +1,105 @@
+/*
+ * MIDI Controller - Byte Ring Benchmark
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifdef _BENCHMARK_ENABLED
+
+#include <unity.h>
+
+#include "benchmark.h"
+#include "byte_buffer.h"
+#include "byte_ring.h"
+
+#define BENCHMARK_QUEUE_SIZE  128
+#define BENCHMARK_CHUNK_SIZE  48
+#define BENCHMARK_ROUNDS      200000
+
+/* Iterations are reported per byte transferred. */
+#define BENCHMARK_BYTES (BENCHMARK_ROUNDS * BENCHMARK_CHUNK_SIZE)
+
+static uint8_t sQueueData[BENCHMARK_QUEUE_SIZE];
+static uint8_t sInput[BENCHMARK_CHUNK_SIZE];
+static uint8_t sOutput[BENCHMARK_CHUNK_SIZE];
+
+static void InitializeInput(void) {
+  for (size_t i = 0; i < BENCHMARK_CHUNK_SIZE; ++i) {
+    sInput[i] = (uint8_t) (i * 7);
+  }
+}
+
+static void BenchmarkByteBuffer_SingleByte(void) {
+  benchmark_t benchmark;
+  byte_buffer_t buffer;
+  uint32_t sink = 0;
+  uint8_t byte = 0;
+  TEST_ASSERT_TRUE(ByteBufferInitialize(&buffer, sQueueData, BENCHMARK_QUEUE_SIZE));
+  BenchmarkStart(&benchmark, "ByteQueue/buffer-byte");
+  for (uint32_t round = 0; round < BENCHMARK_ROUNDS; ++round) {
+    for (size_t i = 0; i < BENCHMARK_CHUNK_SIZE; ++i) {
+      ByteBufferEnqueueByte(&buffer, sInput[i]);
+    }
+    while (ByteBufferDequeueByte(&buffer, &byte)) sink += byte;
+  }
+  BenchmarkStop(&benchmark, BENCHMARK_BYTES);
+  gBenchmarkSink = sink;
+}
+
+static void BenchmarkByteRing_SingleByte(void) {
+  benchmark_t benchmark;
+  byte_ring_t ring;
+  uint32_t sink = 0;
+  uint8_t byte = 0;
+  TEST_ASSERT_TRUE(ByteRingInitialize(&ring, sQueueData, BENCHMARK_QUEUE_SIZE));
+  BenchmarkStart(&benchmark, "ByteQueue/ring-byte");
+  for (uint32_t round = 0; round < BENCHMARK_ROUNDS; ++round) {
+    for (size_t i = 0; i < BENCHMARK_CHUNK_SIZE; ++i) {
+      ByteRingEnqueueByte(&ring, sInput[i]);
+    }
+    while (ByteRingDequeueByte(&ring, &byte)) sink += byte;
+  }
+  BenchmarkStop(&benchmark, BENCHMARK_BYTES);
+  gBenchmarkSink = sink;
+}
+
+static void BenchmarkByteBuffer_Bytes(void) {
+  benchmark_t benchmark;
+  byte_buffer_t buffer;
+  uint32_t sink = 0;
+  TEST_ASSERT_TRUE(ByteBufferInitialize(&buffer, sQueueData, BENCHMARK_QUEUE_SIZE));
+  BenchmarkStart(&benchmark, "ByteQueue/buffer-bytes");
+  for (uint32_t round = 0; round < BENCHMARK_ROUNDS; ++round) {
+    ByteBufferEnqueueBytes(&buffer, sInput, BENCHMARK_CHUNK_SIZE);
+    sink += ByteBufferDequeueBytes(&buffer, sOutput, BENCHMARK_CHUNK_SIZE);
+    sink += sOutput[round % BENCHMARK_CHUNK_SIZE];
+  }
+  BenchmarkStop(&benchmark, BENCHMARK_BYTES);
+  gBenchmarkSink = sink;
+}
+
+static void BenchmarkByteRing_Bytes(void) {
+  benchmark_t benchmark;
+  byte_ring_t ring;
+  uint32_t sink = 0;
+  TEST_ASSERT_TRUE(ByteRingInitialize(&ring, sQueueData, BENCHMARK_QUEUE_SIZE));
+  BenchmarkStart(&benchmark, "ByteQueue/ring-bytes");
+  for (uint32_t round = 0; round < BENCHMARK_ROUNDS; ++round) {
+    ByteRingEnqueueBytes(&ring, sInput, BENCHMARK_CHUNK_SIZE);
+    sink += ByteRingDequeueBytes(&ring, sOutput, BENCHMARK_CHUNK_SIZE);
+    sink += sOutput[round % BENCHMARK_CHUNK_SIZE];
+  }
+  BenchmarkStop(&benchmark, BENCHMARK_BYTES);
+  gBenchmarkSink = sink;
+}
+
+void ByteRingBenchmark(void) {
+  InitializeInput();
+  RUN_TEST(BenchmarkByteBuffer_SingleByte);
+  RUN_TEST(BenchmarkByteRing_SingleByte);
+  RUN_TEST(BenchmarkByteBuffer_Bytes);
+  RUN_TEST(BenchmarkByteRing_Bytes);
+}
+
+#endif  /* _BENCHMARK_ENABLED */
@@ -0,0 +1,139 @@
+/*
+ * MIDI Controller - Byte Ring Test
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <string.h>
+#include <unity.h>
+
+#include "byte_ring.h"
+
+#define TEST_RING_SIZE 16
+
+typedef uint8_t ring_data_t[TEST_RING_SIZE];
+
+static void FillArray(uint8_t *data, size_t size, uint8_t offset) {
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = (uint8_t) ((i + offset) & 0xFF);
+  }
+}
+
+static void TestByteRing_Initialize(void) {
+  ring_data_t data;
+  byte_ring_t ring;
+  TEST_ASSERT_FALSE(ByteRingInitialize(NULL, data, sizeof(data)));
+  TEST_ASSERT_FALSE(ByteRingInitialize(&ring, NULL, sizeof(data)));
+  TEST_ASSERT_FALSE(ByteRingInitialize(&ring, data, 0));
+  /* Must be a power of two. */
+  TEST_ASSERT_FALSE(ByteRingInitialize(&ring, data, 12));
+
+  TEST_ASSERT_TRUE(ByteRingInitialize(&ring, data, sizeof(data)));
+  TEST_ASSERT_EQUAL(TEST_RING_SIZE, ByteRingCapacity(&ring));
+
+  TEST_ASSERT_FALSE(ByteRingIsEmpty(NULL));
+  TEST_ASSERT_FALSE(ByteRingIsFull(NULL));
+
+  TEST_ASSERT_TRUE(ByteRingIsEmpty(&ring));
+  TEST_ASSERT_FALSE(ByteRingIsFull(&ring));
+  TEST_ASSERT_EQUAL(0, ByteRingSize(&ring));
+}
+
+static void TestByteRing_SingleByte(void) {
+  ring_data_t data;
+  byte_ring_t ring;
+  uint8_t byte = 0;
+  TEST_ASSERT_TRUE(ByteRingInitialize(&ring, data, sizeof(data)));
+
+  TEST_ASSERT_FALSE(ByteRingEnqueueByte(NULL, 0xFF));
+  TEST_ASSERT_FALSE(ByteRingDequeueByte(&ring, &byte));
+
+  TEST_ASSERT_TRUE(ByteRingEnqueueByte(&ring, 0xFF));
+  TEST_ASSERT_EQUAL(1, ByteRingSize(&ring));
+  TEST_ASSERT_FALSE(ByteRingDequeueByte(&ring, NULL));
+  TEST_ASSERT_TRUE(ByteRingDequeueByte(&ring, &byte));
+  TEST_ASSERT_EQUAL(0xFF, byte);
+  TEST_ASSERT_TRUE(ByteRingIsEmpty(&ring));
+
+  /* Fill, wrapping around the end. */
+  for (size_t i = 0; i < TEST_RING_SIZE; ++i) {
+    TEST_ASSERT_TRUE(ByteRingEnqueueByte(&ring, (uint8_t) i));
+  }
+  TEST_ASSERT_TRUE(ByteRingIsFull(&ring));
+  TEST_ASSERT_FALSE(ByteRingEnqueueByte(&ring, 0xFF));
+  for (size_t i = 0; i < TEST_RING_SIZE; ++i) {
+    TEST_ASSERT_TRUE(ByteRingDequeueByte(&ring, &byte));
+    TEST_ASSERT_EQUAL(i, byte);
+  }
+  TEST_ASSERT_TRUE(ByteRingIsEmpty(&ring));
+}
+
+static void TestByteRing_MultipleBytes(void) {
+  ring_data_t data;
+  byte_ring_t ring;
+  uint8_t in[TEST_RING_SIZE + 4];
+  uint8_t out[TEST_RING_SIZE + 4];
+  TEST_ASSERT_TRUE(ByteRingInitialize(&ring, data, sizeof(data)));
+  FillArray(in, sizeof(in), 0x10);
+
+  TEST_ASSERT_EQUAL(0, ByteRingEnqueueBytes(&ring, NULL, 4));
+  TEST_ASSERT_EQUAL(0, ByteRingEnqueueBytes(&ring, in, 0));
+
+  /* Move the indexes away from the start. */
+  TEST_ASSERT_EQUAL(10, ByteRingEnqueueBytes(&ring, in, 10));
+  TEST_ASSERT_EQUAL(10, ByteRingDequeueBytes(&ring, out, sizeof(out)));
+  TEST_ASSERT_EQUAL_MEMORY(in, out, 10);
+
+  /* Overfilling truncates, and the data wraps. */
+  TEST_ASSERT_EQUAL(
+      TEST_RING_SIZE, ByteRingEnqueueBytes(&ring, in, sizeof(in)));
+  TEST_ASSERT_TRUE(ByteRingIsFull(&ring));
+  TEST_ASSERT_EQUAL(0, ByteRingEnqueueBytes(&ring, in, 1));
+
+  memset(out, 0, sizeof(out));
+  TEST_ASSERT_EQUAL(4, ByteRingDequeueBytes(&ring, out, 4));
+  TEST_ASSERT_EQUAL(
+      TEST_RING_SIZE - 4, ByteRingDequeueBytes(&ring, &out[4], sizeof(out)));
+  TEST_ASSERT_EQUAL_MEMORY(in, out, TEST_RING_SIZE);
+  TEST_ASSERT_EQUAL(0, ByteRingDequeueBytes(&ring, out, sizeof(out)));
+}
+
+static void TestByteRing_IndexWrap(void) {
+  ring_data_t data;
+  byte_ring_t ring;
+  uint8_t in[7];
+  uint8_t out[7];
+  TEST_ASSERT_TRUE(ByteRingInitialize(&ring, data, sizeof(data)));
+  /* Free running indexes about to overflow. */
+  ring.head = ring.tail = (byte_ring_index_t) -3;
+  FillArray(in, sizeof(in), 0x40);
+  TEST_ASSERT_EQUAL(sizeof(in), ByteRingEnqueueBytes(&ring, in, sizeof(in)));
+  TEST_ASSERT_EQUAL(sizeof(in), ByteRingSize(&ring));
+  TEST_ASSERT_EQUAL(sizeof(out), ByteRingDequeueBytes(&ring, out, sizeof(out)));
+  TEST_ASSERT_EQUAL_MEMORY(in, out, sizeof(in));
+  TEST_ASSERT_TRUE(ByteRingIsEmpty(&ring));
+}
+
+static void TestByteRing_Clear(void) {
+  ring_data_t data;
+  byte_ring_t ring;
+  uint8_t byte = 0;
+  TEST_ASSERT_TRUE(ByteRingInitialize(&ring, data, sizeof(data)));
+  TEST_ASSERT_FALSE(ByteRingClear(NULL));
+  TEST_ASSERT_TRUE(ByteRingEnqueueByte(&ring, 0x01));
+  TEST_ASSERT_TRUE(ByteRingEnqueueByte(&ring, 0x02));
+  TEST_ASSERT_TRUE(ByteRingClear(&ring));
+  TEST_ASSERT_TRUE(ByteRingIsEmpty(&ring));
+  TEST_ASSERT_TRUE(ByteRingEnqueueByte(&ring, 0x03));
+  TEST_ASSERT_TRUE(ByteRingDequeueByte(&ring, &byte));
+  TEST_ASSERT_EQUAL(0x03, byte);
+}
+
+void ByteRingTest(void) {
+  RUN_TEST(TestByteRing_Initialize);
+  RUN_TEST(TestByteRing_SingleByte);
+  RUN_TEST(TestByteRing_MultipleBytes);
+  RUN_TEST(TestByteRing_IndexWrap);
+  RUN_TEST(TestByteRing_Clear);
+}
@@ -0,0 +1,305 @@
+/*
+ * MIDI Controller - MIDI Callback Dispatch Benchmark
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifdef _BENCHMARK_ENABLED
+
+#include <string.h>
+#include <unity.h>
+
+#include "benchmark.h"
+#include "midi_callback.h"
+#include "midi_callback_internal.h"
+#include "midi_defs.h"
+#include "midi_message.h"
+
+#define BENCHMARK_MESSAGE_COUNT 64
+#define BENCHMARK_ROUNDS        50000
+
+static midi_message_t sMessages[BENCHMARK_MESSAGE_COUNT];
+static uint32_t sHandled = 0;
+
+static void InitializeMessages(void) {
+  /* Typical performance stream, mostly notes with some controllers
+   * and clock. */
+  for (size_t i = 0; i < BENCHMARK_MESSAGE_COUNT; ++i) {
+    midi_message_t *message = &sMessages[i];
+    memset(message, 0, sizeof(midi_message_t));
+    switch (i % 4) {
+      case 0:
+        message->type = MIDI_NOTE_ON;
+        message->note.key = i & 0x7F;
+        message->note.velocity = 0x40;
+        break;
+      case 1:
+        message->type = MIDI_NOTE_OFF;
+        message->note.key = i & 0x7F;
+        break;
+      case 2:
+        message->type = MIDI_CONTROL_CHANGE;
+        message->control.number = 0x07;
+        message->control.value = i & 0x7F;
+        break;
+      default:
+        message->type = MIDI_TIMING_CLOCK;
+        break;
+    }
+  }
+}
+
+static void OnMessage(midi_rx_event_t const *rx_event) {
+  sHandled += rx_event->rx_event_id;
+}
+
+static void OnNote(
+    midi_rx_event_t const *rx_event, midi_channel_number_t channel,
+    midi_note_t const *note) {
+  sHandled += note->key;
+}
+
+static void OnControlChange(
+    midi_rx_event_t const *rx_event, midi_channel_number_t channel,
+    midi_control_change_t const *control) {
+  sHandled += control->value;
+}
+
+static void OnTimingClock(midi_rx_event_t const *rx_event) {
+  ++sHandled;
+}
+
+static void FastHandler(void *ctx, midi_message_t const *message) {
+  sHandled += message->type;
+}
+
+/* Copy of the switch based dispatch which preceded the dispatch
+ * table, without SysEx, so that both can be measured in one build. */
+static void BaselineIncrementEventCounter(uint32_t *counter) {
+  ++(*counter);
+  if (*counter == 0) ++(*counter);
+}
+
+static bool_t BaselineCallMessageCallback(
+    midi_callbacks_t const *callbacks, midi_time_t const *time,
+    midi_message_t const *message) {
+  midi_rx_callbacks_t const *rx = &callbacks->rx;
+  midi_rx_event_t rx_event = {
+    .general = {
+      .event_id = callbacks->next_event_id,
+      .time = time
+    },
+    .rx_event_id = rx->next_rx_event_id,
+    .message = message,
+    .user_ctx = NULL
+  };
+
+  if (rx->OnMessage) {
+    rx_event.user_ctx = rx->message_ctx;
+    rx->OnMessage(&rx_event);
+  }
+
+  switch (message->type) {
+    case MIDI_NOTE_OFF: {
+      if (rx->OnNoteOff != NULL) {
+        rx_event.user_ctx = rx->note_ctx;
+        rx->OnNoteOff(&rx_event, message->channel, &message->note);
+      }
+      return true;
+    }
+    case MIDI_NOTE_ON: {
+      if (rx->OnNoteOn != NULL) {
+        rx_event.user_ctx = rx->note_ctx;
+        rx->OnNoteOn(&rx_event, message->channel, &message->note);
+      }
+      return true;
+    }
+    case MIDI_KEY_PRESSURE: {
+      if (rx->OnKeyPressure != NULL) {
+        rx_event.user_ctx = rx->note_ctx;
+        rx->OnKeyPressure(&rx_event, message->channel, &message->note);
+      }
+      return true;
+    }
+    case MIDI_CONTROL_CHANGE: {
+      if (rx->OnControlChange != NULL) {
+        rx_event.user_ctx = rx->control_change_ctx;
+        rx->OnControlChange(&rx_event, message->channel, &message->control);
+      }
+      return true;
+    }
+    case MIDI_PROGRAM_CHANGE: {
+      if (rx->OnProgramChange != NULL) {
+        rx_event.user_ctx = rx->program_change_ctx;
+        rx->OnProgramChange(&rx_event, message->channel, message->program);
+      }
+      return true;
+    }
+    case MIDI_CHANNEL_PRESSURE: {
+      if (rx->OnChannelPressureChange != NULL) {
+        rx_event.user_ctx = rx->channel_pressure_ctx;
+        rx->OnChannelPressureChange(
+            &rx_event, message->channel, message->pressure);
+      }
+      return true;
+    }
+    case MIDI_PITCH_WHEEL: {
+      if (rx->OnPitchWheelChange != NULL) {
+        rx_event.user_ctx = rx->pitch_wheel_ctx;
+        rx->OnPitchWheelChange(
+            &rx_event, message->channel, message->pitch);
+      }
+      return true;
+    }
+    case MIDI_SONG_POSITION_POINTER: {
+      if (rx->OnSongPosition != NULL) {
+        rx_event.user_ctx = rx->song_position_ctx;
+        rx->OnSongPosition(&rx_event, message->song_position);
+      }
+      return true;
+    }
+    case MIDI_SONG_SELECT: {
+      if (rx->OnSongSelect != NULL) {
+        rx_event.user_ctx = rx->song_select_ctx;
+        rx->OnSongSelect(&rx_event, message->song_number);
+      }
+      return true;
+    }
+    case MIDI_TUNE_REQUEST: {
+      if (rx->OnTuneRequest != NULL) {
+        rx_event.user_ctx = rx->tune_request_ctx;
+        rx->OnTuneRequest(&rx_event);
+      }
+      return true;
+    }
+    case MIDI_TIMING_CLOCK: {
+      if (rx->OnTimingClock != NULL) {
+        rx_event.user_ctx = rx->timing_clock_ctx;
+        rx->OnTimingClock(&rx_event);
+      }
+      return true;
+    }
+    case MIDI_START: {
+      if (rx->OnPlayback != NULL) {
+        rx_event.user_ctx = rx->playback_ctx;
+        rx->OnPlayback(&rx_event, MIDI_START);
+      }
+      if (rx->OnStartPlayback != NULL) {
+        rx_event.user_ctx = rx->playback_ctx;
+        rx->OnStartPlayback(&rx_event);
+      }
+      return true;
+    }
+    case MIDI_CONTINUE: {
+      if (rx->OnPlayback != NULL) {
+        rx_event.user_ctx = rx->playback_ctx;
+        rx->OnPlayback(&rx_event, MIDI_CONTINUE);
+      }
+      if (rx->OnContinuePlayback != NULL) {
+        rx_event.user_ctx = rx->playback_ctx;
+        rx->OnContinuePlayback(&rx_event);
+      }
+      return true;
+    }
+    case MIDI_STOP: {
+      if (rx->OnPlayback != NULL) {
+        rx_event.user_ctx = rx->playback_ctx;
+        rx->OnPlayback(&rx_event, MIDI_STOP);
+      }
+      if (rx->OnStopPlayback != NULL) {
+        rx_event.user_ctx = rx->playback_ctx;
+        rx->OnStopPlayback(&rx_event);
+      }
+      return true;
+    }
+    case MIDI_ACTIVE_SENSING: {
+      if (rx->OnActiveSensing != NULL) {
+        rx_event.user_ctx = rx->active_sensing_ctx;
+        rx->OnActiveSensing(&rx_event);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Not inlined, as the library dispatch is called across translation
+ * units. */
+__attribute__((noinline))
+static bool_t BaselineCallOnMessageCallback(
+    midi_callbacks_t *callbacks, midi_time_t const *time,
+    midi_message_t const *message) {
+  if (callbacks == NULL || message == NULL) return false;
+  if (message->type == MIDI_NONE || !MidiIsValidMessageType(message->type))
+    return false;
+  if (message->type == MIDI_SYSTEM_EXCLUSIVE ||
+      message->type == MIDI_SYSTEM_RESET) return false;
+  bool_t const sub_result =
+      BaselineCallMessageCallback(callbacks, time, message);
+  if (sub_result) {
+    BaselineIncrementEventCounter(&callbacks->next_event_id);
+    BaselineIncrementEventCounter(&callbacks->rx.next_rx_event_id);
+  }
+  return sub_result;
+}
+
+typedef bool_t (*dispatch_t)(
+    midi_callbacks_t *callbacks, midi_time_t const *time,
+    midi_message_t const *message);
+
+static void RunDispatch(
+    midi_callbacks_t *callbacks, dispatch_t Dispatch, char const *name) {
+  benchmark_t benchmark;
+  sHandled = 0;
+  BenchmarkStart(&benchmark, name);
+  for (uint32_t round = 0; round < BENCHMARK_ROUNDS; ++round) {
+    for (size_t i = 0; i < BENCHMARK_MESSAGE_COUNT; ++i) {
+      Dispatch(callbacks, NULL, &sMessages[i]);
+    }
+  }
+  BenchmarkStop(&benchmark, BENCHMARK_ROUNDS * BENCHMARK_MESSAGE_COUNT);
+  gBenchmarkSink = sHandled;
+}
+
+static void SetMessageCallbacks(midi_callbacks_t *callbacks) {
+  MidiInitializeCallbacks(callbacks);
+  callbacks->rx.OnMessage = OnMessage;
+  callbacks->rx.OnNoteOn = OnNote;
+  callbacks->rx.OnNoteOff = OnNote;
+  callbacks->rx.OnControlChange = OnControlChange;
+  callbacks->rx.OnTimingClock = OnTimingClock;
+}
+
+static void BenchmarkMidiCallback_Switch(void) {
+  midi_callbacks_t callbacks;
+  SetMessageCallbacks(&callbacks);
+  RunDispatch(
+      &callbacks, BaselineCallOnMessageCallback, "MidiCallback/switch");
+}
+
+static void BenchmarkMidiCallback_Table(void) {
+  midi_callbacks_t callbacks;
+  SetMessageCallbacks(&callbacks);
+  RunDispatch(&callbacks, MidiCallOnMessageCallback, "MidiCallback/table");
+}
+
+static void BenchmarkMidiCallback_Fast(void) {
+  midi_callbacks_t callbacks;
+  MidiInitializeCallbacks(&callbacks);
+  MidiSetFastMessageHandler(&callbacks.rx, MIDI_NOTE_ON, FastHandler, NULL);
+  MidiSetFastMessageHandler(&callbacks.rx, MIDI_NOTE_OFF, FastHandler, NULL);
+  MidiSetFastMessageHandler(
+      &callbacks.rx, MIDI_CONTROL_CHANGE, FastHandler, NULL);
+  MidiSetFastMessageHandler(&callbacks.rx, MIDI_TIMING_CLOCK, FastHandler, NULL);
+  RunDispatch(&callbacks, MidiCallOnMessageCallback, "MidiCallback/fast");
+}
+
+void MidiCallbackBenchmark(void) {
+  InitializeMessages();
+  RUN_TEST(BenchmarkMidiCallback_Switch);
+  RUN_TEST(BenchmarkMidiCallback_Table);
+  RUN_TEST(BenchmarkMidiCallback_Fast);
+}
+
+#endif  /* _BENCHMARK_ENABLED */
@@ -705,6 +705,313 @@ static void TestMidiCallback_SystemReset(void) {
  *  System Exclusive Callbacks
  */
 
+static void FastNoteCallback(void *ctx, midi_message_t const *message) {
+  midi_specialized_ctx_t *fast_ctx = (midi_specialized_ctx_t *) ctx;
+  fast_ctx->type = message->type;
+  fast_ctx->arg_one = message->note.key;
+  fast_ctx->pointer_arg = message;
+}
+
+static void TestMidiCallback_FastHandler(void) {
+  midi_callbacks_t callbacks;
+  TEST_ASSERT_TRUE(MidiInitializeCallbacks(&callbacks));
+  callbacks.next_event_id = 1000;
+
+  midi_message_ctx_t message_ctx = {};
+  callbacks.rx.OnMessage = MessageCallback;
+  callbacks.rx.message_ctx = &message_ctx;
+  midi_specialized_ctx_t note_ctx = { .message_ctx = &message_ctx };
+  callbacks.rx.OnNoteOn = NoteCallback;
+  callbacks.rx.note_ctx = &note_ctx;
+  midi_specialized_ctx_t fast_ctx = {};
+
+  TEST_ASSERT_FALSE(MidiSetFastMessageHandler(
+      NULL, MIDI_NOTE_ON, FastNoteCallback, &fast_ctx));
+  /* Invalid and unsupported message types. */
+  TEST_ASSERT_FALSE(MidiSetFastMessageHandler(
+      &callbacks.rx, MIDI_NOTE_ON | MIDI_CHANNEL_2, FastNoteCallback, &fast_ctx));
+  TEST_ASSERT_FALSE(MidiSetFastMessageHandler(
+      &callbacks.rx, MIDI_SYSTEM_EXCLUSIVE, FastNoteCallback, &fast_ctx));
+  TEST_ASSERT_FALSE(MidiSetFastMessageHandler(
+      &callbacks.rx, MIDI_SYSTEM_RESET, FastNoteCallback, &fast_ctx));
+  TEST_ASSERT_TRUE(MidiSetFastMessageHandler(
+      &callbacks.rx, MIDI_NOTE_ON, FastNoteCallback, &fast_ctx));
+
+  midi_message_t const kNoteOnMessage = {
+    .type = MIDI_NOTE_ON,
+    .channel = MIDI_CHANNEL_3,
+    .note = { .key = 0x40, .velocity = 0x7F }
+  };
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(
+      &callbacks, NULL, &kNoteOnMessage));
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, fast_ctx.type);
+  TEST_ASSERT_EQUAL(0x40, fast_ctx.arg_one);
+  TEST_ASSERT_EQUAL(&kNoteOnMessage, fast_ctx.pointer_arg);
+  /* Other callbacks are skipped, but counters are still updated. */
+  TEST_ASSERT_NULL(message_ctx.message);
+  TEST_ASSERT_EQUAL(MIDI_NONE, note_ctx.type);
+  TEST_ASSERT_EQUAL(1001, callbacks.next_event_id);
+  TEST_ASSERT_EQUAL(2, callbacks.rx.next_rx_event_id);
+
+  /* Other message types are unaffected. */
+  midi_message_t const kNoteOffMessage = {
+    .type = MIDI_NOTE_OFF,
+    .channel = MIDI_CHANNEL_3,
+    .note = { .key = 0x40, .velocity = 0x00 }
+  };
+  callbacks.rx.OnNoteOff = NoteCallback;
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(
+      &callbacks, NULL, &kNoteOffMessage));
+  TEST_ASSERT_EQUAL(&kNoteOffMessage, message_ctx.message);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_OFF, note_ctx.type);
+
+  /* Clearing the fast handler restores the callbacks. */
+  ClearCtx(&note_ctx);
+  TEST_ASSERT_TRUE(MidiSetFastMessageHandler(
+      &callbacks.rx, MIDI_NOTE_ON, NULL, NULL));
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(
+      &callbacks, NULL, &kNoteOnMessage));
+  TEST_ASSERT_EQUAL(&kNoteOnMessage, message_ctx.message);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, note_ctx.type);
+}
+
+static void TestMidiCallback_ChannelCallbacks(void) {
+  midi_callbacks_t callbacks;
+  TEST_ASSERT_TRUE(MidiInitializeCallbacks(&callbacks));
+  TEST_ASSERT_EQUAL(MIDI_CHANNEL_MASK_ALL, callbacks.rx.channel_mask);
+  midi_message_ctx_t message_ctx = {};
+  callbacks.rx.OnMessage = MessageCallback;
+  callbacks.rx.message_ctx = &message_ctx;
+  midi_specialized_ctx_t note_ctx = { .message_ctx = &message_ctx };
+  callbacks.rx.OnNoteOn = NoteCallback;
+  callbacks.rx.note_ctx = &note_ctx;
+
+  midi_channel_callbacks_t drum_callbacks;
+  TEST_ASSERT_TRUE(MidiInitializeChannelCallbacks(&drum_callbacks));
+  midi_specialized_ctx_t drum_ctx = {};
+  drum_callbacks.OnNoteOn = NoteCallback;
+  drum_callbacks.note_ctx = &drum_ctx;
+
+  TEST_ASSERT_FALSE(MidiSetChannelCallbacks(
+      NULL, MIDI_DRUM_CHANNEL, &drum_callbacks));
+  TEST_ASSERT_FALSE(MidiSetChannelCallbacks(
+      &callbacks, MIDI_CHANNEL_16 + 1, &drum_callbacks));
+  TEST_ASSERT_TRUE(MidiSetChannelCallbacks(
+      &callbacks, MIDI_DRUM_CHANNEL, &drum_callbacks));
+
+  midi_message_t const kDrumMessage = {
+    .type = MIDI_NOTE_ON,
+    .channel = MIDI_DRUM_CHANNEL,
+    .note = { .key = 0x24, .velocity = 0x7F }
+  };
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(
+      &callbacks, NULL, &kDrumMessage));
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, drum_ctx.type);
+  TEST_ASSERT_EQUAL(MIDI_DRUM_CHANNEL, drum_ctx.arg_one);
+  /* The main callbacks are skipped, but counters are still updated. */
+  TEST_ASSERT_NULL(message_ctx.message);
+  TEST_ASSERT_EQUAL(MIDI_NONE, note_ctx.type);
+  TEST_ASSERT_EQUAL(2, callbacks.next_event_id);
+  TEST_ASSERT_EQUAL(2, callbacks.rx.next_rx_event_id);
+
+  /* Other channels use the main callbacks. */
+  ClearCtx(&drum_ctx);
+  midi_message_t const kNoteMessage = {
+    .type = MIDI_NOTE_ON,
+    .channel = MIDI_CHANNEL_1,
+    .note = { .key = 0x40, .velocity = 0x7F }
+  };
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(
+      &callbacks, NULL, &kNoteMessage));
+  TEST_ASSERT_EQUAL(&kNoteMessage, message_ctx.message);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, note_ctx.type);
+  TEST_ASSERT_EQUAL(MIDI_NONE, drum_ctx.type);
+
+  /* Clearing restores the main callbacks. */
+  ClearCtx(&note_ctx);
+  TEST_ASSERT_TRUE(MidiSetChannelCallbacks(
+      &callbacks, MIDI_DRUM_CHANNEL, NULL));
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(
+      &callbacks, NULL, &kDrumMessage));
+  TEST_ASSERT_EQUAL(&kDrumMessage, message_ctx.message);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, note_ctx.type);
+  TEST_ASSERT_EQUAL(MIDI_NONE, drum_ctx.type);
+
+  TEST_ASSERT_FALSE(MidiSetChannelMask(NULL, MIDI_CHANNEL_MASK_NONE));
+  TEST_ASSERT_TRUE(MidiSetChannelMask(
+      &callbacks, MidiChannelMaskBit(MIDI_CHANNEL_1)));
+  TEST_ASSERT_EQUAL(0x0001, callbacks.rx.channel_mask);
+}
+
+static void TestMidiCallback_ChannelFastHandler(void) {
+  midi_callbacks_t callbacks;
+  TEST_ASSERT_TRUE(MidiInitializeCallbacks(&callbacks));
+  midi_specialized_ctx_t fast_ctx = {};
+  TEST_ASSERT_TRUE(MidiSetFastMessageHandler(
+      &callbacks.rx, MIDI_NOTE_ON, FastNoteCallback, &fast_ctx));
+
+  midi_channel_callbacks_t drum_callbacks;
+  TEST_ASSERT_TRUE(MidiInitializeChannelCallbacks(&drum_callbacks));
+  midi_specialized_ctx_t drum_fast_ctx = {};
+  TEST_ASSERT_FALSE(MidiSetChannelFastMessageHandler(
+      NULL, MIDI_NOTE_ON, FastNoteCallback, &drum_fast_ctx));
+  /* Only channel message types. */
+  TEST_ASSERT_FALSE(MidiSetChannelFastMessageHandler(
+      &drum_callbacks, MIDI_TIMING_CLOCK, FastNoteCallback, &drum_fast_ctx));
+  TEST_ASSERT_TRUE(MidiSetChannelFastMessageHandler(
+      &drum_callbacks, MIDI_NOTE_ON, FastNoteCallback, &drum_fast_ctx));
+  TEST_ASSERT_TRUE(MidiSetChannelCallbacks(
+      &callbacks, MIDI_DRUM_CHANNEL, &drum_callbacks));
+
+  midi_message_t const kDrumMessage = {
+    .type = MIDI_NOTE_ON,
+    .channel = MIDI_DRUM_CHANNEL,
+    .note = { .key = 0x24, .velocity = 0x7F }
+  };
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(
+      &callbacks, NULL, &kDrumMessage));
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, drum_fast_ctx.type);
+  TEST_ASSERT_EQUAL(0x24, drum_fast_ctx.arg_one);
+  TEST_ASSERT_EQUAL(&kDrumMessage, drum_fast_ctx.pointer_arg);
+  TEST_ASSERT_EQUAL(MIDI_NONE, fast_ctx.type);
+  TEST_ASSERT_EQUAL(2, callbacks.rx.next_rx_event_id);
+
+  /* Other channels use the main fast handler. */
+  ClearCtx(&drum_fast_ctx);
+  midi_message_t const kNoteMessage = {
+    .type = MIDI_NOTE_ON,
+    .channel = MIDI_CHANNEL_1,
+    .note = { .key = 0x40, .velocity = 0x7F }
+  };
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(
+      &callbacks, NULL, &kNoteMessage));
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, fast_ctx.type);
+  TEST_ASSERT_EQUAL(0x40, fast_ctx.arg_one);
+  TEST_ASSERT_EQUAL(MIDI_NONE, drum_fast_ctx.type);
+
+  /* The channel set does not fall back to the main fast handler. */
+  ClearCtx(&fast_ctx);
+  midi_specialized_ctx_t drum_note_ctx = {};
+  drum_callbacks.OnNoteOn = NoteCallback;
+  drum_callbacks.note_ctx = &drum_note_ctx;
+  TEST_ASSERT_TRUE(MidiSetChannelFastMessageHandler(
+      &drum_callbacks, MIDI_NOTE_ON, NULL, NULL));
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(
+      &callbacks, NULL, &kDrumMessage));
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, drum_note_ctx.type);
+  TEST_ASSERT_EQUAL(MIDI_NONE, fast_ctx.type);
+  TEST_ASSERT_EQUAL(MIDI_NONE, drum_fast_ctx.type);
+}
+
+typedef struct {
+  size_t count;
+  uint32_t order;
+  midi_message_t const *message;
+} subscriber_ctx_t;
+
+static uint32_t sSubscriberOrder = 0;
+
+static void SubscriberCallback(midi_rx_event_t const *rx_event) {
+  subscriber_ctx_t *ctx = (subscriber_ctx_t *) rx_event->user_ctx;
+  ++ctx->count;
+  ctx->order = ++sSubscriberOrder;
+  ctx->message = rx_event->message;
+}
+
+static void OtherSubscriberCallback(midi_rx_event_t const *rx_event) {
+  SubscriberCallback(rx_event);
+}
+
+static void TestMidiCallback_Subscribers(void) {
+  midi_callbacks_t callbacks;
+  TEST_ASSERT_TRUE(MidiInitializeCallbacks(&callbacks));
+  midi_specialized_ctx_t note_ctx = {};
+  callbacks.rx.OnNoteOn = NoteCallback;
+  callbacks.rx.note_ctx = &note_ctx;
+  subscriber_ctx_t display = {}, router = {}, recorder = {}, clock = {};
+  midi_rx_callbacks_t *rx = &callbacks.rx;
+
+  TEST_ASSERT_FALSE(MidiAddSubscriber(
+      NULL, MIDI_NOTE_ON, SubscriberCallback, &display));
+  TEST_ASSERT_FALSE(MidiAddSubscriber(rx, MIDI_NOTE_ON, NULL, &display));
+  TEST_ASSERT_FALSE(MidiAddSubscriber(
+      rx, MIDI_SYSTEM_EXCLUSIVE, SubscriberCallback, &display));
+  TEST_ASSERT_FALSE(MidiAddSubscriber(
+      rx, MIDI_NOTE_ON | MIDI_CHANNEL_2, SubscriberCallback, &display));
+  /* Added out of type order. */
+  TEST_ASSERT_TRUE(MidiAddSubscriber(
+      rx, MIDI_TIMING_CLOCK, SubscriberCallback, &clock));
+  TEST_ASSERT_TRUE(MidiAddSubscriber(
+      rx, MIDI_NOTE_ON, SubscriberCallback, &display));
+  TEST_ASSERT_TRUE(MidiAddSubscriber(
+      rx, MIDI_NOTE_ON, OtherSubscriberCallback, &router));
+  TEST_ASSERT_TRUE(MidiAddSubscriber(
+      rx, MIDI_NOTE_ON, SubscriberCallback, &recorder));
+  TEST_ASSERT_FALSE(MidiAddSubscriber(
+      rx, MIDI_NOTE_ON, SubscriberCallback, &recorder));
+
+  midi_message_t const kNoteOnMessage = {
+    .type = MIDI_NOTE_ON,
+    .channel = MIDI_CHANNEL_1,
+    .note = { .key = 0x40, .velocity = 0x7F }
+  };
+  midi_message_t const kClockMessage = { .type = MIDI_TIMING_CLOCK };
+  sSubscriberOrder = 0;
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(
+      &callbacks, NULL, &kNoteOnMessage));
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, note_ctx.type);
+  TEST_ASSERT_EQUAL(1, display.count);
+  TEST_ASSERT_EQUAL(1, display.order);
+  TEST_ASSERT_EQUAL(&kNoteOnMessage, display.message);
+  TEST_ASSERT_EQUAL(1, router.count);
+  TEST_ASSERT_EQUAL(2, router.order);
+  TEST_ASSERT_EQUAL(1, recorder.count);
+  TEST_ASSERT_EQUAL(3, recorder.order);
+  TEST_ASSERT_EQUAL(0, clock.count);
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(
+      &callbacks, NULL, &kClockMessage));
+  TEST_ASSERT_EQUAL(1, clock.count);
+  TEST_ASSERT_EQUAL(1, display.count);
+
+  TEST_ASSERT_FALSE(MidiRemoveSubscriber(
+      rx, MIDI_NOTE_ON, SubscriberCallback, &router));
+  TEST_ASSERT_TRUE(MidiRemoveSubscriber(
+      rx, MIDI_NOTE_ON, OtherSubscriberCallback, &router));
+  TEST_ASSERT_FALSE(MidiRemoveSubscriber(
+      rx, MIDI_NOTE_ON, OtherSubscriberCallback, &router));
+  sSubscriberOrder = 0;
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(
+      &callbacks, NULL, &kNoteOnMessage));
+  TEST_ASSERT_EQUAL(2, display.count);
+  TEST_ASSERT_EQUAL(1, display.order);
+  TEST_ASSERT_EQUAL(1, router.count);
+  TEST_ASSERT_EQUAL(2, recorder.count);
+  TEST_ASSERT_EQUAL(2, recorder.order);
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(
+      &callbacks, NULL, &kClockMessage));
+  TEST_ASSERT_EQUAL(2, clock.count);
+
+  /* Pool capacity is shared by all message types. */
+  subscriber_ctx_t extra[MIDI_SUBSCRIBER_POOL_SIZE];
+  size_t const used = 3;
+  for (size_t i = 0; i < MIDI_SUBSCRIBER_POOL_SIZE - used; ++i) {
+    TEST_ASSERT_TRUE(MidiAddSubscriber(
+        rx, MIDI_CONTROL_CHANGE, SubscriberCallback, &extra[i]));
+  }
+  TEST_ASSERT_FALSE(MidiAddSubscriber(
+      rx, MIDI_PITCH_WHEEL, SubscriberCallback, &extra[0]));
+  TEST_ASSERT_TRUE(MidiRemoveSubscriber(
+      rx, MIDI_TIMING_CLOCK, SubscriberCallback, &clock));
+  TEST_ASSERT_TRUE(MidiAddSubscriber(
+      rx, MIDI_PITCH_WHEEL, SubscriberCallback, &extra[0]));
+  sSubscriberOrder = 0;
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(
+      &callbacks, NULL, &kNoteOnMessage));
+  TEST_ASSERT_EQUAL(3, display.count);
+  TEST_ASSERT_EQUAL(3, recorder.count);
+  TEST_ASSERT_EQUAL(2, recorder.order);
+}
+
 static void SysExMessageCallback(midi_sys_ex_rx_event_t const *sys_ex_event) {
   if (sys_ex_event == NULL || sys_ex_event->rx_event.user_ctx == NULL) return;
   midi_specialized_ctx_t *ctx =
@@ -738,4 +1045,8 @@ void MidiCallbackTest(void) {
   RUN_TEST(TestMidiCallback_AllMessages);
   RUN_TEST(TestMidiCallback_TimeUpdate);
   RUN_TEST(TestMidiCallback_SystemReset);
+  RUN_TEST(TestMidiCallback_FastHandler);
+  RUN_TEST(TestMidiCallback_ChannelCallbacks);
+  RUN_TEST(TestMidiCallback_ChannelFastHandler);
+  RUN_TEST(TestMidiCallback_Subscribers);
 }
@@ -0,0 +1,228 @@
+/*
+ * MIDI Controller - MIDI Clock Recovery Test
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <string.h>
+#include <unity.h>
+
+#include "system_time.h"
+
+#include "midi_clock_recovery.h"
+#include "midi_defs.h"
+#include "midi_time.h"
+
+/* 120 BPM is 20833.33 us per clock. */
+#define TEST_120_BPM_CLOCK_TIME(clock) \
+    (SystemTicksFromMicroseconds(((clock) * 62500ull) / 3))
+#define TEST_140_BPM_CLOCK_TIME(clock) \
+    (SystemTicksFromMicroseconds(((clock) * 125000ull) / 7))
+
+/* Deterministic receive jitter of up to +/- |range| us. */
+static int32_t TestJitter(uint32_t *seed, int32_t range) {
+  *seed = *seed * 1103515245u + 12345u;
+  return (int32_t) ((*seed >> 16) % (2 * range + 1)) - range;
+}
+
+static void TestMidiClockRecovery_Initializer(void) {
+  TEST_ASSERT_FALSE(MidiInitializeClockRecovery(NULL));
+  midi_clock_recovery_t recovery;
+  TEST_ASSERT_TRUE(MidiInitializeClockRecovery(&recovery));
+  TEST_ASSERT_FALSE(MidiIsClockRecoveryLocked(
+      &recovery, MIDI_CLOCK_RECOVERY_CLOCK, 0));
+  TEST_ASSERT_FALSE(MidiIsClockRecoveryLocked(&recovery, 2, 0));
+  uint32_t value;
+  TEST_ASSERT_FALSE(MidiGetClockRecoveryTempo(&recovery, &value));
+  TEST_ASSERT_FALSE(MidiGetClockRecoveryTempo(&recovery, NULL));
+  TEST_ASSERT_TRUE(MidiGetClockRecoveryPosition(&recovery, 0, &value));
+  TEST_ASSERT_EQUAL(0, value);
+  midi_frame_count_t frames;
+  uint8_t fraction;
+  TEST_ASSERT_FALSE(MidiGetClockRecoveryFrames(
+      &recovery, 0, &frames, &fraction));
+  midi_clock_pll_stats_t stats;
+  TEST_ASSERT_FALSE(MidiGetClockRecoveryStats(&recovery, 2, 0, &stats));
+  TEST_ASSERT_FALSE(MidiClockRecoveryTimingClock(NULL, 0));
+  TEST_ASSERT_FALSE(MidiClockRecoveryQuarterFrame(&recovery, NULL, 0));
+}
+
+static void TestMidiClockRecovery_Tempo(void) {
+  midi_clock_recovery_t recovery;
+  MidiInitializeClockRecovery(&recovery);
+  system_ticks_t const start = SystemTicksFromSeconds(5);
+  uint32_t seed = 1;
+  uint32_t clock;
+  for (clock = 0; clock < 96; ++clock) {
+    system_ticks_t const time = start + TEST_120_BPM_CLOCK_TIME(clock)
+        + TestJitter(&seed, 300);
+    TEST_ASSERT_TRUE(MidiClockRecoveryTimingClock(&recovery, time));
+  }
+  system_ticks_t const now = start + TEST_120_BPM_CLOCK_TIME(clock - 1);
+  TEST_ASSERT_TRUE(MidiIsClockRecoveryLocked(
+      &recovery, MIDI_CLOCK_RECOVERY_CLOCK, now));
+  uint32_t milli_bpm;
+  TEST_ASSERT_TRUE(MidiGetClockRecoveryTempo(&recovery, &milli_bpm));
+  TEST_ASSERT_UINT32_WITHIN(600, 120000, milli_bpm);
+
+  midi_clock_pll_stats_t stats;
+  TEST_ASSERT_TRUE(MidiGetClockRecoveryStats(
+      &recovery, MIDI_CLOCK_RECOVERY_CLOCK, now, &stats));
+  TEST_ASSERT_TRUE(stats.locked);
+  TEST_ASSERT_EQUAL(96, stats.events);
+  TEST_ASSERT_UINT32_WITHIN(100000, 20833333, stats.period_ns);
+  TEST_ASSERT_TRUE(stats.jitter_us > 0 && stats.jitter_us < 300);
+  TEST_ASSERT_TRUE(stats.max_error_us < 1000);
+  TEST_ASSERT_TRUE(stats.drift_us > -100 && stats.drift_us < 100);
+
+  /* Tempo change, relocks at the new tempo. */
+  system_ticks_t const change = now;
+  for (clock = 1; clock <= 48; ++clock) {
+    MidiClockRecoveryTimingClock(
+        &recovery, change + TEST_140_BPM_CLOCK_TIME(clock));
+  }
+  system_ticks_t const later = change + TEST_140_BPM_CLOCK_TIME(48);
+  TEST_ASSERT_TRUE(MidiIsClockRecoveryLocked(
+      &recovery, MIDI_CLOCK_RECOVERY_CLOCK, later));
+  TEST_ASSERT_TRUE(MidiGetClockRecoveryTempo(&recovery, &milli_bpm));
+  TEST_ASSERT_UINT32_WITHIN(200, 140000, milli_bpm);
+
+  /* Clocks stop. */
+  TEST_ASSERT_FALSE(MidiIsClockRecoveryLocked(
+      &recovery, MIDI_CLOCK_RECOVERY_CLOCK,
+      later + SystemTicksFromMicroseconds(100000)));
+}
+
+static void TestMidiClockRecovery_Position(void) {
+  midi_clock_recovery_t recovery;
+  MidiInitializeClockRecovery(&recovery);
+  TEST_ASSERT_TRUE(MidiClockRecoveryLocate(&recovery, 96));
+  uint32_t position;
+  MidiGetClockRecoveryPosition(&recovery, 0, &position);
+  TEST_ASSERT_EQUAL(96 * 256, position);
+
+  uint32_t clock;
+  for (clock = 0; clock < 48; ++clock) {
+    MidiClockRecoveryTimingClock(&recovery, TEST_120_BPM_CLOCK_TIME(clock));
+  }
+  /* Last clock was clock 47 after the locate. */
+  system_ticks_t const last = TEST_120_BPM_CLOCK_TIME(47);
+  TEST_ASSERT_TRUE(MidiGetClockRecoveryPosition(&recovery, last, &position));
+  TEST_ASSERT_UINT32_WITHIN(2, (96 + 47) * 256, position);
+  /* Half way to the next clock. */
+  TEST_ASSERT_TRUE(MidiGetClockRecoveryPosition(
+      &recovery, last + SystemTicksFromMicroseconds(10417), &position));
+  TEST_ASSERT_UINT32_WITHIN(2, (96 + 47) * 256 + 128, position);
+  /* Stops at the next expected clock. */
+  TEST_ASSERT_TRUE(MidiGetClockRecoveryPosition(
+      &recovery, last + SystemTicksFromMicroseconds(30000), &position));
+  TEST_ASSERT_EQUAL((96 + 48) * 256, position);
+
+  /* Time of a quarter clock after the next. */
+  system_ticks_t time;
+  TEST_ASSERT_TRUE(MidiGetClockRecoveryPositionTime(
+      &recovery, (96 + 48) * 256 + 64, &time));
+  TEST_ASSERT_UINT32_WITHIN(
+      2, TEST_120_BPM_CLOCK_TIME(48) + SystemTicksFromMicroseconds(5208),
+      time);
+
+  /* Start, the tempo is kept. */
+  TEST_ASSERT_TRUE(MidiClockRecoveryLocate(&recovery, 0));
+  system_ticks_t const restart = last + SystemTicksFromSeconds(1);
+  MidiClockRecoveryTimingClock(&recovery, restart);
+  TEST_ASSERT_TRUE(MidiGetClockRecoveryPosition(
+      &recovery, restart + SystemTicksFromMicroseconds(10417), &position));
+  TEST_ASSERT_UINT32_WITHIN(2, 128, position);
+}
+
+/* Sends |cycles| quarter frame sequences starting from |time|, a
+ * quarter frame every 10 ms (25 fps). */
+static system_ticks_t TestSendQuarterFrames(
+    midi_clock_recovery_t *recovery, midi_time_t *time,
+    midi_time_direction_t direction, system_ticks_t start, size_t cycles) {
+  system_ticks_t now = start;
+  for (size_t cycle = 0; cycle < cycles; ++cycle) {
+    uint8_t data[MIDI_SERIALIZED_TIME_PAYLOAD_SIZE];
+    MidiSerializeTime(time, direction, data, sizeof(data));
+    for (size_t i = 0; i < sizeof(data); ++i) {
+      midi_time_code_t time_code;
+      MidiDeserializeTimeCode(&time_code, data[i]);
+      now = start + SystemTicksFromMicroseconds(
+          (cycle * sizeof(data) + i) * 10000);
+      TEST_ASSERT_TRUE(
+          MidiClockRecoveryQuarterFrame(recovery, &time_code, now));
+    }
+    MidiOffsetTime(time, (direction == MIDI_TIME_FORWARD) ? 2 : -2);
+  }
+  return now;
+}
+
+static void TestMidiClockRecovery_TimeCode(void) {
+  midi_clock_recovery_t recovery;
+  MidiInitializeClockRecovery(&recovery);
+  midi_time_t time;
+  MidiInitializeTime(&time);
+  time.fps = MIDI_25_FPS;
+  time.hours = 1;
+  system_ticks_t const last = TestSendQuarterFrames(
+      &recovery, &time, MIDI_TIME_FORWARD, SystemTicksFromSeconds(1), 3);
+  TEST_ASSERT_TRUE(MidiIsClockRecoveryLocked(
+      &recovery, MIDI_CLOCK_RECOVERY_QUARTER_FRAME, last));
+
+  /* The last sequence encoded 01:00:00:04, and its last quarter frame
+   * is 1.75 frames later. */
+  midi_frame_count_t frames;
+  uint8_t fraction;
+  TEST_ASSERT_TRUE(MidiGetClockRecoveryFrames(
+      &recovery, last, &frames, &fraction));
+  TEST_ASSERT_EQUAL(90005, frames);
+  TEST_ASSERT_UINT32_WITHIN(2, 192, fraction);
+  /* Half a quarter frame later. */
+  TEST_ASSERT_TRUE(MidiGetClockRecoveryFrames(
+      &recovery, last + SystemTicksFromMicroseconds(5000),
+      &frames, &fraction));
+  TEST_ASSERT_EQUAL(90005, frames);
+  TEST_ASSERT_UINT32_WITHIN(2, 224, fraction);
+
+  midi_clock_pll_stats_t stats;
+  TEST_ASSERT_TRUE(MidiGetClockRecoveryStats(
+      &recovery, MIDI_CLOCK_RECOVERY_QUARTER_FRAME, last, &stats));
+  TEST_ASSERT_EQUAL(24, stats.events);
+  TEST_ASSERT_EQUAL(10000000, stats.period_ns);
+  TEST_ASSERT_EQUAL(0, stats.jitter_us);
+}
+
+static void TestMidiClockRecovery_TimeCode_Reverse(void) {
+  midi_clock_recovery_t recovery;
+  MidiInitializeClockRecovery(&recovery);
+  midi_time_t time;
+  MidiInitializeTime(&time);
+  time.fps = MIDI_25_FPS;
+  system_ticks_t const last = TestSendQuarterFrames(
+      &recovery, &time, MIDI_TIME_REVERSE, SystemTicksFromSeconds(1), 2);
+
+  /* The last sequence encoded 23:59:59:23, and its last quarter frame
+   * is 1.75 frames earlier. */
+  midi_frame_count_t frames;
+  uint8_t fraction;
+  TEST_ASSERT_TRUE(MidiGetClockRecoveryFrames(
+      &recovery, last + SystemTicksFromMicroseconds(10000),
+      &frames, &fraction));
+  midi_time_t expected;
+  MidiInitializeTime(&expected);
+  expected.fps = MIDI_25_FPS;
+  MidiOffsetTime(&expected, -4);
+  midi_frame_count_t expected_frames;
+  MidiTimeToFrameCount(&expected, &expected_frames);
+  TEST_ASSERT_EQUAL(expected_frames, frames);
+  TEST_ASSERT_UINT32_WITHIN(2, 0, fraction);
+}
+
+void MidiClockRecoveryTest(void) {
+  RUN_TEST(TestMidiClockRecovery_Initializer);
+  RUN_TEST(TestMidiClockRecovery_Tempo);
+  RUN_TEST(TestMidiClockRecovery_Position);
+  RUN_TEST(TestMidiClockRecovery_TimeCode);
+  RUN_TEST(TestMidiClockRecovery_TimeCode_Reverse);
+}
@@ -0,0 +1,232 @@
+/*
+ * MIDI Controller - MIDI Compact Message Test.
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <string.h>
+#include <unity.h>
+
+#include "midi_callback_internal.h"
+#include "midi_compact.h"
+#include "midi_defs.h"
+#include "midi_serialize.h"
+#include "midi_transceiver.h"
+
+static void TestMidiCompact_Size(void) {
+  TEST_ASSERT_EQUAL(4, sizeof(midi_compact_message_t));
+  TEST_ASSERT_TRUE(sizeof(midi_compact_message_t) < sizeof(midi_message_t));
+}
+
+static void TestMidiCompact_Construct(void) {
+  midi_compact_message_t compact;
+  TEST_ASSERT_FALSE(MidiCompactMessage(NULL, MIDI_NOTE_ON, 0x40, 0x7F));
+  /* Data byte, reserved status, and SysEx. */
+  TEST_ASSERT_FALSE(MidiCompactMessage(&compact, 0x40, 0x40, 0x7F));
+  TEST_ASSERT_FALSE(MidiCompactMessage(&compact, 0xF4, 0x00, 0x00));
+  TEST_ASSERT_FALSE(
+      MidiCompactMessage(&compact, MIDI_SYSTEM_EXCLUSIVE, 0x00, 0x00));
+  /* Bad data byte. */
+  TEST_ASSERT_FALSE(MidiCompactMessage(&compact, MIDI_NOTE_ON, 0x80, 0x7F));
+
+  TEST_ASSERT_TRUE(MidiCompactMessage(
+      &compact, MIDI_NOTE_ON | MIDI_CHANNEL_5, 0x40, 0x7F));
+  TEST_ASSERT_TRUE(MidiIsValidCompactMessage(&compact));
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, MidiCompactMessageType(&compact));
+  TEST_ASSERT_EQUAL(MIDI_CHANNEL_5, MidiCompactMessageChannel(&compact));
+  TEST_ASSERT_EQUAL(2, compact.data_size);
+
+  /* Unused data bytes are ignored. */
+  TEST_ASSERT_TRUE(MidiCompactMessage(&compact, MIDI_TIMING_CLOCK, 0xFF, 0xFF));
+  TEST_ASSERT_TRUE(MidiIsValidCompactMessage(&compact));
+  TEST_ASSERT_EQUAL(0, compact.data_size);
+  TEST_ASSERT_EQUAL(0, compact.data[0]);
+  TEST_ASSERT_EQUAL(0, MidiCompactMessageChannel(&compact));
+
+  TEST_ASSERT_TRUE(MidiCompactMessage(
+      &compact, MIDI_PITCH_WHEEL | MIDI_CHANNEL_1, 0x01, 0x40));
+  TEST_ASSERT_EQUAL(0x2001, MidiCompactMessageDataWord(&compact));
+
+  compact.data_size = 1;
+  TEST_ASSERT_FALSE(MidiIsValidCompactMessage(&compact));
+  TEST_ASSERT_FALSE(MidiIsValidCompactMessage(NULL));
+}
+
+static void TestMidiCompact_Conversion(void) {
+  midi_message_t message;
+  midi_message_t result;
+  midi_compact_message_t compact;
+  midi_note_t note;
+  TEST_ASSERT_TRUE(MidiNote(&note, 0x3C, 0x64));
+  TEST_ASSERT_TRUE(MidiNoteOnMessage(&message, MIDI_CHANNEL_10, &note));
+
+  TEST_ASSERT_FALSE(MidiMessageToCompact(NULL, &compact));
+  TEST_ASSERT_FALSE(MidiMessageToCompact(&message, NULL));
+  TEST_ASSERT_TRUE(MidiMessageToCompact(&message, &compact));
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON | MIDI_CHANNEL_10, compact.status);
+  TEST_ASSERT_EQUAL(0x3C, compact.data[0]);
+  TEST_ASSERT_EQUAL(0x64, compact.data[1]);
+
+  TEST_ASSERT_TRUE(MidiCompactToMessage(&compact, &result));
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, result.type);
+  TEST_ASSERT_EQUAL(MIDI_CHANNEL_10, result.channel);
+  TEST_ASSERT_EQUAL(0x3C, result.note.key);
+  TEST_ASSERT_EQUAL(0x64, result.note.velocity);
+
+  TEST_ASSERT_TRUE(MidiSongPositionMessage(&message, 0x0126));
+  TEST_ASSERT_TRUE(MidiMessageToCompact(&message, &compact));
+  TEST_ASSERT_EQUAL(0x0126, MidiCompactMessageDataWord(&compact));
+  TEST_ASSERT_TRUE(MidiCompactToMessage(&compact, &result));
+  TEST_ASSERT_EQUAL(MIDI_SONG_POSITION_POINTER, result.type);
+  TEST_ASSERT_EQUAL(0x0126, result.song_position);
+
+  /* SysEx is not supported. */
+  memset(&message, 0, sizeof(message));
+  message.type = MIDI_SYSTEM_EXCLUSIVE;
+  TEST_ASSERT_FALSE(MidiMessageToCompact(&message, &compact));
+}
+
+static void TestMidiCompact_Serialize(void) {
+  static uint8_t const kControlChange[] = {
+    MIDI_CONTROL_CHANGE | MIDI_CHANNEL_2, 0x07, 0x50
+  };
+  midi_compact_message_t compact;
+  uint8_t data[4];
+  TEST_ASSERT_EQUAL(
+      sizeof(kControlChange),
+      MidiDeserializeCompactMessage(
+          kControlChange, sizeof(kControlChange), MIDI_NONE, &compact));
+  TEST_ASSERT_EQUAL(MIDI_CONTROL_CHANGE | MIDI_CHANNEL_2, compact.status);
+  /* Running status. */
+  TEST_ASSERT_EQUAL(
+      2, MidiDeserializeCompactMessage(
+          &kControlChange[1], 2, kControlChange[0], &compact));
+  TEST_ASSERT_EQUAL(0x50, compact.data[1]);
+  /* Incomplete. */
+  TEST_ASSERT_EQUAL(
+      3, MidiDeserializeCompactMessage(kControlChange, 2, MIDI_NONE, &compact));
+
+  TEST_ASSERT_TRUE(MidiCompactMessage(
+      &compact, kControlChange[0], kControlChange[1], kControlChange[2]));
+  memset(data, 0, sizeof(data));
+  TEST_ASSERT_EQUAL(
+      sizeof(kControlChange),
+      MidiSerializeCompactMessage(&compact, false, data, sizeof(data)));
+  TEST_ASSERT_EQUAL_MEMORY(kControlChange, data, sizeof(kControlChange));
+  TEST_ASSERT_EQUAL(
+      2, MidiSerializeCompactMessage(&compact, true, data, sizeof(data)));
+  TEST_ASSERT_EQUAL(
+      3, MidiSerializeCompactMessage(&compact, false, data, 1));
+
+  /* SysEx is not supported. */
+  data[0] = MIDI_SYSTEM_EXCLUSIVE;
+  data[1] = MIDI_END_SYSTEM_EXCLUSIVE;
+  TEST_ASSERT_EQUAL(
+      0, MidiDeserializeCompactMessage(data, 2, MIDI_NONE, &compact));
+}
+
+static size_t sCompactMessageCount = 0;
+static midi_compact_message_t sLastCompactMessage;
+
+static void CompactMessageCallback(
+    midi_rx_event_t const *rx_event, midi_compact_message_t const *compact) {
+  TEST_ASSERT_NOT_NULL(rx_event);
+  TEST_ASSERT_NULL(rx_event->message);
+  ++sCompactMessageCount;
+  sLastCompactMessage = *compact;
+}
+
+static void TestMidiCompact_Receiver(void) {
+  static uint8_t const kStream[] = {
+    MIDI_NOTE_ON | MIDI_CHANNEL_1, 0x40, MIDI_TIMING_CLOCK, 0x7F,
+    /* Running status. */
+    0x41, 0x7F,
+    /* SysEx is skipped. */
+    MIDI_SYSTEM_EXCLUSIVE, 0x7D, 0x01, 0x02, MIDI_END_SYSTEM_EXCLUSIVE,
+    0x42, 0x7F,
+    MIDI_TUNE_REQUEST,
+    MIDI_PROGRAM_CHANGE | MIDI_CHANNEL_3, 0x05
+  };
+  midi_compact_rx_ctx_t rx_ctx;
+  midi_compact_message_t messages[8];
+  midi_callbacks_t callbacks;
+  size_t consumed = 0;
+  TEST_ASSERT_FALSE(MidiInitializeCompactReceiverCtx(NULL, NULL));
+  TEST_ASSERT_TRUE(MidiInitializeCompactReceiverCtx(&rx_ctx, NULL));
+
+  TEST_ASSERT_EQUAL(
+      5, MidiReceiveCompactData(
+          &rx_ctx, kStream, sizeof(kStream), messages, 8, &consumed));
+  TEST_ASSERT_EQUAL(sizeof(kStream), consumed);
+  TEST_ASSERT_EQUAL(MIDI_TIMING_CLOCK, messages[0].status);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON | MIDI_CHANNEL_1, messages[1].status);
+  TEST_ASSERT_EQUAL(0x40, messages[1].data[0]);
+  TEST_ASSERT_EQUAL(0x41, messages[2].data[0]);
+  TEST_ASSERT_EQUAL(MIDI_TUNE_REQUEST, messages[3].status);
+  TEST_ASSERT_EQUAL(MIDI_PROGRAM_CHANGE | MIDI_CHANNEL_3, messages[4].status);
+  TEST_ASSERT_EQUAL(0x05, messages[4].data[0]);
+  for (size_t i = 0; i < 5; ++i) {
+    TEST_ASSERT_TRUE(MidiIsValidCompactMessage(&messages[i]));
+  }
+
+  /* Stops at |max_messages|. */
+  TEST_ASSERT_TRUE(MidiInitializeCompactReceiverCtx(&rx_ctx, NULL));
+  TEST_ASSERT_EQUAL(
+      1, MidiReceiveCompactData(
+          &rx_ctx, kStream, sizeof(kStream), messages, 1, &consumed));
+  TEST_ASSERT_EQUAL(3, consumed);
+
+  /* Dispatched to callbacks. */
+  MidiInitializeCallbacks(&callbacks);
+  callbacks.rx.OnCompactMessage = CompactMessageCallback;
+  sCompactMessageCount = 0;
+  TEST_ASSERT_TRUE(MidiInitializeCompactReceiverCtx(&rx_ctx, &callbacks));
+  TEST_ASSERT_EQUAL(
+      5, MidiReceiveCompactData(
+          &rx_ctx, kStream, sizeof(kStream), messages, 8, NULL));
+  TEST_ASSERT_EQUAL(5, sCompactMessageCount);
+  TEST_ASSERT_EQUAL(
+      MIDI_PROGRAM_CHANGE | MIDI_CHANNEL_3, sLastCompactMessage.status);
+}
+
+static void TestMidiCompact_ReceiverInvalidCallbacks(void) {
+  midi_compact_rx_ctx_t rx_ctx;
+  midi_callbacks_t callbacks;
+  /* Uninitialized callbacks are rejected. */
+  memset(&callbacks, 0, sizeof(callbacks));
+  TEST_ASSERT_FALSE(MidiInitializeCompactReceiverCtx(&rx_ctx, &callbacks));
+  MidiInitializeCallbacks(&callbacks);
+  TEST_ASSERT_TRUE(MidiInitializeCompactReceiverCtx(&rx_ctx, &callbacks));
+  TEST_ASSERT_EQUAL_PTR(&callbacks, rx_ctx.callbacks);
+}
+
+static void TestMidiCompact_Transmitter(void) {
+  static uint8_t const kExpected[] = {
+    MIDI_NOTE_ON | MIDI_CHANNEL_1, 0x40, 0x7F, 0x41, 0x7F
+  };
+  midi_tx_ctx_t tx_ctx;
+  midi_compact_message_t compact;
+  uint8_t data[8];
+  size_t di = 0;
+  TEST_ASSERT_TRUE(MidiInitializeTransmitterCtx(&tx_ctx, true));
+  TEST_ASSERT_TRUE(MidiCompactMessage(
+      &compact, MIDI_NOTE_ON | MIDI_CHANNEL_1, 0x40, 0x7F));
+  di += MidiTransmitterSerializeCompactMessage(
+      &tx_ctx, &compact, &data[di], sizeof(data) - di);
+  compact.data[0] = 0x41;
+  di += MidiTransmitterSerializeCompactMessage(
+      &tx_ctx, &compact, &data[di], sizeof(data) - di);
+  TEST_ASSERT_EQUAL(sizeof(kExpected), di);
+  TEST_ASSERT_EQUAL_MEMORY(kExpected, data, sizeof(kExpected));
+}
+
+void MidiCompactTest(void) {
+  RUN_TEST(TestMidiCompact_Size);
+  RUN_TEST(TestMidiCompact_Construct);
+  RUN_TEST(TestMidiCompact_Conversion);
+  RUN_TEST(TestMidiCompact_Serialize);
+  RUN_TEST(TestMidiCompact_Receiver);
+  RUN_TEST(TestMidiCompact_ReceiverInvalidCallbacks);
+  RUN_TEST(TestMidiCompact_Transmitter);
+}
@@ -0,0 +1,251 @@
+/*
+ * MIDI Controller - MIDI Deferred Event Queue Test.
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <string.h>
+#include <unity.h>
+
+#include "midi_callback_internal.h"
+#include "midi_defs.h"
+#include "midi_event_queue.h"
+
+#define TEST_SCHEDULER_EVENT 0x12
+
+typedef struct {
+  size_t count;
+  uint32_t event_ids[MIDI_EVENT_QUEUE_SIZE * 2];
+  midi_message_t messages[MIDI_EVENT_QUEUE_SIZE * 2];
+  bool_t has_time;
+} deferred_ctx_t;
+
+static void DeferredMessageCallback(midi_rx_event_t const *rx_event) {
+  deferred_ctx_t *ctx = (deferred_ctx_t *) rx_event->user_ctx;
+  ctx->event_ids[ctx->count] = rx_event->general.event_id;
+  ctx->has_time = (rx_event->general.time != NULL);
+  memcpy(&ctx->messages[ctx->count], rx_event->message,
+         sizeof(midi_message_t));
+  ++ctx->count;
+}
+
+static void InitializeDeferredCallbacks(
+    midi_callbacks_t *callbacks, deferred_ctx_t *ctx) {
+  MidiInitializeCallbacks(callbacks);
+  memset(ctx, 0, sizeof(deferred_ctx_t));
+  callbacks->rx.OnMessage = DeferredMessageCallback;
+  callbacks->rx.message_ctx = ctx;
+}
+
+static void ControlChange(
+    midi_message_t *message, uint8_t number, uint8_t value) {
+  memset(message, 0, sizeof(midi_message_t));
+  message->type = MIDI_CONTROL_CHANGE;
+  message->channel = MIDI_CHANNEL_2;
+  message->control.number = number;
+  message->control.value = value;
+}
+
+static void TestMidiEventQueue_Initialize(void) {
+  midi_event_queue_t queue;
+  midi_callbacks_t callbacks;
+  MidiInitializeCallbacks(&callbacks);
+  TEST_ASSERT_FALSE(MidiInitializeEventQueue(
+      NULL, &callbacks, MIDI_EVENT_QUEUE_DROP_OLDEST));
+  TEST_ASSERT_FALSE(MidiInitializeEventQueue(
+      &queue, NULL, MIDI_EVENT_QUEUE_DROP_OLDEST));
+  TEST_ASSERT_FALSE(MidiInitializeEventQueue(&queue, &callbacks, 0x10));
+  TEST_ASSERT_TRUE(MidiInitializeEventQueue(
+      &queue, &callbacks, MIDI_EVENT_QUEUE_DROP_OLDEST));
+  TEST_ASSERT_TRUE(MidiEventQueueIsEmpty(&queue));
+
+  midi_callbacks_t other_callbacks;
+  MidiInitializeCallbacks(&other_callbacks);
+  TEST_ASSERT_FALSE(MidiSetEventQueue(NULL, &queue));
+  TEST_ASSERT_FALSE(MidiSetEventQueue(&other_callbacks, &queue));
+  TEST_ASSERT_TRUE(MidiSetEventQueue(&callbacks, &queue));
+  TEST_ASSERT_EQUAL(&queue, callbacks.event_queue);
+  TEST_ASSERT_TRUE(MidiSetEventQueue(&callbacks, NULL));
+  TEST_ASSERT_NULL(callbacks.event_queue);
+}
+
+static void TestMidiEventQueue_DeferredDispatch(void) {
+  midi_event_queue_t queue;
+  midi_callbacks_t callbacks;
+  deferred_ctx_t ctx;
+  InitializeDeferredCallbacks(&callbacks, &ctx);
+  TEST_ASSERT_TRUE(MidiInitializeEventQueue(
+      &queue, &callbacks, MIDI_EVENT_QUEUE_DROP_OLDEST));
+  TEST_ASSERT_TRUE(MidiSetEventQueue(&callbacks, &queue));
+
+  midi_message_t const kNoteOnMessage = {
+    .type = MIDI_NOTE_ON,
+    .channel = MIDI_CHANNEL_4,
+    .note = { .key = MIDI_MIDDLE_C, .velocity = MIDI_NOTE_ON_VELOCITY }
+  };
+  midi_message_t const kClockMessage = { .type = MIDI_TIMING_CLOCK };
+  midi_time_t time;
+  MidiInitializeTime(&time);
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(
+      &callbacks, &time, &kNoteOnMessage));
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(
+      &callbacks, NULL, &kClockMessage));
+  /* Captured, not dispatched.  Event IDs are assigned on capture. */
+  TEST_ASSERT_EQUAL(0, ctx.count);
+  TEST_ASSERT_EQUAL(2, MidiEventQueueCount(&queue));
+  TEST_ASSERT_EQUAL(3, callbacks.next_event_id);
+  TEST_ASSERT_EQUAL(3, callbacks.rx.next_rx_event_id);
+
+  TEST_ASSERT_EQUAL(1, MidiDrainEventQueue(&queue, 1));
+  TEST_ASSERT_EQUAL(1, ctx.count);
+  TEST_ASSERT_EQUAL(1, ctx.event_ids[0]);
+  TEST_ASSERT_TRUE(ctx.has_time);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, ctx.messages[0].type);
+  TEST_ASSERT_EQUAL(MIDI_CHANNEL_4, ctx.messages[0].channel);
+  TEST_ASSERT_EQUAL(MIDI_MIDDLE_C, ctx.messages[0].note.key);
+
+  TEST_ASSERT_EQUAL(1, MidiDrainEventQueue(&queue, 4));
+  TEST_ASSERT_EQUAL(2, ctx.count);
+  TEST_ASSERT_EQUAL(2, ctx.event_ids[1]);
+  TEST_ASSERT_FALSE(ctx.has_time);
+  TEST_ASSERT_EQUAL(MIDI_TIMING_CLOCK, ctx.messages[1].type);
+  TEST_ASSERT_TRUE(MidiEventQueueIsEmpty(&queue));
+  TEST_ASSERT_EQUAL(0, MidiDrainEventQueue(&queue, 4));
+  /* Draining does not change the counters. */
+  TEST_ASSERT_EQUAL(3, callbacks.next_event_id);
+}
+
+static void TestMidiEventQueue_SysExNotQueued(void) {
+  midi_event_queue_t queue;
+  midi_callbacks_t callbacks;
+  deferred_ctx_t ctx;
+  InitializeDeferredCallbacks(&callbacks, &ctx);
+  TEST_ASSERT_TRUE(MidiInitializeEventQueue(
+      &queue, &callbacks, MIDI_EVENT_QUEUE_DROP_OLDEST));
+  TEST_ASSERT_TRUE(MidiSetEventQueue(&callbacks, &queue));
+  midi_message_t message = {
+    .type = MIDI_SYSTEM_EXCLUSIVE
+  };
+  TEST_ASSERT_FALSE(MidiEventQueueCapture(&queue, 1, 1, NULL, 0, &message));
+  message.type = MIDI_SYSTEM_RESET;
+  TEST_ASSERT_FALSE(MidiEventQueueCapture(&queue, 1, 1, NULL, 0, &message));
+  TEST_ASSERT_TRUE(MidiEventQueueIsEmpty(&queue));
+}
+
+static void TestMidiEventQueue_DropOldest(void) {
+  midi_event_queue_t queue;
+  midi_callbacks_t callbacks;
+  deferred_ctx_t ctx;
+  InitializeDeferredCallbacks(&callbacks, &ctx);
+  TEST_ASSERT_TRUE(MidiInitializeEventQueue(
+      &queue, &callbacks, MIDI_EVENT_QUEUE_DROP_OLDEST));
+  TEST_ASSERT_TRUE(MidiSetEventQueue(&callbacks, &queue));
+  midi_message_t message;
+  for (uint8_t i = 0; i < MIDI_EVENT_QUEUE_SIZE + 2; ++i) {
+    ControlChange(&message, i, 0x10);
+    TEST_ASSERT_TRUE(MidiCallOnMessageCallback(&callbacks, NULL, &message));
+  }
+  TEST_ASSERT_EQUAL(MIDI_EVENT_QUEUE_SIZE, MidiEventQueueCount(&queue));
+  TEST_ASSERT_EQUAL(2, queue.dropped);
+  TEST_ASSERT_EQUAL(MIDI_EVENT_QUEUE_SIZE, queue.max_count);
+  TEST_ASSERT_EQUAL(MIDI_EVENT_QUEUE_SIZE,
+      MidiDrainEventQueue(&queue, MIDI_EVENT_QUEUE_SIZE * 2));
+  TEST_ASSERT_EQUAL(2, ctx.messages[0].control.number);
+  TEST_ASSERT_EQUAL(3, ctx.event_ids[0]);
+  TEST_ASSERT_EQUAL(MIDI_EVENT_QUEUE_SIZE + 1,
+      ctx.messages[MIDI_EVENT_QUEUE_SIZE - 1].control.number);
+}
+
+static void TestMidiEventQueue_DropNewest(void) {
+  midi_event_queue_t queue;
+  midi_callbacks_t callbacks;
+  deferred_ctx_t ctx;
+  InitializeDeferredCallbacks(&callbacks, &ctx);
+  TEST_ASSERT_TRUE(MidiInitializeEventQueue(
+      &queue, &callbacks, MIDI_EVENT_QUEUE_DROP_NEWEST));
+  TEST_ASSERT_TRUE(MidiSetEventQueue(&callbacks, &queue));
+  midi_message_t message;
+  for (uint8_t i = 0; i < MIDI_EVENT_QUEUE_SIZE + 2; ++i) {
+    ControlChange(&message, i, 0x10);
+    TEST_ASSERT_TRUE(MidiCallOnMessageCallback(&callbacks, NULL, &message));
+  }
+  TEST_ASSERT_EQUAL(2, queue.dropped);
+  TEST_ASSERT_EQUAL(MIDI_EVENT_QUEUE_SIZE,
+      MidiDrainEventQueue(&queue, MIDI_EVENT_QUEUE_SIZE * 2));
+  TEST_ASSERT_EQUAL(0, ctx.messages[0].control.number);
+  TEST_ASSERT_EQUAL(MIDI_EVENT_QUEUE_SIZE - 1,
+      ctx.messages[MIDI_EVENT_QUEUE_SIZE - 1].control.number);
+}
+
+static void TestMidiEventQueue_CoalesceControlChange(void) {
+  midi_event_queue_t queue;
+  midi_callbacks_t callbacks;
+  deferred_ctx_t ctx;
+  InitializeDeferredCallbacks(&callbacks, &ctx);
+  TEST_ASSERT_TRUE(MidiInitializeEventQueue(
+      &queue, &callbacks, MIDI_EVENT_QUEUE_COALESCE_CC));
+  TEST_ASSERT_TRUE(MidiSetEventQueue(&callbacks, &queue));
+  midi_message_t message;
+  for (uint8_t i = 0; i < MIDI_EVENT_QUEUE_SIZE; ++i) {
+    ControlChange(&message, i % 4, i);
+    TEST_ASSERT_TRUE(MidiCallOnMessageCallback(&callbacks, NULL, &message));
+  }
+  /* Replaces the value of the last queued controller 1. */
+  ControlChange(&message, 1, 0x7F);
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(&callbacks, NULL, &message));
+  TEST_ASSERT_EQUAL(1, queue.coalesced);
+  /* No matching controller, dropped. */
+  ControlChange(&message, 5, 0x7F);
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(&callbacks, NULL, &message));
+  TEST_ASSERT_EQUAL(1, queue.dropped);
+
+  TEST_ASSERT_EQUAL(MIDI_EVENT_QUEUE_SIZE,
+      MidiDrainEventQueue(&queue, MIDI_EVENT_QUEUE_SIZE * 2));
+  TEST_ASSERT_EQUAL(1, ctx.messages[1].control.number);
+  TEST_ASSERT_EQUAL(1, ctx.messages[1].control.value);
+  TEST_ASSERT_EQUAL(1, ctx.messages[MIDI_EVENT_QUEUE_SIZE - 3].control.number);
+  TEST_ASSERT_EQUAL(0x7F,
+      ctx.messages[MIDI_EVENT_QUEUE_SIZE - 3].control.value);
+  TEST_ASSERT_EQUAL(MIDI_EVENT_QUEUE_SIZE + 1,
+      ctx.event_ids[MIDI_EVENT_QUEUE_SIZE - 3]);
+}
+
+static void TestMidiEventQueue_Scheduler(void) {
+  static system_time_t const kInitTime = { .seconds = 10 };
+  midi_event_queue_t queue;
+  midi_callbacks_t callbacks;
+  deferred_ctx_t ctx;
+  scheduler_t scheduler;
+  InitializeDeferredCallbacks(&callbacks, &ctx);
+  TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &kInitTime));
+  TEST_ASSERT_TRUE(MidiInitializeEventQueue(
+      &queue, &callbacks, MIDI_EVENT_QUEUE_DROP_OLDEST));
+  TEST_ASSERT_FALSE(MidiEventQueueAttachScheduler(
+      &queue, NULL, TEST_SCHEDULER_EVENT));
+  TEST_ASSERT_TRUE(MidiEventQueueAttachScheduler(
+      &queue, &scheduler, TEST_SCHEDULER_EVENT));
+  TEST_ASSERT_TRUE(MidiSetEventQueue(&callbacks, &queue));
+
+  /* Nothing to do before a message is captured. */
+  TEST_ASSERT_EQUAL(0, SchedulerDoCallbacks(&scheduler, &kInitTime));
+  midi_message_t message;
+  ControlChange(&message, 7, 0x40);
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(&callbacks, NULL, &message));
+  TEST_ASSERT_TRUE(MidiCallOnMessageCallback(&callbacks, NULL, &message));
+  TEST_ASSERT_EQUAL(0, ctx.count);
+  TEST_ASSERT_EQUAL(1, SchedulerDoCallbacks(&scheduler, &kInitTime));
+  TEST_ASSERT_EQUAL(2, ctx.count);
+  TEST_ASSERT_TRUE(MidiEventQueueIsEmpty(&queue));
+  TEST_ASSERT_EQUAL(0, SchedulerDoCallbacks(&scheduler, &kInitTime));
+}
+
+void MidiEventQueueTest(void) {
+  RUN_TEST(TestMidiEventQueue_Initialize);
+  RUN_TEST(TestMidiEventQueue_DeferredDispatch);
+  RUN_TEST(TestMidiEventQueue_SysExNotQueued);
+  RUN_TEST(TestMidiEventQueue_DropOldest);
+  RUN_TEST(TestMidiEventQueue_DropNewest);
+  RUN_TEST(TestMidiEventQueue_CoalesceControlChange);
+  RUN_TEST(TestMidiEventQueue_Scheduler);
+}
@@ -211,6 +211,78 @@ static void TestMidiFrame_Clearing(void) {
   TEST_ASSERT_TRUE(MidiFrameBufferEmpty(&frame));
 }
 
+static void TestMidiFrame_PartialOverwrite(void) {
+  static size_t const kQuarterBuffer = MIDI_FRAME_BUFFER_SIZE / 4;
+  midi_frame_buffer_t frame;
+  uint8_t buffer[MIDI_FRAME_BUFFER_SIZE];
+  TEST_ASSERT_TRUE(MidiInitializeFrameBuffer(&frame));
+
+  /* Oldest data is overwritten when a put does not fit. */
+  TEST_ASSERT_EQUAL(
+      kQuarterBuffer * 3,
+      MidiPutFrameBufferData(gTestData, kQuarterBuffer * 3, &frame));
+  TEST_ASSERT_EQUAL(
+      kQuarterBuffer * 2,
+      MidiPutFrameBufferData(
+          &gTestData[kQuarterBuffer * 3], kQuarterBuffer * 2, &frame));
+  TEST_ASSERT_TRUE(MidiFrameBufferFull(&frame));
+  TEST_ASSERT_EQUAL(
+      MIDI_FRAME_BUFFER_SIZE,
+      MidiTakeFrameBufferData(&frame, buffer, sizeof(buffer)));
+  TEST_ASSERT_EQUAL_MEMORY(
+      &gTestData[kQuarterBuffer], buffer, MIDI_FRAME_BUFFER_SIZE);
+}
+
+static void TestMidiFrame_Spans(void) {
+  static size_t const kHalfBuffer = MIDI_FRAME_BUFFER_SIZE / 2;
+  midi_frame_buffer_t frame;
+  uint8_t *write_span = NULL;
+  uint8_t const *read_span = NULL;
+  TEST_ASSERT_TRUE(MidiInitializeFrameBuffer(&frame));
+  TEST_ASSERT_EQUAL(0, MidiGetFrameBufferWriteSpan(NULL, &write_span));
+  TEST_ASSERT_EQUAL(0, MidiGetFrameBufferWriteSpan(&frame, NULL));
+  TEST_ASSERT_EQUAL(0, MidiGetFrameBufferReadSpan(NULL, &read_span));
+  TEST_ASSERT_EQUAL(0, MidiCommitFrameBufferData(NULL, 1));
+
+  TEST_ASSERT_EQUAL(0, MidiGetFrameBufferReadSpan(&frame, &read_span));
+  TEST_ASSERT_EQUAL(
+      MIDI_FRAME_BUFFER_SIZE,
+      MidiGetFrameBufferWriteSpan(&frame, &write_span));
+  memcpy(write_span, gTestData, MIDI_FRAME_BUFFER_SIZE);
+  /* Cannot commit more than is available. */
+  TEST_ASSERT_EQUAL(
+      MIDI_FRAME_BUFFER_SIZE,
+      MidiCommitFrameBufferData(&frame, MIDI_FRAME_BUFFER_SIZE + 1));
+  TEST_ASSERT_TRUE(MidiFrameBufferFull(&frame));
+  TEST_ASSERT_EQUAL(0, MidiGetFrameBufferWriteSpan(&frame, &write_span));
+
+  TEST_ASSERT_EQUAL(
+      MIDI_FRAME_BUFFER_SIZE,
+      MidiGetFrameBufferReadSpan(&frame, &read_span));
+  TEST_ASSERT_EQUAL_MEMORY(gTestData, read_span, MIDI_FRAME_BUFFER_SIZE);
+  TEST_ASSERT_EQUAL(
+      kHalfBuffer, MidiClearFrameBufferData(&frame, kHalfBuffer));
+
+  /* Free space is before the front. */
+  TEST_ASSERT_EQUAL(
+      kHalfBuffer, MidiGetFrameBufferWriteSpan(&frame, &write_span));
+  TEST_ASSERT_EQUAL_PTR(frame.buffer, write_span);
+  memcpy(write_span, &gTestData[MIDI_FRAME_BUFFER_SIZE], 4);
+  TEST_ASSERT_EQUAL(4, MidiCommitFrameBufferData(&frame, 4));
+
+  /* Wrapped data is read in two spans. */
+  TEST_ASSERT_EQUAL(
+      kHalfBuffer, MidiGetFrameBufferReadSpan(&frame, &read_span));
+  TEST_ASSERT_EQUAL_MEMORY(&gTestData[kHalfBuffer], read_span, kHalfBuffer);
+  TEST_ASSERT_EQUAL(
+      kHalfBuffer, MidiClearFrameBufferData(&frame, kHalfBuffer));
+  TEST_ASSERT_EQUAL(4, MidiGetFrameBufferReadSpan(&frame, &read_span));
+  TEST_ASSERT_EQUAL_MEMORY(
+      &gTestData[MIDI_FRAME_BUFFER_SIZE], read_span, 4);
+  TEST_ASSERT_EQUAL(4, MidiClearFrameBufferData(&frame, 4));
+  TEST_ASSERT_TRUE(MidiFrameBufferEmpty(&frame));
+}
+
 void MidiFrameTest(void) {
   IntializeMidiFrameBufferTest();
   RUN_TEST(TestMidiFrame_Info);
@@ -219,4 +291,6 @@ void MidiFrameTest(void) {
   RUN_TEST(TestMidiFrame_LargeInput);
   RUN_TEST(TestMidiFrame_PartialInput);
   RUN_TEST(TestMidiFrame_Clearing);
+  RUN_TEST(TestMidiFrame_PartialOverwrite);
+  RUN_TEST(TestMidiFrame_Spans);
 }
@@ -0,0 +1,69 @@
+/*
+ * MIDI Controller - MIDI Status Byte Info Benchmark
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifdef _BENCHMARK_ENABLED
+
+#include <unity.h>
+
+#include "benchmark.h"
+#include "midi_defs.h"
+#include "midi_message.h"
+#include "midi_serialize.h"
+
+#define BENCHMARK_STREAM_SIZE 4096
+#define BENCHMARK_ROUNDS      2000
+
+static uint8_t sStream[BENCHMARK_STREAM_SIZE];
+
+static void InitializeStream(void) {
+  /* Deterministic mix of status and data bytes. */
+  uint32_t seed = 0x1234567;
+  for (size_t i = 0; i < BENCHMARK_STREAM_SIZE; ++i) {
+    seed = seed * 1103515245 + 12345;
+    sStream[i] = (uint8_t) (seed >> 16);
+  }
+}
+
+/* Only uses functions which predate the status info table, so that
+ * the same benchmark can be run against older revisions. */
+static void BenchmarkMidiStatus_Classify(void) {
+  benchmark_t benchmark;
+  uint32_t sink = 0;
+  BenchmarkStart(&benchmark, "MidiStatus/classify");
+  for (uint32_t round = 0; round < BENCHMARK_ROUNDS; ++round) {
+    for (size_t i = 0; i < BENCHMARK_STREAM_SIZE; ++i) {
+      midi_message_type_t const type = MidiStatusToMessageType(sStream[i]);
+      sink += type + MidiMessageDataSize(type)
+          + MidiIsChannelMessageType(type);
+    }
+  }
+  BenchmarkStop(&benchmark, BENCHMARK_ROUNDS * BENCHMARK_STREAM_SIZE);
+  gBenchmarkSink = sink;
+}
+
+static void BenchmarkMidiStatus_Deserialize(void) {
+  benchmark_t benchmark;
+  midi_message_t message;
+  uint32_t sink = 0;
+  BenchmarkStart(&benchmark, "MidiStatus/deserialize");
+  for (uint32_t round = 0; round < BENCHMARK_ROUNDS; ++round) {
+    for (size_t i = 0; i < BENCHMARK_STREAM_SIZE; ++i) {
+      sink += MidiDeserializeMessage(
+          &sStream[i], BENCHMARK_STREAM_SIZE - i, MIDI_NONE, &message);
+    }
+  }
+  BenchmarkStop(&benchmark, BENCHMARK_ROUNDS * BENCHMARK_STREAM_SIZE);
+  gBenchmarkSink = sink;
+}
+
+void MidiStatusBenchmark(void) {
+  InitializeStream();
+  RUN_TEST(BenchmarkMidiStatus_Classify);
+  RUN_TEST(BenchmarkMidiStatus_Deserialize);
+}
+
+#endif  /* _BENCHMARK_ENABLED */
@@ -0,0 +1,78 @@
+/*
+ * MIDI Controller - MIDI Status Byte Info
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <unity.h>
+
+#include "midi_defs.h"
+#include "midi_status.h"
+
+static void TestMidiStatusInfo_DataBytes(void) {
+  midi_status_info_t info;
+  for (uint16_t byte = 0x00; byte < 0x80; ++byte) {
+    MidiGetStatusInfo(byte, &info);
+    TEST_ASSERT_EQUAL(MIDI_NONE, info.type);
+    TEST_ASSERT_EQUAL(0, info.flags);
+  }
+}
+
+static void TestMidiStatusInfo_ChannelBytes(void) {
+  midi_status_info_t info;
+  for (uint16_t byte = 0x80; byte < 0xF0; ++byte) {
+    MidiGetStatusInfo(byte, &info);
+    TEST_ASSERT_EQUAL(byte & 0xF0, info.type);
+    TEST_ASSERT_TRUE(MidiStatusInfoIsDefined(&info));
+    TEST_ASSERT_TRUE(MidiStatusInfoIsChannel(&info));
+    TEST_ASSERT_FALSE(MidiStatusInfoIsSystem(&info));
+    TEST_ASSERT_FALSE(MidiStatusInfoIsRealtime(&info));
+    TEST_ASSERT_FALSE(MidiStatusInfoIsVariableSize(&info));
+  }
+  MidiGetStatusInfo(MIDI_NOTE_ON | MIDI_CHANNEL_10, &info);
+  TEST_ASSERT_EQUAL(2, MidiStatusInfoDataSize(&info));
+  MidiGetStatusInfo(MIDI_PROGRAM_CHANGE | MIDI_CHANNEL_3, &info);
+  TEST_ASSERT_EQUAL(1, MidiStatusInfoDataSize(&info));
+  MidiGetStatusInfo(MIDI_CHANNEL_PRESSURE | MIDI_CHANNEL_16, &info);
+  TEST_ASSERT_EQUAL(1, MidiStatusInfoDataSize(&info));
+  MidiGetStatusInfo(MIDI_PITCH_WHEEL | MIDI_CHANNEL_1, &info);
+  TEST_ASSERT_EQUAL(2, MidiStatusInfoDataSize(&info));
+}
+
+static void TestMidiStatusInfo_SystemBytes(void) {
+  midi_status_info_t info;
+  for (uint16_t byte = 0xF0; byte <= 0xFF; ++byte) {
+    MidiGetStatusInfo(byte, &info);
+    TEST_ASSERT_EQUAL(byte, info.type);
+    TEST_ASSERT_TRUE(MidiStatusInfoIsSystem(&info));
+    TEST_ASSERT_FALSE(MidiStatusInfoIsChannel(&info));
+    TEST_ASSERT_EQUAL(byte >= 0xF8, MidiStatusInfoIsRealtime(&info));
+  }
+  MidiGetStatusInfo(MIDI_SYSTEM_EXCLUSIVE, &info);
+  TEST_ASSERT_TRUE(MidiStatusInfoIsVariableSize(&info));
+  MidiGetStatusInfo(MIDI_TIME_CODE, &info);
+  TEST_ASSERT_EQUAL(1, MidiStatusInfoDataSize(&info));
+  MidiGetStatusInfo(MIDI_SONG_POSITION_POINTER, &info);
+  TEST_ASSERT_EQUAL(2, MidiStatusInfoDataSize(&info));
+  MidiGetStatusInfo(MIDI_TUNE_REQUEST, &info);
+  TEST_ASSERT_EQUAL(0, MidiStatusInfoDataSize(&info));
+  MidiGetStatusInfo(MIDI_TIMING_CLOCK, &info);
+  TEST_ASSERT_TRUE(MidiStatusInfoIsDefined(&info));
+  TEST_ASSERT_EQUAL(0, MidiStatusInfoDataSize(&info));
+  /* Reserved */
+  MidiGetStatusInfo(0xF4, &info);
+  TEST_ASSERT_FALSE(MidiStatusInfoIsDefined(&info));
+  MidiGetStatusInfo(0xF5, &info);
+  TEST_ASSERT_FALSE(MidiStatusInfoIsDefined(&info));
+  MidiGetStatusInfo(0xF9, &info);
+  TEST_ASSERT_FALSE(MidiStatusInfoIsDefined(&info));
+  MidiGetStatusInfo(0xFD, &info);
+  TEST_ASSERT_FALSE(MidiStatusInfoIsDefined(&info));
+}
+
+void MidiStatusTest(void) {
+  RUN_TEST(TestMidiStatusInfo_DataBytes);
+  RUN_TEST(TestMidiStatusInfo_ChannelBytes);
+  RUN_TEST(TestMidiStatusInfo_SystemBytes);
+}
@@ -298,7 +298,14 @@ static void TestMidiStandardSysEx_Initializer(void) {
   TEST_ASSERT_EQUAL(0x60, sys_ex.device_id);
   TEST_ASSERT_EQUAL(MIDI_SAMPLE_DUMP_EXT, sys_ex.sub_id);
 
-  /* TODO: Test realtime. */
+  /* Realtime. */
+  TEST_ASSERT_FALSE(MidiInitializeSysUni(
+      &sys_ex, true, 0x40, MIDI_SAMPLE_DUMP_EXT));
+  TEST_ASSERT_TRUE(MidiInitializeSysUni(
+      &sys_ex, true, MIDI_ALL_CALL, MIDI_RT_TIME_CODE));
+  TEST_ASSERT_EQUAL(MIDI_REAL_TIME_ID, sys_ex.id[0]);
+  TEST_ASSERT_EQUAL(MIDI_ALL_CALL, sys_ex.device_id);
+  TEST_ASSERT_EQUAL(MIDI_RT_TIME_CODE, sys_ex.sub_id);
 }
 
 static void TestMidiSysEx_Serialize(void) {
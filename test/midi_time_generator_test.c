@@ -0,0 +1,299 @@
+/*
+ * MIDI Controller - MIDI Time Code Generator Test
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <string.h>
+#include <unity.h>
+
+#include "scheduler.h"
+#include "system_time.h"
+
+#include "midi_defs.h"
+#include "midi_time_generator.h"
+#include "midi_time_tracker.h"
+
+#define TEST_MAX_MESSAGES 16
+
+typedef struct {
+  midi_message_t messages[TEST_MAX_MESSAGES];
+  size_t message_count;
+  uint32_t quarter_frames;
+  midi_time_tracker_t tracker;
+  midi_time_t tracked_time;
+  uint32_t tracked_updates;
+} test_sent_t;
+
+static void TestSend(void *ctx, midi_message_t const *message) {
+  test_sent_t *sent = (test_sent_t *) ctx;
+  if (sent->message_count < TEST_MAX_MESSAGES) {
+    memcpy(&sent->messages[sent->message_count++], message,
+           sizeof(midi_message_t));
+  }
+  if (message->type != MIDI_TIME_CODE) return;
+  ++sent->quarter_frames;
+  bool_t updated = false;
+  midi_time_direction_t direction;
+  MidiUpdateTimeTracker(
+      &sent->tracker, &message->time_code, &updated,
+      &sent->tracked_time, &direction);
+  if (updated) ++sent->tracked_updates;
+}
+
+static void TestInitializeSent(test_sent_t *sent) {
+  memset(sent, 0, sizeof(test_sent_t));
+  MidiInitializeTimeTracker(&sent->tracker);
+}
+
+static void TestSetTime(
+    midi_time_t *time, uint8_t hours, uint8_t minutes, uint8_t seconds,
+    uint8_t frame, uint8_t fps) {
+  MidiInitializeTime(time);
+  time->hours = hours;
+  time->minutes = minutes;
+  time->seconds = seconds;
+  time->frame = frame;
+  time->fps = fps;
+}
+
+static void TestMidiTimeGenerator_Initializer(void) {
+  system_time_t const now = { .seconds = 10, .nanoseconds = 0 };
+  scheduler_t scheduler;
+  TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &now));
+  test_sent_t sent;
+  midi_time_generator_t generator;
+  TEST_ASSERT_FALSE(MidiInitializeTimeGenerator(
+      NULL, &scheduler, MIDI_ALL_CALL, TestSend, &sent));
+  TEST_ASSERT_FALSE(MidiInitializeTimeGenerator(
+      &generator, NULL, MIDI_ALL_CALL, TestSend, &sent));
+  TEST_ASSERT_FALSE(MidiInitializeTimeGenerator(
+      &generator, &scheduler, 0x80, TestSend, &sent));
+  TEST_ASSERT_FALSE(MidiInitializeTimeGenerator(
+      &generator, &scheduler, MIDI_ALL_CALL, NULL, &sent));
+  TEST_ASSERT_TRUE(MidiInitializeTimeGenerator(
+      &generator, &scheduler, MIDI_ALL_CALL, TestSend, &sent));
+  TEST_ASSERT_FALSE(MidiIsTimeGeneratorRunning(&generator));
+  TEST_ASSERT_FALSE(MidiTimeGeneratorStart(
+      &generator, MIDI_TIME_UNKNOWN, NULL));
+}
+
+static void TestMidiTimeGenerator_Locate(void) {
+  system_time_t const now = { .seconds = 10, .nanoseconds = 0 };
+  scheduler_t scheduler;
+  TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &now));
+  test_sent_t sent;
+  TestInitializeSent(&sent);
+  midi_time_generator_t generator;
+  TEST_ASSERT_TRUE(MidiInitializeTimeGenerator(
+      &generator, &scheduler, MIDI_ALL_CALL, TestSend, &sent));
+
+  midi_time_t time;
+  TestSetTime(&time, 1, 2, 3, 30, MIDI_25_FPS);
+  TEST_ASSERT_FALSE(MidiTimeGeneratorLocate(&generator, &time));
+  TEST_ASSERT_EQUAL(0, sent.message_count);
+
+  TestSetTime(&time, 1, 2, 3, 4, MIDI_25_FPS);
+  TEST_ASSERT_TRUE(MidiTimeGeneratorLocate(&generator, &time));
+  TEST_ASSERT_EQUAL(1, sent.message_count);
+  midi_message_t const *message = &sent.messages[0];
+  TEST_ASSERT_EQUAL(MIDI_SYSTEM_EXCLUSIVE, message->type);
+  TEST_ASSERT_TRUE(MidiIsValidSysEx(&message->sys_ex));
+  TEST_ASSERT_EQUAL(MIDI_REAL_TIME_ID, message->sys_ex.id[0]);
+  TEST_ASSERT_EQUAL(MIDI_ALL_CALL, message->sys_ex.device_id);
+  TEST_ASSERT_EQUAL(MIDI_RT_TIME_CODE, message->sys_ex.sub_id);
+  TEST_ASSERT_EQUAL(
+      MIDI_FULL_TIME_CODE, message->sys_ex.rt_time_code.sub_id);
+  TEST_ASSERT_EQUAL_MEMORY(
+      &time, &message->sys_ex.rt_time_code.time, sizeof(midi_time_t));
+
+  midi_time_t generator_time;
+  TEST_ASSERT_TRUE(MidiGetTimeGeneratorTime(&generator, &generator_time));
+  TEST_ASSERT_EQUAL_MEMORY(&time, &generator_time, sizeof(midi_time_t));
+}
+
+static void TestMidiTimeGenerator_Forward(void) {
+  system_time_t now = { .seconds = 10, .nanoseconds = 0 };
+  scheduler_t scheduler;
+  TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &now));
+  test_sent_t sent;
+  TestInitializeSent(&sent);
+  midi_time_generator_t generator;
+  TEST_ASSERT_TRUE(MidiInitializeTimeGenerator(
+      &generator, &scheduler, MIDI_ALL_CALL, TestSend, &sent));
+  midi_time_t time;
+  TestSetTime(&time, 1, 2, 3, 4, MIDI_25_FPS);
+  MidiTimeGeneratorLocate(&generator, &time);
+  sent.message_count = 0;
+
+  TEST_ASSERT_TRUE(MidiTimeGeneratorStart(
+      &generator, MIDI_TIME_FORWARD, NULL));
+  TEST_ASSERT_TRUE(MidiIsTimeGeneratorRunning(&generator));
+  /* 25 fps quarter frames are 10 ms apart. */
+  for (size_t i = 0; i < 8; ++i) {
+    TEST_ASSERT_EQUAL(1, SchedulerDoCallbacks(&scheduler, &now));
+    SystemTimeIncrementMilliseconds(&now, 5);
+    TEST_ASSERT_EQUAL(0, SchedulerDoCallbacks(&scheduler, &now));
+    SystemTimeIncrementMilliseconds(&now, 5);
+  }
+  TEST_ASSERT_EQUAL(8, sent.message_count);
+
+  uint8_t expected[MIDI_SERIALIZED_TIME_PAYLOAD_SIZE];
+  MidiSerializeTime(&time, MIDI_TIME_FORWARD, expected, sizeof(expected));
+  for (size_t i = 0; i < 8; ++i) {
+    uint8_t data;
+    TEST_ASSERT_EQUAL(MIDI_TIME_CODE, sent.messages[i].type);
+    MidiSerializeTimeCode(&sent.messages[i].time_code, &data);
+    TEST_ASSERT_EQUAL(expected[i], data);
+  }
+  /* Two frames pass per cycle. */
+  midi_time_t generator_time;
+  MidiGetTimeGeneratorTime(&generator, &generator_time);
+  TEST_ASSERT_EQUAL(6, generator_time.frame);
+
+  /* A receiver synchronizes to the generator. */
+  for (size_t i = 0; i < 16; ++i) {
+    SchedulerDoCallbacks(&scheduler, &now);
+    SystemTimeIncrementMilliseconds(&now, 10);
+  }
+  TEST_ASSERT_TRUE(MidiIsSynchronized(&sent.tracker));
+  TEST_ASSERT_TRUE(sent.tracked_updates > 0);
+
+  midi_time_generator_stats_t stats;
+  TEST_ASSERT_TRUE(MidiGetTimeGeneratorStats(&generator, &stats));
+  TEST_ASSERT_EQUAL(24, stats.quarter_frames);
+  TEST_ASSERT_EQUAL(0, stats.max_jitter_us);
+  TEST_ASSERT_EQUAL(0, stats.late);
+
+  TEST_ASSERT_TRUE(MidiTimeGeneratorStop(&generator));
+  TEST_ASSERT_FALSE(MidiIsTimeGeneratorRunning(&generator));
+  SystemTimeIncrementMilliseconds(&now, 10);
+  TEST_ASSERT_EQUAL(0, SchedulerDoCallbacks(&scheduler, &now));
+}
+
+static void TestMidiTimeGenerator_Reverse(void) {
+  system_time_t now = { .seconds = 10, .nanoseconds = 0 };
+  scheduler_t scheduler;
+  TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &now));
+  test_sent_t sent;
+  TestInitializeSent(&sent);
+  midi_time_generator_t generator;
+  TEST_ASSERT_TRUE(MidiInitializeTimeGenerator(
+      &generator, &scheduler, MIDI_ALL_CALL, TestSend, &sent));
+  midi_time_t time;
+  TestSetTime(&time, 0, 0, 0, 1, MIDI_24_FPS);
+  MidiTimeGeneratorLocate(&generator, &time);
+  sent.message_count = 0;
+
+  MidiTimeGeneratorStart(&generator, MIDI_TIME_REVERSE, &now);
+  for (size_t i = 0; i < 8; ++i) {
+    SchedulerDoCallbacks(&scheduler, &now);
+    SystemTimeIncrementMilliseconds(&now, 11);
+  }
+  TEST_ASSERT_EQUAL(8, sent.message_count);
+  uint8_t expected[MIDI_SERIALIZED_TIME_PAYLOAD_SIZE];
+  MidiSerializeTime(&time, MIDI_TIME_REVERSE, expected, sizeof(expected));
+  for (size_t i = 0; i < 8; ++i) {
+    uint8_t data;
+    MidiSerializeTimeCode(&sent.messages[i].time_code, &data);
+    TEST_ASSERT_EQUAL(expected[i], data);
+  }
+  /* Two frames back from 00:00:00:01 rolls over. */
+  midi_time_t generator_time;
+  MidiGetTimeGeneratorTime(&generator, &generator_time);
+  TEST_ASSERT_EQUAL(23, generator_time.frame);
+  TEST_ASSERT_EQUAL(59, generator_time.seconds);
+  TEST_ASSERT_EQUAL(59, generator_time.minutes);
+  TEST_ASSERT_EQUAL(23, generator_time.hours);
+}
+
+/* Counts the quarter frames sent from the start to |duration_ms|, with
+ * the scheduler run every 100 us. */
+static uint32_t TestCountQuarterFrames(uint8_t fps, uint32_t duration_ms) {
+  system_time_t now = { .seconds = 100, .nanoseconds = 0 };
+  system_time_t end = now;
+  SystemTimeIncrementMilliseconds(&end, duration_ms);
+  scheduler_t scheduler;
+  TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &now));
+  test_sent_t sent;
+  TestInitializeSent(&sent);
+  midi_time_generator_t generator;
+  TEST_ASSERT_TRUE(MidiInitializeTimeGenerator(
+      &generator, &scheduler, MIDI_ALL_CALL, TestSend, &sent));
+  midi_time_t time;
+  TestSetTime(&time, 0, 0, 0, 0, fps);
+  MidiTimeGeneratorLocate(&generator, &time);
+  MidiTimeGeneratorStart(&generator, MIDI_TIME_FORWARD, &now);
+  while (SystemTimeLessThanOrEqual(&now, &end)) {
+    SchedulerDoCallbacks(&scheduler, &now);
+    SystemTimeIncrementMicroseconds(&now, 100);
+  }
+  midi_time_generator_stats_t stats;
+  MidiGetTimeGeneratorStats(&generator, &stats);
+  TEST_ASSERT_TRUE(stats.max_jitter_us < 100);
+  TEST_ASSERT_EQUAL(0, stats.late);
+  return sent.quarter_frames;
+}
+
+static void TestMidiTimeGenerator_Interval(void) {
+  /* Includes the quarter frame at the start. */
+  TEST_ASSERT_EQUAL(97, TestCountQuarterFrames(MIDI_24_FPS, 1000));
+  TEST_ASSERT_EQUAL(101, TestCountQuarterFrames(MIDI_25_FPS, 1000));
+  TEST_ASSERT_EQUAL(121, TestCountQuarterFrames(MIDI_30_FPS_NON_DROP, 1000));
+  /* 30 frames of 29.97 fps take 1.001 s. */
+  TEST_ASSERT_EQUAL(
+      120, TestCountQuarterFrames(MIDI_30_FPS_DROP_FRAME, 1000));
+  TEST_ASSERT_EQUAL(
+      121, TestCountQuarterFrames(MIDI_30_FPS_DROP_FRAME, 1001));
+  /* No drift after 10 minutes of fractional intervals. */
+  TEST_ASSERT_EQUAL(
+      57601, TestCountQuarterFrames(MIDI_24_FPS, 600000));
+}
+
+static void TestMidiTimeGenerator_CatchUp(void) {
+  system_time_t now = { .seconds = 10, .nanoseconds = 0 };
+  scheduler_t scheduler;
+  TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &now));
+  test_sent_t sent;
+  TestInitializeSent(&sent);
+  midi_time_generator_t generator;
+  TEST_ASSERT_TRUE(MidiInitializeTimeGenerator(
+      &generator, &scheduler, MIDI_ALL_CALL, TestSend, &sent));
+  midi_time_t time;
+  TestSetTime(&time, 0, 0, 0, 0, MIDI_25_FPS);
+  MidiTimeGeneratorLocate(&generator, &time);
+  MidiTimeGeneratorStart(&generator, MIDI_TIME_FORWARD, &now);
+  SchedulerDoCallbacks(&scheduler, &now);
+
+  /* Stalled for 3 quarter frames and a half. */
+  SystemTimeIncrementMicroseconds(&now, 35000);
+  TEST_ASSERT_EQUAL(3, SchedulerDoCallbacks(&scheduler, &now));
+  midi_time_generator_stats_t stats;
+  MidiGetTimeGeneratorStats(&generator, &stats);
+  TEST_ASSERT_EQUAL(4, stats.quarter_frames);
+  TEST_ASSERT_EQUAL(5000, stats.last_jitter_us);
+  TEST_ASSERT_EQUAL(25000, stats.max_jitter_us);
+  TEST_ASSERT_EQUAL(25000 + 15000 + 5000, stats.total_jitter_us);
+  TEST_ASSERT_EQUAL(2, stats.late);
+
+  /* Back on schedule. */
+  SystemTimeIncrementMicroseconds(&now, 5000);
+  TEST_ASSERT_EQUAL(1, SchedulerDoCallbacks(&scheduler, &now));
+  MidiGetTimeGeneratorStats(&generator, &stats);
+  TEST_ASSERT_EQUAL(0, stats.last_jitter_us);
+
+  TEST_ASSERT_TRUE(MidiResetTimeGeneratorStats(&generator));
+  MidiGetTimeGeneratorStats(&generator, &stats);
+  TEST_ASSERT_EQUAL(0, stats.quarter_frames);
+  TEST_ASSERT_EQUAL(0, stats.max_jitter_us);
+}
+
+void MidiTimeGeneratorTest(void) {
+  RUN_TEST(TestMidiTimeGenerator_Initializer);
+  RUN_TEST(TestMidiTimeGenerator_Locate);
+  RUN_TEST(TestMidiTimeGenerator_Forward);
+  RUN_TEST(TestMidiTimeGenerator_Reverse);
+  RUN_TEST(TestMidiTimeGenerator_Interval);
+  RUN_TEST(TestMidiTimeGenerator_CatchUp);
+}
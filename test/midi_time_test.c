@@ -644,6 +644,225 @@ static void TestMidiTime_Increment(void) {
   TEST_ASSERT_EQUAL(0, time.frame);
 }
 
+static void TestMidiTime_Increment_DropFrame(void) {
+  midi_time_t time;
+  MidiInitializeTime(&time);
+  time.fps = MIDI_30_FPS_DROP_FRAME;
+  time.frame = 29;
+  time.seconds = 59;
+  time.minutes = 0;
+  TEST_ASSERT_TRUE(MidiIncrementTimeFrame(&time));
+  TEST_ASSERT_EQUAL(2, time.frame);
+  TEST_ASSERT_EQUAL(0, time.seconds);
+  TEST_ASSERT_EQUAL(1, time.minutes);
+
+  /* Every tenth minute keeps frames 0 and 1. */
+  time.frame = 29;
+  time.seconds = 59;
+  time.minutes = 9;
+  TEST_ASSERT_TRUE(MidiIncrementTimeFrame(&time));
+  TEST_ASSERT_EQUAL(0, time.frame);
+  TEST_ASSERT_EQUAL(10, time.minutes);
+
+  /* Non-drop frame counts every frame. */
+  time.fps = MIDI_30_FPS_NON_DROP;
+  time.frame = 29;
+  time.seconds = 59;
+  time.minutes = 0;
+  TEST_ASSERT_TRUE(MidiIncrementTimeFrame(&time));
+  TEST_ASSERT_EQUAL(0, time.frame);
+  TEST_ASSERT_EQUAL(1, time.minutes);
+}
+
+static void TestMidiTime_Decrement(void) {
+  TEST_ASSERT_FALSE(MidiDecrementTimeFrame(NULL));
+  TEST_ASSERT_FALSE(MidiDecrementTimeSeconds(NULL));
+  TEST_ASSERT_FALSE(MidiDecrementTimeMinutes(NULL));
+  TEST_ASSERT_FALSE(MidiDecrementTimeHours(NULL));
+
+  midi_time_t time;
+  MidiInitializeTime(&time);
+  time.frame = 40;
+  TEST_ASSERT_FALSE(MidiDecrementTimeFrame(&time));
+  TEST_ASSERT_EQUAL(40, time.frame);
+
+  MidiInitializeTime(&time);
+  time.fps = MIDI_25_FPS;
+  TEST_ASSERT_TRUE(MidiDecrementTimeFrame(&time));
+  TEST_ASSERT_EQUAL(24, time.frame);
+  TEST_ASSERT_EQUAL(59, time.seconds);
+  TEST_ASSERT_EQUAL(59, time.minutes);
+  TEST_ASSERT_EQUAL(23, time.hours);
+  TEST_ASSERT_TRUE(MidiDecrementTimeFrame(&time));
+  TEST_ASSERT_EQUAL(23, time.frame);
+  TEST_ASSERT_TRUE(MidiDecrementTimeHours(&time));
+  TEST_ASSERT_EQUAL(22, time.hours);
+
+  MidiInitializeTime(&time);
+  time.fps = MIDI_30_FPS_DROP_FRAME;
+  time.frame = 2;
+  time.minutes = 1;
+  TEST_ASSERT_TRUE(MidiDecrementTimeFrame(&time));
+  TEST_ASSERT_EQUAL(29, time.frame);
+  TEST_ASSERT_EQUAL(59, time.seconds);
+  TEST_ASSERT_EQUAL(0, time.minutes);
+
+  time.frame = 0;
+  time.seconds = 0;
+  time.minutes = 10;
+  TEST_ASSERT_TRUE(MidiDecrementTimeFrame(&time));
+  TEST_ASSERT_EQUAL(29, time.frame);
+  TEST_ASSERT_EQUAL(59, time.seconds);
+  TEST_ASSERT_EQUAL(9, time.minutes);
+}
+
+static void TestMidiFrameCount_PerDay(void) {
+  TEST_ASSERT_EQUAL(2073600, MidiFrameCountPerDay(MIDI_24_FPS));
+  TEST_ASSERT_EQUAL(2160000, MidiFrameCountPerDay(MIDI_25_FPS));
+  TEST_ASSERT_EQUAL(2592000, MidiFrameCountPerDay(MIDI_30_FPS_NON_DROP));
+  TEST_ASSERT_EQUAL(2589408, MidiFrameCountPerDay(MIDI_30_FPS_DROP_FRAME));
+  TEST_ASSERT_EQUAL(0, MidiFrameCountPerDay(0x10));
+}
+
+static void TestMidiFrameCount_Time(void) {
+  midi_frame_count_t frames;
+  midi_time_t time;
+  MidiInitializeTime(&time);
+  TEST_ASSERT_FALSE(MidiTimeToFrameCount(NULL, &frames));
+  TEST_ASSERT_FALSE(MidiTimeToFrameCount(&time, NULL));
+  TEST_ASSERT_FALSE(MidiFrameCountToTime(0, MIDI_24_FPS, NULL));
+
+  time.fps = MIDI_25_FPS;
+  time.hours = 1;
+  time.frame = 3;
+  TEST_ASSERT_TRUE(MidiTimeToFrameCount(&time, &frames));
+  TEST_ASSERT_EQUAL(90003, frames);
+  /* Frame does not exist at 25 fps. */
+  time.frame = 25;
+  TEST_ASSERT_FALSE(MidiTimeToFrameCount(&time, &frames));
+
+  /* Dropped frame numbers. */
+  MidiInitializeTime(&time);
+  time.fps = MIDI_30_FPS_DROP_FRAME;
+  time.minutes = 1;
+  time.frame = 1;
+  TEST_ASSERT_FALSE(MidiTimeToFrameCount(&time, &frames));
+  time.frame = 2;
+  TEST_ASSERT_TRUE(MidiTimeToFrameCount(&time, &frames));
+  TEST_ASSERT_EQUAL(1800, frames);
+  time.minutes = 10;
+  time.frame = 0;
+  TEST_ASSERT_TRUE(MidiTimeToFrameCount(&time, &frames));
+  TEST_ASSERT_EQUAL(17982, frames);
+
+  TEST_ASSERT_TRUE(MidiFrameCountToTime(
+      MidiFrameCountPerDay(MIDI_30_FPS_DROP_FRAME) - 1,
+      MIDI_30_FPS_DROP_FRAME, &time));
+  TEST_ASSERT_EQUAL(23, time.hours);
+  TEST_ASSERT_EQUAL(59, time.minutes);
+  TEST_ASSERT_EQUAL(59, time.seconds);
+  TEST_ASSERT_EQUAL(29, time.frame);
+  TEST_ASSERT_FALSE(MidiFrameCountToTime(
+      MidiFrameCountPerDay(MIDI_30_FPS_DROP_FRAME),
+      MIDI_30_FPS_DROP_FRAME, &time));
+  TEST_ASSERT_FALSE(MidiFrameCountToTime(0, 0x10, &time));
+}
+
+/* Frame counts match counting with MidiIncrementTimeFrame(). */
+static void TestMidiFrameCount_Increment(void) {
+  static uint8_t const kFps[] = {
+    MIDI_24_FPS, MIDI_25_FPS, MIDI_30_FPS_DROP_FRAME, MIDI_30_FPS_NON_DROP
+  };
+  for (size_t i = 0; i < sizeof(kFps); ++i) {
+    midi_time_t time;
+    MidiInitializeTime(&time);
+    time.fps = kFps[i];
+    /* Covers 20 minutes, with the tenth minute of drop frame. */
+    for (midi_frame_count_t expected = 0; expected < 36000; ++expected) {
+      midi_frame_count_t frames;
+      TEST_ASSERT_TRUE(MidiTimeToFrameCount(&time, &frames));
+      TEST_ASSERT_EQUAL(expected, frames);
+      midi_time_t converted;
+      TEST_ASSERT_TRUE(MidiFrameCountToTime(frames, kFps[i], &converted));
+      TEST_ASSERT_EQUAL_MEMORY(&time, &converted, sizeof(midi_time_t));
+      MidiIncrementTimeFrame(&time);
+    }
+  }
+}
+
+static void TestMidiFrameCount_Offset(void) {
+  TEST_ASSERT_FALSE(MidiOffsetTime(NULL, 1));
+  midi_time_t time;
+  MidiInitializeTime(&time);
+  time.fps = MIDI_30_FPS_DROP_FRAME;
+  TEST_ASSERT_TRUE(MidiOffsetTime(&time, -1));
+  TEST_ASSERT_EQUAL(23, time.hours);
+  TEST_ASSERT_EQUAL(59, time.minutes);
+  TEST_ASSERT_EQUAL(59, time.seconds);
+  TEST_ASSERT_EQUAL(29, time.frame);
+  TEST_ASSERT_TRUE(MidiOffsetTime(&time, 1));
+  TEST_ASSERT_EQUAL(0, time.hours);
+  TEST_ASSERT_EQUAL(0, time.frame);
+
+  /* Skips the dropped frame numbers. */
+  time.seconds = 59;
+  time.frame = 29;
+  TEST_ASSERT_TRUE(MidiOffsetTime(&time, 1));
+  TEST_ASSERT_EQUAL(1, time.minutes);
+  TEST_ASSERT_EQUAL(0, time.seconds);
+  TEST_ASSERT_EQUAL(2, time.frame);
+  TEST_ASSERT_TRUE(MidiOffsetTime(&time, -1));
+  TEST_ASSERT_EQUAL(0, time.minutes);
+  TEST_ASSERT_EQUAL(59, time.seconds);
+  TEST_ASSERT_EQUAL(29, time.frame);
+
+  /* Offsets beyond a day. */
+  MidiInitializeTime(&time);
+  time.fps = MIDI_25_FPS;
+  TEST_ASSERT_TRUE(MidiOffsetTime(&time, 2160000 + 25));
+  TEST_ASSERT_EQUAL(1, time.seconds);
+  TEST_ASSERT_EQUAL(0, time.hours);
+  TEST_ASSERT_TRUE(MidiOffsetTime(&time, INT32_MIN));
+  TEST_ASSERT_TRUE(MidiIsValidTime(&time));
+}
+
+static void TestMidiFrameCount_Nanoseconds(void) {
+  uint64_t ns;
+  midi_frame_count_t frames;
+  TEST_ASSERT_FALSE(MidiFrameCountToNanoseconds(1, 0x10, &ns));
+  TEST_ASSERT_FALSE(MidiFrameCountToNanoseconds(1, MIDI_24_FPS, NULL));
+  TEST_ASSERT_FALSE(MidiNanosecondsToFrameCount(1, 0x10, &frames));
+  TEST_ASSERT_FALSE(MidiNanosecondsToFrameCount(1, MIDI_24_FPS, NULL));
+
+  TEST_ASSERT_TRUE(MidiFrameCountToNanoseconds(1, MIDI_24_FPS, &ns));
+  TEST_ASSERT_EQUAL(41666666, ns);
+  TEST_ASSERT_TRUE(MidiFrameCountToNanoseconds(25, MIDI_25_FPS, &ns));
+  TEST_ASSERT_EQUAL(1000000000, ns);
+  TEST_ASSERT_TRUE(
+      MidiFrameCountToNanoseconds(30, MIDI_30_FPS_DROP_FRAME, &ns));
+  TEST_ASSERT_EQUAL(1001000000, ns);
+  /* A drop frame day stays within 0.1 s of 24 hours. */
+  TEST_ASSERT_TRUE(MidiFrameCountToNanoseconds(
+      MidiFrameCountPerDay(MIDI_30_FPS_DROP_FRAME), MIDI_30_FPS_DROP_FRAME,
+      &ns));
+  TEST_ASSERT_TRUE(ns == 86399913600000ull);
+  TEST_ASSERT_TRUE(
+      MidiFrameCountToNanoseconds(UINT32_MAX, MIDI_30_FPS_NON_DROP, &ns));
+  TEST_ASSERT_TRUE(ns == 143165576500000000ull);
+
+  TEST_ASSERT_TRUE(MidiNanosecondsToFrameCount(
+      1001000000, MIDI_30_FPS_DROP_FRAME, &frames));
+  TEST_ASSERT_EQUAL(30, frames);
+  TEST_ASSERT_TRUE(MidiNanosecondsToFrameCount(
+      1000999999, MIDI_30_FPS_DROP_FRAME, &frames));
+  TEST_ASSERT_EQUAL(29, frames);
+  TEST_ASSERT_TRUE(MidiNanosecondsToFrameCount(
+      41666667, MIDI_24_FPS, &frames));
+  TEST_ASSERT_EQUAL(1, frames);
+  TEST_ASSERT_FALSE(MidiNanosecondsToFrameCount(
+      UINT64_MAX, MIDI_24_FPS, &frames));
+}
+
 void MidiTimeTest(void) {
   RUN_TEST(TestMidiTimeCode_Validators);
   RUN_TEST(TestMidiTimeCode_Initializer_Invalid);
@@ -661,4 +880,12 @@ void MidiTimeTest(void) {
   RUN_TEST(TestMidiTime_ExtractTimeCode);
   RUN_TEST(TestMidiTime_Serialize);
   RUN_TEST(TestMidiTime_Increment);
+  RUN_TEST(TestMidiTime_Increment_DropFrame);
+  RUN_TEST(TestMidiTime_Decrement);
+
+  RUN_TEST(TestMidiFrameCount_PerDay);
+  RUN_TEST(TestMidiFrameCount_Time);
+  RUN_TEST(TestMidiFrameCount_Increment);
+  RUN_TEST(TestMidiFrameCount_Offset);
+  RUN_TEST(TestMidiFrameCount_Nanoseconds);
 }
@@ -9,6 +9,7 @@
 #include <stdlib.h>
 #include <unity.h>
 
+#include "midi_callback_internal.h"
 #include "midi_defs.h"
 #include "midi_transceiver.h"
 
@@ -169,7 +170,7 @@ static void TestMidiReceiver_SingleByteMessage(void) {
   TEST_ASSERT_EQUAL(MIDI_CONTINUE, message.type);
   /* Data-less messages should clear status. */
   TEST_ASSERT_EQUAL(MIDI_NONE, rx_ctx.status);
-  TEST_ASSERT_EQUAL(0, rx_ctx.size);
+  TEST_ASSERT_EQUAL(0, MidiReceiverBufferSize(&rx_ctx));
 }
 
 static void TestMidiReceiver_MultiByteMessage(void) {
@@ -187,7 +188,7 @@ static void TestMidiReceiver_MultiByteMessage(void) {
   /* Messages with data (other than SysEx) should leave status set. */
   TEST_ASSERT_EQUAL(
       kNoteOnMessage.type | kNoteOnMessage.channel, rx_ctx.status);
-  TEST_ASSERT_EQUAL(0, rx_ctx.size);
+  TEST_ASSERT_EQUAL(0, MidiReceiverBufferSize(&rx_ctx));
   /* Should only require the data bytes for deserialization. */
   TEST_ASSERT_EQUAL(sizeof(kNoteOnPacket) - 1, MidiReceiveData(
       &rx_ctx, NULL, 0, &message));
@@ -218,7 +219,7 @@ static void TestMidiReceiver_MultiByteMessage_Transition(void) {
 
   TEST_ASSERT_EQUAL(
       kNoteOnMessage.type | kNoteOnMessage.channel, rx_ctx.status);
-  TEST_ASSERT_EQUAL(0, rx_ctx.size);
+  TEST_ASSERT_EQUAL(0, MidiReceiverBufferSize(&rx_ctx));
 
   memset(&message, 0xE5, sizeof(message));
   TEST_ASSERT_EQUAL(sizeof(kNoteOffPacket), MidiReceiveData(
@@ -260,7 +261,7 @@ static void TestMidiReceiver_MultiByteMessage_StatusRun(void) {
         &rx_ctx, &kNoteOnPackets[1 + 2*i], 2, &message));
     /* Receiver state */
     TEST_ASSERT_EQUAL(MIDI_NOTE_ON | MIDI_CHANNEL_6, rx_ctx.status);
-    TEST_ASSERT_EQUAL(0, rx_ctx.size);
+    TEST_ASSERT_EQUAL(0, MidiReceiverBufferSize(&rx_ctx));
     /* Status-run state. */
     TEST_ASSERT_EQUAL(MIDI_NOTE_ON, message.type);
     TEST_ASSERT_EQUAL(MIDI_CHANNEL_6, message.channel);
@@ -270,6 +271,30 @@ static void TestMidiReceiver_MultiByteMessage_StatusRun(void) {
   }
 }
 
+static void TestMidiReceiver_MultiByteMessage_RewindBuffer(void) {
+  midi_rx_ctx_t rx_ctx;
+  midi_message_t message;
+  MidiInitializeReceiverCtx(&rx_ctx);
+  /* Pending key byte at the end of the buffer, with free space at the
+   * front. */
+  rx_ctx.status = kNoteOnStatus;
+  rx_ctx.head = MIDI_RX_BUFFER_SIZE - 1;
+  rx_ctx.tail = MIDI_RX_BUFFER_SIZE;
+  rx_ctx.buffer[MIDI_RX_BUFFER_SIZE - 1] = kNoteOnMessage.note.key;
+
+  TEST_ASSERT_EQUAL(1, MidiReceiveData(
+      &rx_ctx, &kNoteOnPacket[2], 1, &message));
+  TEST_ASSERT_EQUAL(kNoteOnMessage.type, message.type);
+  TEST_ASSERT_EQUAL(kNoteOnMessage.channel, message.channel);
+  TEST_ASSERT_EQUAL(kNoteOnMessage.note.key, message.note.key);
+  TEST_ASSERT_EQUAL(kNoteOnMessage.note.velocity, message.note.velocity);
+  /* Status-run is kept, buffer is rewound. */
+  TEST_ASSERT_EQUAL(kNoteOnStatus, rx_ctx.status);
+  TEST_ASSERT_EQUAL(0, MidiReceiverBufferSize(&rx_ctx));
+  TEST_ASSERT_EQUAL(0, rx_ctx.head);
+  TEST_ASSERT_EQUAL(0, rx_ctx.tail);
+}
+
 static void TestMidiReceiver_SysEx_SmallMessage(void) {
   static uint8_t const kDeviceInquiryPacket[] = {
     MIDI_SYSTEM_EXCLUSIVE, MIDI_NON_REAL_TIME_ID, MIDI_ALL_CALL,
@@ -304,7 +329,7 @@ static void TestMidiReceiver_SysEx_SmallMessage(void) {
   TEST_ASSERT_EQUAL(sizeof(kDeviceInquiryPacket), MidiReceiveData(
       &rx_ctx, kDeviceInquiryPacket, sizeof(kDeviceInquiryPacket), &message));
   TEST_ASSERT_EQUAL(MIDI_NONE, rx_ctx.status);
-  TEST_ASSERT_EQUAL(0, rx_ctx.size);
+  TEST_ASSERT_EQUAL(0, MidiReceiverBufferSize(&rx_ctx));
 
   TEST_ASSERT_EQUAL(kDeviceInquiryMessage.type, message.type);
   TEST_ASSERT_EQUAL_MEMORY(
@@ -385,6 +410,7 @@ static void TestMidiReceiver_FuzzTest(void) {
   }
   midi_rx_ctx_t rx_ctx;
   midi_message_t message;
+  TEST_ASSERT_TRUE(MidiInitializeReceiverCtx(&rx_ctx));
   size_t data_used = 0;
   while (data_used < sizeof(data)) {
     size_t const to_consume =
@@ -399,10 +425,640 @@ static void TestMidiReceiver_FuzzTest(void) {
   }
 }
 
+static void TestMidiReceiverBatch_InvalidParameters(void) {
+  midi_rx_ctx_t rx_ctx;
+  midi_message_t messages[4];
+  size_t consumed = 0xE5;
+  MidiInitializeReceiverCtx(&rx_ctx);
+  TEST_ASSERT_EQUAL(0, MidiReceiveDataBatch(
+      NULL, kNoteOnPacket, sizeof(kNoteOnPacket), messages, 4, &consumed));
+  TEST_ASSERT_EQUAL(0, consumed);
+  consumed = 0xE5;
+  TEST_ASSERT_EQUAL(0, MidiReceiveDataBatch(
+      &rx_ctx, NULL, 4, messages, 4, &consumed));
+  TEST_ASSERT_EQUAL(0, consumed);
+  TEST_ASSERT_EQUAL(0, MidiReceiveDataBatch(
+      &rx_ctx, kNoteOnPacket, sizeof(kNoteOnPacket), NULL, 4, &consumed));
+  TEST_ASSERT_EQUAL(0, MidiReceiveDataBatch(
+      &rx_ctx, kNoteOnPacket, sizeof(kNoteOnPacket), messages, 0, &consumed));
+  /* Nothing should have been consumed. */
+  TEST_ASSERT_EQUAL(MIDI_NONE, rx_ctx.status);
+  /* Consumed output is optional. */
+  TEST_ASSERT_EQUAL(1, MidiReceiveDataBatch(
+      &rx_ctx, kNoteOnPacket, sizeof(kNoteOnPacket), messages, 4, NULL));
+}
+
+static void TestMidiReceiverBatch_MultipleMessages(void) {
+  static uint8_t const kPackets[] = {
+    MIDI_NOTE_ON | MIDI_CHANNEL_6,
+    MIDI_MIDDLE_C, MIDI_NOTE_ON_VELOCITY,
+    MIDI_MIDDLE_C + 4, MIDI_NOTE_ON_VELOCITY,
+    MIDI_TIMING_CLOCK,
+    MIDI_CONTROL_CHANGE | MIDI_CHANNEL_2, MIDI_PAN_MSB, MIDI_PAN_CENTER,
+    MIDI_CONTINUE,
+    MIDI_NOTE_OFF | MIDI_CHANNEL_6, MIDI_MIDDLE_C  /* Incomplete */
+  };
+  midi_rx_ctx_t rx_ctx;
+  midi_message_t messages[8];
+  memset(messages, 0xE5, sizeof(messages));
+  MidiInitializeReceiverCtx(&rx_ctx);
+  size_t consumed = 0;
+  TEST_ASSERT_EQUAL(5, MidiReceiveDataBatch(
+      &rx_ctx, kPackets, sizeof(kPackets), messages, 8, &consumed));
+  TEST_ASSERT_EQUAL(sizeof(kPackets), consumed);
+
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, messages[0].type);
+  TEST_ASSERT_EQUAL(MIDI_CHANNEL_6, messages[0].channel);
+  TEST_ASSERT_EQUAL(MIDI_MIDDLE_C, messages[0].note.key);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, messages[1].type);
+  TEST_ASSERT_EQUAL(MIDI_CHANNEL_6, messages[1].channel);
+  TEST_ASSERT_EQUAL(MIDI_MIDDLE_C + 4, messages[1].note.key);
+  TEST_ASSERT_EQUAL(MIDI_TIMING_CLOCK, messages[2].type);
+  TEST_ASSERT_EQUAL(MIDI_CONTROL_CHANGE, messages[3].type);
+  TEST_ASSERT_EQUAL(MIDI_CHANNEL_2, messages[3].channel);
+  TEST_ASSERT_EQUAL(MIDI_PAN_MSB, messages[3].control.number);
+  TEST_ASSERT_EQUAL(MIDI_PAN_CENTER, messages[3].control.value);
+  TEST_ASSERT_EQUAL(MIDI_CONTINUE, messages[4].type);
+
+  /* The incomplete note-off is held by the receiver. */
+  TEST_ASSERT_EQUAL(MIDI_NOTE_OFF | MIDI_CHANNEL_6, rx_ctx.status);
+  uint8_t const kVelocity = MIDI_NOTE_ON_VELOCITY;
+  TEST_ASSERT_EQUAL(1, MidiReceiveDataBatch(
+      &rx_ctx, &kVelocity, 1, messages, 8, &consumed));
+  TEST_ASSERT_EQUAL(1, consumed);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_OFF, messages[0].type);
+  TEST_ASSERT_EQUAL(MIDI_MIDDLE_C, messages[0].note.key);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON_VELOCITY, messages[0].note.velocity);
+}
+
+static void TestMidiReceiverBatch_MessageLimit(void) {
+  static uint8_t const kPackets[] = {
+    MIDI_NOTE_ON | MIDI_CHANNEL_1, 0x30, 0x40, 0x31, 0x41, 0x32, 0x42
+  };
+  midi_rx_ctx_t rx_ctx;
+  midi_message_t messages[2];
+  MidiInitializeReceiverCtx(&rx_ctx);
+  size_t consumed = 0;
+  TEST_ASSERT_EQUAL(2, MidiReceiveDataBatch(
+      &rx_ctx, kPackets, sizeof(kPackets), messages, 2, &consumed));
+  TEST_ASSERT_EQUAL(5, consumed);
+  TEST_ASSERT_EQUAL(0x30, messages[0].note.key);
+  TEST_ASSERT_EQUAL(0x31, messages[1].note.key);
+
+  /* Continue with the remaining data, status is still running. */
+  TEST_ASSERT_EQUAL(1, MidiReceiveDataBatch(
+      &rx_ctx, &kPackets[consumed], sizeof(kPackets) - consumed,
+      messages, 2, &consumed));
+  TEST_ASSERT_EQUAL(2, consumed);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, messages[0].type);
+  TEST_ASSERT_EQUAL(0x32, messages[0].note.key);
+  TEST_ASSERT_EQUAL(0x42, messages[0].note.velocity);
+}
+
+static void TestMidiReceiverBatch_MatchesSingle(void) {
+  uint8_t data[1024];
+  srand(RANDOM_SEED);
+  for (size_t i = 0; i < sizeof(data); ++i) {
+    data[i] = rand() & 0xFF;
+  }
+  midi_rx_ctx_t single_ctx, batch_ctx;
+  MidiInitializeReceiverCtx(&single_ctx);
+  MidiInitializeReceiverCtx(&batch_ctx);
+
+  midi_message_t single_messages[64];
+  size_t single_count = 0;
+  size_t data_used = 0;
+  while (data_used < sizeof(data) && single_count < 64) {
+    size_t const res = MidiReceiveData(
+        &single_ctx, &data[data_used], sizeof(data) - data_used,
+        &single_messages[single_count]);
+    if (single_messages[single_count].type != MIDI_NONE) ++single_count;
+    data_used += res;
+  }
+
+  midi_message_t batch_messages[64];
+  size_t consumed = 0;
+  size_t const batch_count = MidiReceiveDataBatch(
+      &batch_ctx, data, sizeof(data), batch_messages, 64, &consumed);
+  TEST_ASSERT_EQUAL(single_count, batch_count);
+  for (size_t i = 0; i < batch_count; ++i) {
+    TEST_ASSERT_EQUAL(single_messages[i].type, batch_messages[i].type);
+    TEST_ASSERT_EQUAL(single_messages[i].channel, batch_messages[i].channel);
+  }
+}
+
 /*
  *  Transmitter
  */
 
+/* Raw SysEx mode. */
+
+static size_t sSysExDataCount = 0;
+static uint8_t const *sSysExData = NULL;
+static size_t sSysExDataSize = 0;
+static uint8_t sSysExDataCopy[MIDI_RX_BUFFER_SIZE];
+
+static void SysExDataCallback(
+    midi_rx_event_t const *rx_event, uint8_t const *data, size_t data_size) {
+  TEST_ASSERT_NOT_NULL(rx_event);
+  TEST_ASSERT_NULL(rx_event->message);
+  TEST_ASSERT_TRUE(data_size <= sizeof(sSysExDataCopy));
+  ++sSysExDataCount;
+  sSysExData = data;
+  sSysExDataSize = data_size;
+  memcpy(sSysExDataCopy, data, data_size);
+}
+
+static void ResetSysExDataCallback(midi_callbacks_t *callbacks) {
+  MidiInitializeCallbacks(callbacks);
+  callbacks->rx.OnSysExData = SysExDataCallback;
+  sSysExDataCount = 0;
+  sSysExData = NULL;
+  sSysExDataSize = 0;
+  memset(sSysExDataCopy, 0, sizeof(sSysExDataCopy));
+}
+
+static void TestMidiReceiverRawSysEx_SetMode(void) {
+  midi_rx_ctx_t rx_ctx;
+  midi_callbacks_t callbacks;
+  MidiInitializeCallbacks(&callbacks);
+  MidiInitializeReceiverCtx(&rx_ctx);
+  TEST_ASSERT_EQUAL(MIDI_RX_SYS_EX_DECODE, rx_ctx.sys_ex_mode);
+  TEST_ASSERT_FALSE(MidiReceiverSetSysExMode(NULL, MIDI_RX_SYS_EX_RAW));
+  /* Requires callbacks. */
+  TEST_ASSERT_FALSE(MidiReceiverSetSysExMode(&rx_ctx, MIDI_RX_SYS_EX_RAW));
+  TEST_ASSERT_FALSE(MidiReceiverSetSysExMode(&rx_ctx, 0x42));
+  TEST_ASSERT_TRUE(MidiReceiverSetCallbacks(&rx_ctx, &callbacks));
+  TEST_ASSERT_TRUE(MidiReceiverSetSysExMode(&rx_ctx, MIDI_RX_SYS_EX_RAW));
+  TEST_ASSERT_EQUAL(MIDI_RX_SYS_EX_RAW, rx_ctx.sys_ex_mode);
+  /* Detaching callbacks returns to decode mode. */
+  TEST_ASSERT_TRUE(MidiReceiverSetCallbacks(&rx_ctx, NULL));
+  TEST_ASSERT_EQUAL(MIDI_RX_SYS_EX_DECODE, rx_ctx.sys_ex_mode);
+}
+
+static void TestMidiReceiverRawSysEx_SingleRead(void) {
+  static size_t const kPacketSize = sizeof(kDataPacketSysExPacket);
+  uint8_t data[sizeof(kDataPacketSysExPacket) + sizeof(kNoteOnPacket)];
+  memcpy(data, kDataPacketSysExPacket, kPacketSize);
+  memcpy(&data[kPacketSize], kNoteOnPacket, sizeof(kNoteOnPacket));
+  midi_rx_ctx_t rx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t message;
+  ResetSysExDataCallback(&callbacks);
+  MidiInitializeReceiverCtx(&rx_ctx);
+  TEST_ASSERT_TRUE(MidiReceiverSetCallbacks(&rx_ctx, &callbacks));
+  TEST_ASSERT_TRUE(MidiReceiverSetSysExMode(&rx_ctx, MIDI_RX_SYS_EX_RAW));
+
+  TEST_ASSERT_EQUAL(sizeof(data), MidiReceiveData(
+      &rx_ctx, data, sizeof(data), &message));
+  TEST_ASSERT_EQUAL(kNoteOnMessage.type, message.type);
+  TEST_ASSERT_EQUAL(kNoteOnMessage.channel, message.channel);
+  /* SysEx data is referenced directly from the input. */
+  TEST_ASSERT_EQUAL(1, sSysExDataCount);
+  TEST_ASSERT_EQUAL_PTR(&data[1], sSysExData);
+  TEST_ASSERT_EQUAL(kPacketSize - 2, sSysExDataSize);
+  TEST_ASSERT_EQUAL(0, MidiReceiverBufferSize(&rx_ctx));
+  TEST_ASSERT_EQUAL(2, callbacks.rx.next_sys_ex_rx_event_id);
+}
+
+static void TestMidiReceiverRawSysEx_MultipleReads(void) {
+  static size_t const kPacketSize = sizeof(kDataPacketSysExPacket);
+  static size_t const kChunkSize = 7;
+  midi_rx_ctx_t rx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t message;
+  ResetSysExDataCallback(&callbacks);
+  MidiInitializeReceiverCtx(&rx_ctx);
+  TEST_ASSERT_TRUE(MidiReceiverSetCallbacks(&rx_ctx, &callbacks));
+  TEST_ASSERT_TRUE(MidiReceiverSetSysExMode(&rx_ctx, MIDI_RX_SYS_EX_RAW));
+
+  for (size_t i = 0; i < kPacketSize; i += kChunkSize) {
+    size_t const chunk_size =
+        (kPacketSize - i) < kChunkSize ? (kPacketSize - i) : kChunkSize;
+    MidiReceiveData(
+        &rx_ctx, &kDataPacketSysExPacket[i], chunk_size, &message);
+    TEST_ASSERT_EQUAL(MIDI_NONE, message.type);
+    TEST_ASSERT_EQUAL((i + chunk_size) < kPacketSize ? 0 : 1,
+        sSysExDataCount);
+  }
+  TEST_ASSERT_EQUAL(kPacketSize - 2, sSysExDataSize);
+  TEST_ASSERT_EQUAL_MEMORY(
+      &kDataPacketSysExPacket[1], sSysExDataCopy, kPacketSize - 2);
+  TEST_ASSERT_EQUAL(MIDI_NONE, rx_ctx.status);
+  TEST_ASSERT_EQUAL(0, MidiReceiverBufferSize(&rx_ctx));
+
+  /* Receiver continues normally. */
+  TEST_ASSERT_EQUAL(sizeof(kNoteOnPacket), MidiReceiveData(
+      &rx_ctx, kNoteOnPacket, sizeof(kNoteOnPacket), &message));
+  TEST_ASSERT_EQUAL(kNoteOnMessage.type, message.type);
+}
+
+static void TestMidiReceiverRawSysEx_Interrupted(void) {
+  static uint8_t const kInterruptedPacket[] = {
+    MIDI_SYSTEM_EXCLUSIVE, MIDI_NON_REAL_TIME_ID, 0x10,
+    MIDI_NOTE_ON | MIDI_CHANNEL_4, MIDI_MIDDLE_C,  MIDI_NOTE_ON_VELOCITY
+  };
+  midi_rx_ctx_t rx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t message;
+  ResetSysExDataCallback(&callbacks);
+  MidiInitializeReceiverCtx(&rx_ctx);
+  TEST_ASSERT_TRUE(MidiReceiverSetCallbacks(&rx_ctx, &callbacks));
+  TEST_ASSERT_TRUE(MidiReceiverSetSysExMode(&rx_ctx, MIDI_RX_SYS_EX_RAW));
+
+  /* SysEx is dropped, and the status byte starts a new message. */
+  TEST_ASSERT_EQUAL(sizeof(kInterruptedPacket), MidiReceiveData(
+      &rx_ctx, kInterruptedPacket, sizeof(kInterruptedPacket), &message));
+  TEST_ASSERT_EQUAL(kNoteOnMessage.type, message.type);
+  TEST_ASSERT_EQUAL(0, sSysExDataCount);
+}
+
+/* Stream SysEx mode. */
+
+#define LARGE_SYS_EX_SIZE 1024
+
+static size_t sSysExStartCount = 0;
+static size_t sSysExChunkCount = 0;
+static size_t sSysExEndCount = 0;
+static bool_t sSysExComplete = false;
+static size_t sSysExStreamSize = 0;
+static uint8_t sSysExStream[LARGE_SYS_EX_SIZE];
+
+static void SysExStartCallback(midi_rx_event_t const *rx_event) {
+  TEST_ASSERT_NOT_NULL(rx_event);
+  TEST_ASSERT_EQUAL(sSysExEndCount, sSysExStartCount);
+  ++sSysExStartCount;
+}
+
+static void SysExChunkCallback(
+    midi_rx_event_t const *rx_event, uint8_t const *data, size_t data_size) {
+  TEST_ASSERT_NOT_NULL(rx_event);
+  TEST_ASSERT_GREATER_THAN(0, data_size);
+  TEST_ASSERT_TRUE((sSysExStreamSize + data_size) <= sizeof(sSysExStream));
+  ++sSysExChunkCount;
+  memcpy(&sSysExStream[sSysExStreamSize], data, data_size);
+  sSysExStreamSize += data_size;
+}
+
+static void SysExEndCallback(
+    midi_rx_event_t const *rx_event, bool_t complete) {
+  TEST_ASSERT_NOT_NULL(rx_event);
+  ++sSysExEndCount;
+  sSysExComplete = complete;
+}
+
+static void ResetSysExStreamCallbacks(midi_callbacks_t *callbacks) {
+  MidiInitializeCallbacks(callbacks);
+  callbacks->rx.OnSysExStart = SysExStartCallback;
+  callbacks->rx.OnSysExChunk = SysExChunkCallback;
+  callbacks->rx.OnSysExEnd = SysExEndCallback;
+  sSysExStartCount = 0;
+  sSysExChunkCount = 0;
+  sSysExEndCount = 0;
+  sSysExComplete = false;
+  sSysExStreamSize = 0;
+  memset(sSysExStream, 0, sizeof(sSysExStream));
+}
+
+static void TestMidiReceiverStreamSysEx_Large(void) {
+  static size_t const kChunkSize = 50;
+  uint8_t data[LARGE_SYS_EX_SIZE + 2];
+  data[0] = MIDI_SYSTEM_EXCLUSIVE;
+  srand(RANDOM_SEED);
+  for (size_t i = 1; i <= LARGE_SYS_EX_SIZE; ++i) {
+    data[i] = rand() & 0x7F;
+  }
+  data[LARGE_SYS_EX_SIZE + 1] = MIDI_END_SYSTEM_EXCLUSIVE;
+  midi_rx_ctx_t rx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t message;
+  ResetSysExStreamCallbacks(&callbacks);
+  MidiInitializeReceiverCtx(&rx_ctx);
+  TEST_ASSERT_TRUE(MidiReceiverSetCallbacks(&rx_ctx, &callbacks));
+  TEST_ASSERT_TRUE(MidiReceiverSetSysExMode(&rx_ctx, MIDI_RX_SYS_EX_STREAM));
+
+  for (size_t i = 0; i < sizeof(data); i += kChunkSize) {
+    size_t const chunk_size =
+        (sizeof(data) - i) < kChunkSize ? (sizeof(data) - i) : kChunkSize;
+    MidiReceiveData(&rx_ctx, &data[i], chunk_size, &message);
+    TEST_ASSERT_EQUAL(MIDI_NONE, message.type);
+    TEST_ASSERT_EQUAL(1, sSysExStartCount);
+    /* Nothing is buffered. */
+    TEST_ASSERT_EQUAL(0, MidiReceiverBufferSize(&rx_ctx));
+  }
+  TEST_ASSERT_EQUAL(1, sSysExEndCount);
+  TEST_ASSERT_TRUE(sSysExComplete);
+  TEST_ASSERT_EQUAL((sizeof(data) + kChunkSize - 1) / kChunkSize,
+      sSysExChunkCount);
+  TEST_ASSERT_EQUAL(LARGE_SYS_EX_SIZE, sSysExStreamSize);
+  TEST_ASSERT_EQUAL_MEMORY(&data[1], sSysExStream, LARGE_SYS_EX_SIZE);
+  TEST_ASSERT_EQUAL(MIDI_NONE, rx_ctx.status);
+  TEST_ASSERT_EQUAL(2, callbacks.rx.next_sys_ex_rx_event_id);
+}
+
+static void TestMidiReceiverStreamSysEx_Interrupted(void) {
+  static uint8_t const kInterruptedPacket[] = {
+    MIDI_SYSTEM_EXCLUSIVE, MIDI_NON_REAL_TIME_ID, 0x10,
+    MIDI_NOTE_ON | MIDI_CHANNEL_4, MIDI_MIDDLE_C,  MIDI_NOTE_ON_VELOCITY
+  };
+  midi_rx_ctx_t rx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t message;
+  ResetSysExStreamCallbacks(&callbacks);
+  MidiInitializeReceiverCtx(&rx_ctx);
+  TEST_ASSERT_TRUE(MidiReceiverSetCallbacks(&rx_ctx, &callbacks));
+  TEST_ASSERT_TRUE(MidiReceiverSetSysExMode(&rx_ctx, MIDI_RX_SYS_EX_STREAM));
+
+  TEST_ASSERT_EQUAL(sizeof(kInterruptedPacket), MidiReceiveData(
+      &rx_ctx, kInterruptedPacket, sizeof(kInterruptedPacket), &message));
+  TEST_ASSERT_EQUAL(kNoteOnMessage.type, message.type);
+  TEST_ASSERT_EQUAL(1, sSysExStartCount);
+  TEST_ASSERT_EQUAL(1, sSysExChunkCount);
+  TEST_ASSERT_EQUAL(2, sSysExStreamSize);
+  TEST_ASSERT_EQUAL(1, sSysExEndCount);
+  TEST_ASSERT_FALSE(sSysExComplete);
+}
+
+static void TestMidiReceiverStreamSysEx_AbortedByModeChange(void) {
+  static uint8_t const kPartialPacket[] = {
+    MIDI_SYSTEM_EXCLUSIVE, MIDI_NON_REAL_TIME_ID, 0x10
+  };
+  midi_rx_ctx_t rx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t message;
+  ResetSysExStreamCallbacks(&callbacks);
+  MidiInitializeReceiverCtx(&rx_ctx);
+  TEST_ASSERT_TRUE(MidiReceiverSetCallbacks(&rx_ctx, &callbacks));
+  TEST_ASSERT_TRUE(MidiReceiverSetSysExMode(&rx_ctx, MIDI_RX_SYS_EX_STREAM));
+
+  MidiReceiveData(&rx_ctx, kPartialPacket, sizeof(kPartialPacket), &message);
+  TEST_ASSERT_EQUAL(1, sSysExStartCount);
+  TEST_ASSERT_EQUAL(0, sSysExEndCount);
+
+  TEST_ASSERT_TRUE(MidiReceiverSetSysExMode(&rx_ctx, MIDI_RX_SYS_EX_RAW));
+  TEST_ASSERT_EQUAL(1, sSysExEndCount);
+  TEST_ASSERT_FALSE(sSysExComplete);
+  TEST_ASSERT_EQUAL(MIDI_NONE, rx_ctx.status);
+}
+
+static void TestMidiReceiverStreamSysEx_AbortedByCallbacks(void) {
+  static uint8_t const kPartialPacket[] = {
+    MIDI_SYSTEM_EXCLUSIVE, MIDI_NON_REAL_TIME_ID, 0x10
+  };
+  midi_rx_ctx_t rx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t message;
+  ResetSysExStreamCallbacks(&callbacks);
+  MidiInitializeReceiverCtx(&rx_ctx);
+  TEST_ASSERT_TRUE(MidiReceiverSetCallbacks(&rx_ctx, &callbacks));
+  TEST_ASSERT_TRUE(MidiReceiverSetSysExMode(&rx_ctx, MIDI_RX_SYS_EX_STREAM));
+
+  MidiReceiveData(&rx_ctx, kPartialPacket, sizeof(kPartialPacket), &message);
+  TEST_ASSERT_EQUAL(1, sSysExStartCount);
+  /* Setting the same callbacks does not end the stream. */
+  TEST_ASSERT_TRUE(MidiReceiverSetCallbacks(&rx_ctx, &callbacks));
+  TEST_ASSERT_EQUAL(0, sSysExEndCount);
+
+  /* Detached callbacks receive the end of the stream. */
+  TEST_ASSERT_TRUE(MidiReceiverSetCallbacks(&rx_ctx, NULL));
+  TEST_ASSERT_EQUAL(1, sSysExEndCount);
+  TEST_ASSERT_FALSE(sSysExComplete);
+  TEST_ASSERT_EQUAL(MIDI_RX_SYS_EX_DECODE, rx_ctx.sys_ex_mode);
+  TEST_ASSERT_EQUAL(MIDI_NONE, rx_ctx.status);
+}
+
+/* Realtime messages. */
+
+static void TestMidiReceiverRealtime_WithinMessage(void) {
+  static uint8_t const kInterleavedPacket[] = {
+    MIDI_NOTE_ON | MIDI_CHANNEL_4, MIDI_TIMING_CLOCK, MIDI_MIDDLE_C,
+    MIDI_TIMING_CLOCK, MIDI_NOTE_ON_VELOCITY,
+    /* Running status, with a reserved realtime byte. */
+    MIDI_MIDDLE_C + 4, 0xF9, MIDI_NOTE_ON_VELOCITY
+  };
+  midi_rx_ctx_t rx_ctx;
+  midi_message_t messages[4];
+  size_t consumed = 0;
+  MidiInitializeReceiverCtx(&rx_ctx);
+  TEST_ASSERT_EQUAL(4, MidiReceiveDataBatch(
+      &rx_ctx, kInterleavedPacket, sizeof(kInterleavedPacket),
+      messages, 4, &consumed));
+  TEST_ASSERT_EQUAL(sizeof(kInterleavedPacket), consumed);
+  TEST_ASSERT_EQUAL(MIDI_TIMING_CLOCK, messages[0].type);
+  TEST_ASSERT_EQUAL(MIDI_TIMING_CLOCK, messages[1].type);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, messages[2].type);
+  TEST_ASSERT_EQUAL(MIDI_CHANNEL_4, messages[2].channel);
+  TEST_ASSERT_EQUAL(MIDI_MIDDLE_C, messages[2].note.key);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON_VELOCITY, messages[2].note.velocity);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, messages[3].type);
+  TEST_ASSERT_EQUAL(MIDI_MIDDLE_C + 4, messages[3].note.key);
+  TEST_ASSERT_EQUAL(kNoteOnStatus, rx_ctx.status);
+}
+
+static void TestMidiReceiverRealtime_WithinSysEx(void) {
+  static size_t const kPacketSize = sizeof(kDeviceControlBalanceSysExPacket);
+  uint8_t data[sizeof(kDeviceControlBalanceSysExPacket) + 1];
+  memcpy(data, kDeviceControlBalanceSysExPacket, 4);
+  data[4] = MIDI_ACTIVE_SENSING;
+  memcpy(&data[5], &kDeviceControlBalanceSysExPacket[4], kPacketSize - 4);
+  midi_rx_ctx_t rx_ctx;
+  midi_message_t message;
+  MidiInitializeReceiverCtx(&rx_ctx);
+  TEST_ASSERT_EQUAL(5, MidiReceiveData(&rx_ctx, data, sizeof(data), &message));
+  TEST_ASSERT_EQUAL(MIDI_ACTIVE_SENSING, message.type);
+  TEST_ASSERT_EQUAL(MIDI_SYSTEM_EXCLUSIVE, rx_ctx.status);
+  TEST_ASSERT_EQUAL(sizeof(data) - 5, MidiReceiveData(
+      &rx_ctx, &data[5], sizeof(data) - 5, &message));
+  TEST_ASSERT_EQUAL(MIDI_SYSTEM_EXCLUSIVE, message.type);
+  TEST_ASSERT_EQUAL(
+      kDeviceControlBalanceSysExMessage.sys_ex.device_control.balance,
+      message.sys_ex.device_control.balance);
+}
+
+static size_t sTimingClockCount = 0;
+static size_t sSystemResetCount = 0;
+
+static void TimingClockCallback(midi_rx_event_t const *rx_event) {
+  TEST_ASSERT_NOT_NULL(rx_event);
+  ++sTimingClockCount;
+}
+
+static void SystemResetCallback(
+    midi_rx_event_t const *rx_event, bool_t *soft_reset) {
+  TEST_ASSERT_NOT_NULL(rx_event);
+  TEST_ASSERT_NOT_NULL(soft_reset);
+  ++sSystemResetCount;
+}
+
+static void TestMidiReceiverRealtime_Callbacks(void) {
+  uint8_t data[sizeof(kDataPacketSysExPacket) + 3];
+  memcpy(data, kDataPacketSysExPacket, 10);
+  data[10] = MIDI_TIMING_CLOCK;
+  memcpy(&data[11], &kDataPacketSysExPacket[10], 40);
+  data[51] = MIDI_SYSTEM_RESET;
+  data[52] = MIDI_TIMING_CLOCK;
+  memcpy(&data[53], &kDataPacketSysExPacket[50],
+      sizeof(kDataPacketSysExPacket) - 50);
+  midi_rx_ctx_t rx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t message;
+  ResetSysExDataCallback(&callbacks);
+  callbacks.rx.OnTimingClock = TimingClockCallback;
+  callbacks.rx.OnSystemReset = SystemResetCallback;
+  sTimingClockCount = 0;
+  sSystemResetCount = 0;
+  MidiInitializeReceiverCtx(&rx_ctx);
+  TEST_ASSERT_TRUE(MidiReceiverSetCallbacks(&rx_ctx, &callbacks));
+  TEST_ASSERT_TRUE(MidiReceiverSetSysExMode(&rx_ctx, MIDI_RX_SYS_EX_RAW));
+
+  /* Realtime messages are not returned. */
+  MidiReceiveData(&rx_ctx, data, sizeof(data), &message);
+  TEST_ASSERT_EQUAL(MIDI_NONE, message.type);
+  TEST_ASSERT_EQUAL(2, sTimingClockCount);
+  TEST_ASSERT_EQUAL(1, sSystemResetCount);
+  /* Split SysEx is staged, without the realtime bytes. */
+  TEST_ASSERT_EQUAL(1, sSysExDataCount);
+  TEST_ASSERT_EQUAL(sizeof(kDataPacketSysExPacket) - 2, sSysExDataSize);
+  TEST_ASSERT_EQUAL_MEMORY(&kDataPacketSysExPacket[1], sSysExDataCopy,
+      sizeof(kDataPacketSysExPacket) - 2);
+}
+
+/* Receive timestamps. */
+
+static midi_timestamp_t sRealtimeTimestamp = 0;
+
+static void TimestampedClockCallback(midi_rx_event_t const *rx_event) {
+  sRealtimeTimestamp = rx_event->timestamp;
+}
+
+static void TestMidiReceiverTimestamps(void) {
+  static uint8_t const kPacket[] = {
+    MIDI_NOTE_ON | MIDI_CHANNEL_4, MIDI_MIDDLE_C, MIDI_TIMING_CLOCK,
+    MIDI_NOTE_ON_VELOCITY,
+    /* Running status. */
+    MIDI_MIDDLE_C + 4, MIDI_NOTE_ON_VELOCITY
+  };
+  static midi_timestamp_t const kTimestamps[] = {
+    100, 101, 102, 103, 200, 201
+  };
+  midi_rx_ctx_t rx_ctx;
+  midi_message_t message;
+  MidiInitializeReceiverCtx(&rx_ctx);
+  TEST_ASSERT_EQUAL(0, MidiReceiveTimestampedData(
+      &rx_ctx, kPacket, NULL, sizeof(kPacket), &message));
+
+  /* Realtime is returned first, with its own timestamp. */
+  size_t di = MidiReceiveTimestampedData(
+      &rx_ctx, kPacket, kTimestamps, sizeof(kPacket), &message);
+  TEST_ASSERT_EQUAL(3, di);
+  TEST_ASSERT_EQUAL(MIDI_TIMING_CLOCK, message.type);
+  TEST_ASSERT_EQUAL(102, rx_ctx.timestamp);
+  di += MidiReceiveTimestampedData(
+      &rx_ctx, &kPacket[di], &kTimestamps[di], sizeof(kPacket) - di,
+      &message);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, message.type);
+  TEST_ASSERT_EQUAL(100, rx_ctx.timestamp);
+  /* The running status message is stamped by its first data byte. */
+  di += MidiReceiveTimestampedData(
+      &rx_ctx, &kPacket[di], &kTimestamps[di], sizeof(kPacket) - di,
+      &message);
+  TEST_ASSERT_EQUAL(sizeof(kPacket), di);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, message.type);
+  TEST_ASSERT_EQUAL(MIDI_MIDDLE_C + 4, message.note.key);
+  TEST_ASSERT_EQUAL(200, rx_ctx.timestamp);
+
+  /* Split across calls. */
+  TEST_ASSERT_GREATER_THAN(1, MidiReceiveTimestampedData(
+      &rx_ctx, kPacket, kTimestamps, 2, &message));
+  TEST_ASSERT_EQUAL(MIDI_NONE, message.type);
+  midi_timestamp_t const kLateTimestamps[] = { 300 };
+  TEST_ASSERT_EQUAL(1, MidiReceiveTimestampedData(
+      &rx_ctx, &kPacket[3], kLateTimestamps, 1, &message));
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, message.type);
+  TEST_ASSERT_EQUAL(100, rx_ctx.timestamp);
+
+  /* Realtime callbacks are given the timestamp. */
+  midi_callbacks_t callbacks;
+  MidiInitializeCallbacks(&callbacks);
+  callbacks.rx.OnTimingClock = TimestampedClockCallback;
+  TEST_ASSERT_TRUE(MidiReceiverSetCallbacks(&rx_ctx, &callbacks));
+  sRealtimeTimestamp = 0;
+  TEST_ASSERT_EQUAL(sizeof(kPacket) - 2, MidiReceiveTimestampedData(
+      &rx_ctx, kPacket, kTimestamps, sizeof(kPacket) - 2, &message));
+  TEST_ASSERT_EQUAL(102, sRealtimeTimestamp);
+  TEST_ASSERT_EQUAL(100, rx_ctx.timestamp);
+  /* Plain receive does not use timestamps. */
+  TEST_ASSERT_EQUAL(2, MidiReceiveData(&rx_ctx, &kPacket[4], 2, &message));
+  TEST_ASSERT_EQUAL(0, rx_ctx.timestamp);
+}
+
+/* Channel mask. */
+
+static void TestMidiReceiverChannelMask_SkipsMaskedChannels(void) {
+  static uint8_t const kMixedPacket[] = {
+    /* Masked, with running status and a realtime byte. */
+    MIDI_NOTE_ON | MIDI_CHANNEL_1, MIDI_MIDDLE_C, MIDI_NOTE_ON_VELOCITY,
+    MIDI_MIDDLE_C + 4, MIDI_TIMING_CLOCK, MIDI_NOTE_ON_VELOCITY,
+    /* Accepted. */
+    MIDI_NOTE_ON | MIDI_CHANNEL_4, MIDI_MIDDLE_C, MIDI_NOTE_ON_VELOCITY,
+    /* Masked, interrupting running status. */
+    MIDI_CONTROL_CHANGE | MIDI_CHANNEL_2, 0x07, 0x7F,
+    /* System messages are never masked. */
+    MIDI_SONG_SELECT, 0x05,
+    MIDI_NOTE_ON | MIDI_CHANNEL_4, MIDI_MIDDLE_C, 0x00
+  };
+  midi_rx_ctx_t rx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t messages[4];
+  size_t consumed = 0;
+  MidiInitializeCallbacks(&callbacks);
+  callbacks.rx.OnTimingClock = TimingClockCallback;
+  TEST_ASSERT_TRUE(MidiSetChannelMask(
+      &callbacks, MidiChannelMaskBit(MIDI_CHANNEL_4)));
+  sTimingClockCount = 0;
+  MidiInitializeReceiverCtx(&rx_ctx);
+  TEST_ASSERT_TRUE(MidiReceiverSetCallbacks(&rx_ctx, &callbacks));
+
+  TEST_ASSERT_EQUAL(3, MidiReceiveDataBatch(
+      &rx_ctx, kMixedPacket, sizeof(kMixedPacket), messages, 4, &consumed));
+  TEST_ASSERT_EQUAL(sizeof(kMixedPacket), consumed);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, messages[0].type);
+  TEST_ASSERT_EQUAL(MIDI_CHANNEL_4, messages[0].channel);
+  TEST_ASSERT_EQUAL(MIDI_SONG_SELECT, messages[1].type);
+  TEST_ASSERT_EQUAL(5, messages[1].song_number);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON, messages[2].type);
+  TEST_ASSERT_EQUAL(MIDI_CHANNEL_4, messages[2].channel);
+  /* Realtime bytes within masked messages are still received. */
+  TEST_ASSERT_EQUAL(1, sTimingClockCount);
+
+  /* Masking everything drops all channel messages. */
+  TEST_ASSERT_TRUE(MidiSetChannelMask(&callbacks, MIDI_CHANNEL_MASK_NONE));
+  TEST_ASSERT_EQUAL(0, MidiReceiveDataBatch(
+      &rx_ctx, kNoteOnPacket, sizeof(kNoteOnPacket), messages, 4, &consumed));
+  TEST_ASSERT_EQUAL(sizeof(kNoteOnPacket), consumed);
+  TEST_ASSERT_EQUAL(MIDI_NONE, rx_ctx.status);
+}
+
+static void TestMidiReceiverChannelMask_Compact(void) {
+  static uint8_t const kMixedPacket[] = {
+    MIDI_NOTE_ON | MIDI_CHANNEL_1, MIDI_MIDDLE_C, MIDI_NOTE_ON_VELOCITY,
+    MIDI_MIDDLE_C + 4, MIDI_NOTE_ON_VELOCITY,
+    MIDI_NOTE_ON | MIDI_CHANNEL_4, MIDI_MIDDLE_C, MIDI_NOTE_ON_VELOCITY
+  };
+  midi_compact_rx_ctx_t rx_ctx;
+  midi_callbacks_t callbacks;
+  midi_compact_message_t messages[4];
+  size_t consumed = 0;
+  MidiInitializeCallbacks(&callbacks);
+  TEST_ASSERT_TRUE(MidiSetChannelMask(
+      &callbacks, MidiChannelMaskBit(MIDI_CHANNEL_4)));
+  MidiInitializeCompactReceiverCtx(&rx_ctx, &callbacks);
+  TEST_ASSERT_EQUAL(1, MidiReceiveCompactData(
+      &rx_ctx, kMixedPacket, sizeof(kMixedPacket), messages, 4, &consumed));
+  TEST_ASSERT_EQUAL(sizeof(kMixedPacket), consumed);
+  TEST_ASSERT_EQUAL(MIDI_NOTE_ON | MIDI_CHANNEL_4, messages[0].status);
+}
+
 static void TestMidiTransmitter_Initialize(void) {
   midi_tx_ctx_t tx_ctx;
   TEST_ASSERT_FALSE(MidiInitializeTransmitterCtx(NULL, true));
@@ -634,7 +1290,7 @@ static void TestMidiTransmitter_MultipleSysExMessages_WithRun(void) {
   uint8_t buffer[64];
   TEST_ASSERT_TRUE(MidiInitializeTransmitterCtx(&tx_ctx, true));
   TEST_ASSERT_EQUAL(sizeof(expected_data), MidiTransmitterSerializeMessages(
-      &tx_ctx, messages, 4, buffer, sizeof(buffer)));
+      &tx_ctx, messages, 2, buffer, sizeof(buffer)));
   /* SysEx messages should not use status run. */
   TEST_ASSERT_EQUAL(MIDI_NONE, tx_ctx.status);
   TEST_ASSERT_EQUAL_MEMORY(expected_data, buffer, sizeof(expected_data));
@@ -650,11 +1306,36 @@ void MidiTransceiverTest(void) {
   RUN_TEST(TestMidiReceiver_MultiByteMessage);
   RUN_TEST(TestMidiReceiver_MultiByteMessage_Transition);
   RUN_TEST(TestMidiReceiver_MultiByteMessage_StatusRun);
+  RUN_TEST(TestMidiReceiver_MultiByteMessage_RewindBuffer);
   RUN_TEST(TestMidiReceiver_SysEx_SmallMessage);
   RUN_TEST(TestMidiReceiver_SysEx_Large);
 
   RUN_TEST(TestMidiReceiver_FuzzTest);
 
+  RUN_TEST(TestMidiReceiverBatch_InvalidParameters);
+  RUN_TEST(TestMidiReceiverBatch_MultipleMessages);
+  RUN_TEST(TestMidiReceiverBatch_MessageLimit);
+  RUN_TEST(TestMidiReceiverBatch_MatchesSingle);
+
+  RUN_TEST(TestMidiReceiverRawSysEx_SetMode);
+  RUN_TEST(TestMidiReceiverRawSysEx_SingleRead);
+  RUN_TEST(TestMidiReceiverRawSysEx_MultipleReads);
+  RUN_TEST(TestMidiReceiverRawSysEx_Interrupted);
+
+  RUN_TEST(TestMidiReceiverStreamSysEx_Large);
+  RUN_TEST(TestMidiReceiverStreamSysEx_Interrupted);
+  RUN_TEST(TestMidiReceiverStreamSysEx_AbortedByModeChange);
+  RUN_TEST(TestMidiReceiverStreamSysEx_AbortedByCallbacks);
+
+  RUN_TEST(TestMidiReceiverRealtime_WithinMessage);
+  RUN_TEST(TestMidiReceiverRealtime_WithinSysEx);
+  RUN_TEST(TestMidiReceiverRealtime_Callbacks);
+
+  RUN_TEST(TestMidiReceiverTimestamps);
+
+  RUN_TEST(TestMidiReceiverChannelMask_SkipsMaskedChannels);
+  RUN_TEST(TestMidiReceiverChannelMask_Compact);
+
   RUN_TEST(TestMidiTransmitter_Initialize);
   RUN_TEST(TestMidiTransmitter_InvalidParameters);
   RUN_TEST(TestMidiTransmitter_MultiByteMessage_WithoutRun);
@@ -0,0 +1,57 @@
+/*
+ * MIDI Controller - MIDI Transmitter Test Fixture
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <string.h>
+#include <unity.h>
+
+#include "midi_callback_internal.h"
+#include "midi_defs.h"
+#include "midi_tx_fixture.h"
+
+size_t gTxWriteCount = 0;
+size_t gTxWriteSize = 0;
+uint8_t gTxWriteBuffer[MIDI_TX_FIXTURE_BUFFER_SIZE];
+size_t gTxRealtimeCount = 0;
+
+static void MidiTxFixtureAppend(uint8_t const *data, size_t data_size) {
+  TEST_ASSERT_TRUE((gTxWriteSize + data_size) <= sizeof(gTxWriteBuffer));
+  memcpy(&gTxWriteBuffer[gTxWriteSize], data, data_size);
+  gTxWriteSize += data_size;
+}
+
+static void MidiTxFixtureWriteData(
+    midi_tx_event_t const *tx_event, uint8_t const *data, size_t data_size) {
+  TEST_ASSERT_NOT_NULL(tx_event);
+  ++gTxWriteCount;
+  MidiTxFixtureAppend(data, data_size);
+}
+
+static void MidiTxFixtureWriteRealtime(
+    midi_tx_event_t const *tx_event, uint8_t const *data, size_t data_size) {
+  TEST_ASSERT_NOT_NULL(tx_event);
+  TEST_ASSERT_EQUAL(1, data_size);
+  ++gTxRealtimeCount;
+  MidiTxFixtureAppend(data, data_size);
+}
+
+void MidiTxFixtureReset(midi_callbacks_t *callbacks) {
+  MidiInitializeCallbacks(callbacks);
+  callbacks->tx.WriteData = MidiTxFixtureWriteData;
+  callbacks->tx.WriteRealtime = MidiTxFixtureWriteRealtime;
+  gTxWriteCount = 0;
+  gTxWriteSize = 0;
+  gTxRealtimeCount = 0;
+  memset(gTxWriteBuffer, 0, sizeof(gTxWriteBuffer));
+}
+
+void MidiTxFixtureNoteMessage(
+    midi_message_t *message, midi_channel_number_t channel,
+    bool_t on, uint8_t key) {
+  midi_note_t note;
+  TEST_ASSERT_TRUE(MidiNote(&note, key, MIDI_NOTE_ON_VELOCITY));
+  TEST_ASSERT_TRUE(MidiNoteMessage(message, channel, on, &note));
+}
@@ -0,0 +1,41 @@
+/*
+ * MIDI Controller - MIDI Transmitter Test Fixture
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MIDI_TX_FIXTURE_H_
+#define _MIDI_TX_FIXTURE_H_
+
+#include "base.h"
+#include "midi_callback.h"
+#include "midi_message.h"
+
+C_SECTION_BEGIN;
+
+/* Shared by the transmitter queue and lanes tests.  Everything
+ * written through the callbacks installed by MidiTxFixtureReset() is
+ * appended to |gTxWriteBuffer|, realtime bytes included, so that tests
+ * can check the ordering of the whole stream. */
+
+#define MIDI_TX_FIXTURE_BUFFER_SIZE 256
+
+/* Number of WriteData calls, not counting realtime writes. */
+extern size_t gTxWriteCount;
+extern size_t gTxWriteSize;
+extern uint8_t gTxWriteBuffer[MIDI_TX_FIXTURE_BUFFER_SIZE];
+/* Number of WriteRealtime calls. */
+extern size_t gTxRealtimeCount;
+
+/* Initializes |callbacks| with the recording writers and clears the
+ * recorded stream. */
+void MidiTxFixtureReset(midi_callbacks_t *callbacks);
+
+void MidiTxFixtureNoteMessage(
+    midi_message_t *message, midi_channel_number_t channel,
+    bool_t on, uint8_t key);
+
+C_SECTION_END;
+
+#endif  /* _MIDI_TX_FIXTURE_H_ */
@@ -0,0 +1,231 @@
+/*
+ * MIDI Controller - MIDI Transmitter Lanes Test.
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <string.h>
+#include <unity.h>
+
+#include "midi_callback_internal.h"
+#include "midi_defs.h"
+#include "midi_tx_fixture.h"
+#include "midi_tx_lanes.h"
+
+static void TestMidiTxLanes_Initialize(void) {
+  midi_tx_lanes_t lanes;
+  midi_tx_ctx_t tx_ctx;
+  midi_callbacks_t callbacks;
+  midi_tx_lane_stats_t stats;
+  MidiInitializeTransmitterCtx(&tx_ctx, true);
+  MidiInitializeCallbacks(&callbacks);
+  TEST_ASSERT_FALSE(MidiInitializeTxLanes(NULL, &tx_ctx, &callbacks, 1));
+  /* Requires a writer. */
+  TEST_ASSERT_FALSE(MidiInitializeTxLanes(&lanes, &tx_ctx, &callbacks, 1));
+  MidiTxFixtureReset(&callbacks);
+  TEST_ASSERT_TRUE(MidiInitializeTxLanes(&lanes, &tx_ctx, &callbacks, 1));
+  TEST_ASSERT_TRUE(MidiTxLanesIsIdle(&lanes));
+  MidiTxLanesPoll(&lanes, 100);
+  TEST_ASSERT_EQUAL(0, gTxWriteCount);
+  TEST_ASSERT_TRUE(MidiGetTxLaneStats(&lanes, MIDI_TX_LANE_BULK, &stats));
+  TEST_ASSERT_EQUAL(0, stats.queued);
+  TEST_ASSERT_FALSE(MidiGetTxLaneStats(&lanes, MIDI_TX_LANE_COUNT, &stats));
+}
+
+static void TestMidiTxLanes_RealtimeIsImmediate(void) {
+  static uint8_t const kExpectedData[] = {
+    MIDI_TIMING_CLOCK,
+    MIDI_NOTE_ON | MIDI_CHANNEL_1, 0x40, MIDI_NOTE_ON_VELOCITY
+  };
+  midi_tx_lanes_t lanes;
+  midi_tx_ctx_t tx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t message;
+  midi_tx_lane_stats_t stats;
+  MidiInitializeTransmitterCtx(&tx_ctx, true);
+  MidiTxFixtureReset(&callbacks);
+  TEST_ASSERT_TRUE(MidiInitializeTxLanes(&lanes, &tx_ctx, &callbacks, 5));
+
+  MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_1, true, 0x40);
+  TEST_ASSERT_TRUE(MidiTxLanesEnqueue(&lanes, &message, 0));
+  memset(&message, 0, sizeof(message));
+  message.type = MIDI_TIMING_CLOCK;
+  TEST_ASSERT_TRUE(MidiTxLanesEnqueue(&lanes, &message, 1));
+  TEST_ASSERT_EQUAL(1, gTxRealtimeCount);
+  TEST_ASSERT_EQUAL(0, gTxWriteCount);
+
+  MidiTxLanesPoll(&lanes, 4);
+  TEST_ASSERT_EQUAL(0, gTxWriteCount);
+  MidiTxLanesPoll(&lanes, 5);
+  TEST_ASSERT_EQUAL(1, gTxWriteCount);
+  TEST_ASSERT_EQUAL(sizeof(kExpectedData), gTxWriteSize);
+  TEST_ASSERT_EQUAL_MEMORY(kExpectedData, gTxWriteBuffer, sizeof(kExpectedData));
+
+  TEST_ASSERT_TRUE(MidiGetTxLaneStats(&lanes, MIDI_TX_LANE_VOICE, &stats));
+  TEST_ASSERT_EQUAL(1, stats.queued);
+  TEST_ASSERT_EQUAL(1, stats.written);
+  TEST_ASSERT_EQUAL(0, stats.depth);
+  TEST_ASSERT_EQUAL(5, stats.last_latency_ms);
+  TEST_ASSERT_TRUE(MidiGetTxLaneStats(&lanes, MIDI_TX_LANE_REALTIME, &stats));
+  TEST_ASSERT_EQUAL(1, stats.written);
+}
+
+static void TestMidiTxLanes_BulkIsChunked(void) {
+  uint8_t packet[MIDI_TX_BULK_CHUNK_SIZE + 4];
+  midi_tx_lanes_t lanes;
+  midi_tx_ctx_t tx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t message;
+  midi_tx_lane_stats_t stats;
+  MidiInitializeTransmitterCtx(&tx_ctx, true);
+  MidiTxFixtureReset(&callbacks);
+  TEST_ASSERT_TRUE(MidiInitializeTxLanes(&lanes, &tx_ctx, &callbacks, 5));
+
+  memset(packet, 0x11, sizeof(packet));
+  /* Must be a complete SysEx packet. */
+  TEST_ASSERT_FALSE(MidiTxLanesEnqueueBulk(&lanes, packet, sizeof(packet), 0));
+  packet[0] = MIDI_SYSTEM_EXCLUSIVE;
+  packet[sizeof(packet) - 1] = MIDI_END_SYSTEM_EXCLUSIVE;
+  TEST_ASSERT_TRUE(MidiTxLanesEnqueueBulk(&lanes, packet, sizeof(packet), 0));
+  TEST_ASSERT_FALSE(MidiTxLanesIsIdle(&lanes));
+
+  MidiTxLanesPoll(&lanes, 1);
+  TEST_ASSERT_EQUAL(1, gTxWriteCount);
+  TEST_ASSERT_EQUAL(MIDI_TX_BULK_CHUNK_SIZE, gTxWriteSize);
+
+  /* Realtime goes within the packet, voice waits for the end. */
+  memset(&message, 0, sizeof(message));
+  message.type = MIDI_TIMING_CLOCK;
+  TEST_ASSERT_TRUE(MidiTxLanesEnqueue(&lanes, &message, 2));
+  MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_1, true, 0x40);
+  TEST_ASSERT_TRUE(MidiTxLanesEnqueue(&lanes, &message, 2));
+  MidiTxLanesPoll(&lanes, 10);
+  TEST_ASSERT_EQUAL(2, gTxWriteCount);
+  TEST_ASSERT_EQUAL(sizeof(packet) + 1, gTxWriteSize);
+  TEST_ASSERT_EQUAL(MIDI_TIMING_CLOCK, gTxWriteBuffer[MIDI_TX_BULK_CHUNK_SIZE]);
+  TEST_ASSERT_EQUAL(
+      MIDI_END_SYSTEM_EXCLUSIVE, gTxWriteBuffer[sizeof(packet)]);
+
+  MidiTxLanesPoll(&lanes, 11);
+  TEST_ASSERT_EQUAL(3, gTxWriteCount);
+  TEST_ASSERT_EQUAL(
+      MIDI_NOTE_ON | MIDI_CHANNEL_1, gTxWriteBuffer[sizeof(packet) + 1]);
+  TEST_ASSERT_TRUE(MidiTxLanesIsIdle(&lanes));
+
+  TEST_ASSERT_TRUE(MidiGetTxLaneStats(&lanes, MIDI_TX_LANE_BULK, &stats));
+  TEST_ASSERT_EQUAL(1, stats.queued);
+  TEST_ASSERT_EQUAL(1, stats.written);
+  TEST_ASSERT_EQUAL(1, stats.max_depth);
+  TEST_ASSERT_EQUAL(1, stats.last_latency_ms);
+}
+
+static void TestMidiTxLanes_VoiceBetweenPackets(void) {
+  static uint8_t const kPacket[] = {
+    MIDI_SYSTEM_EXCLUSIVE, 0x7D, 0x01, MIDI_END_SYSTEM_EXCLUSIVE
+  };
+  static uint8_t const kExpectedData[] = {
+    MIDI_SYSTEM_EXCLUSIVE, 0x7D, 0x01, MIDI_END_SYSTEM_EXCLUSIVE,
+    MIDI_NOTE_ON | MIDI_CHANNEL_1, 0x40, MIDI_NOTE_ON_VELOCITY,
+    MIDI_SYSTEM_EXCLUSIVE, 0x7D, 0x01, MIDI_END_SYSTEM_EXCLUSIVE,
+    /* Running status is not used after the SysEx. */
+    MIDI_NOTE_ON | MIDI_CHANNEL_1, 0x41, MIDI_NOTE_ON_VELOCITY
+  };
+  midi_tx_lanes_t lanes;
+  midi_tx_ctx_t tx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t message;
+  MidiInitializeTransmitterCtx(&tx_ctx, true);
+  MidiTxFixtureReset(&callbacks);
+  TEST_ASSERT_TRUE(MidiInitializeTxLanes(&lanes, &tx_ctx, &callbacks, 50));
+
+  TEST_ASSERT_TRUE(MidiTxLanesEnqueueBulk(&lanes, kPacket, sizeof(kPacket), 0));
+  TEST_ASSERT_TRUE(MidiTxLanesEnqueueBulk(&lanes, kPacket, sizeof(kPacket), 0));
+  MidiTxLanesPoll(&lanes, 0);
+  MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_1, true, 0x40);
+  TEST_ASSERT_TRUE(MidiTxLanesEnqueue(&lanes, &message, 0));
+  /* Pending voice data does not wait for its latency while bulk data
+   * is waiting. */
+  MidiTxLanesPoll(&lanes, 1);
+  MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_1, true, 0x41);
+  TEST_ASSERT_TRUE(MidiTxLanesEnqueue(&lanes, &message, 1));
+  MidiTxLanesPoll(&lanes, 2);
+  TEST_ASSERT_EQUAL(sizeof(kExpectedData) - 3, gTxWriteSize);
+  MidiTxLanesPoll(&lanes, 51);
+  TEST_ASSERT_EQUAL(sizeof(kExpectedData), gTxWriteSize);
+  TEST_ASSERT_EQUAL_MEMORY(kExpectedData, gTxWriteBuffer, sizeof(kExpectedData));
+}
+
+static void TestMidiTxLanes_VoiceFullWithinPacket(void) {
+  uint8_t packet[MIDI_TX_BULK_CHUNK_SIZE * 3];
+  midi_tx_lanes_t lanes;
+  midi_tx_ctx_t tx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t message;
+  MidiInitializeTransmitterCtx(&tx_ctx, true);
+  MidiTxFixtureReset(&callbacks);
+  TEST_ASSERT_TRUE(MidiInitializeTxLanes(&lanes, &tx_ctx, &callbacks, 50));
+  memset(packet, 0x11, sizeof(packet));
+  packet[0] = MIDI_SYSTEM_EXCLUSIVE;
+  packet[sizeof(packet) - 1] = MIDI_END_SYSTEM_EXCLUSIVE;
+  TEST_ASSERT_TRUE(MidiTxLanesEnqueueBulk(&lanes, packet, sizeof(packet), 0));
+  MidiTxLanesPoll(&lanes, 0);
+  TEST_ASSERT_EQUAL(MIDI_TX_BULK_CHUNK_SIZE, gTxWriteSize);
+
+  for (size_t i = 0; i < MIDI_TX_QUEUE_SIZE; ++i) {
+    MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_1, true, 0x40 + i);
+    TEST_ASSERT_TRUE(MidiTxLanesEnqueue(&lanes, &message, 1));
+  }
+  /* Voice lane is full, and cannot be flushed within the packet. */
+  MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_1, true, 0x20);
+  TEST_ASSERT_FALSE(MidiTxLanesEnqueue(&lanes, &message, 1));
+  TEST_ASSERT_EQUAL(1, gTxWriteCount);
+  TEST_ASSERT_EQUAL(MIDI_TX_BULK_CHUNK_SIZE, gTxWriteSize);
+
+  /* The rest of the packet is still chunked. */
+  MidiTxLanesPoll(&lanes, 2);
+  TEST_ASSERT_EQUAL(2, gTxWriteCount);
+  TEST_ASSERT_EQUAL(MIDI_TX_BULK_CHUNK_SIZE * 2, gTxWriteSize);
+  MidiTxLanesPoll(&lanes, 3);
+  TEST_ASSERT_EQUAL(3, gTxWriteCount);
+  TEST_ASSERT_EQUAL(sizeof(packet), gTxWriteSize);
+  TEST_ASSERT_EQUAL_MEMORY(packet, gTxWriteBuffer, sizeof(packet));
+
+  /* At the packet boundary the voice lane is flushed to make room. */
+  TEST_ASSERT_TRUE(MidiTxLanesEnqueue(&lanes, &message, 4));
+  TEST_ASSERT_EQUAL(4, gTxWriteCount);
+  TEST_ASSERT_EQUAL(
+      MIDI_NOTE_ON | MIDI_CHANNEL_1, gTxWriteBuffer[sizeof(packet)]);
+  TEST_ASSERT_EQUAL(0x40, gTxWriteBuffer[sizeof(packet) + 1]);
+  TEST_ASSERT_EQUAL(1, MidiTxQueueCount(&lanes.voice));
+}
+
+static void TestMidiTxLanes_BulkLaneFull(void) {
+  static uint8_t const kPacket[] = {
+    MIDI_SYSTEM_EXCLUSIVE, MIDI_END_SYSTEM_EXCLUSIVE
+  };
+  midi_tx_lanes_t lanes;
+  midi_tx_ctx_t tx_ctx;
+  midi_callbacks_t callbacks;
+  MidiInitializeTransmitterCtx(&tx_ctx, true);
+  MidiTxFixtureReset(&callbacks);
+  TEST_ASSERT_TRUE(MidiInitializeTxLanes(&lanes, &tx_ctx, &callbacks, 5));
+  for (size_t i = 0; i < MIDI_TX_BULK_LANE_SIZE; ++i) {
+    TEST_ASSERT_TRUE(
+        MidiTxLanesEnqueueBulk(&lanes, kPacket, sizeof(kPacket), 0));
+  }
+  TEST_ASSERT_FALSE(
+      MidiTxLanesEnqueueBulk(&lanes, kPacket, sizeof(kPacket), 0));
+  MidiTxLanesPoll(&lanes, 0);
+  TEST_ASSERT_TRUE(
+      MidiTxLanesEnqueueBulk(&lanes, kPacket, sizeof(kPacket), 0));
+}
+
+void MidiTxLanesTest(void) {
+  RUN_TEST(TestMidiTxLanes_Initialize);
+  RUN_TEST(TestMidiTxLanes_RealtimeIsImmediate);
+  RUN_TEST(TestMidiTxLanes_BulkIsChunked);
+  RUN_TEST(TestMidiTxLanes_VoiceBetweenPackets);
+  RUN_TEST(TestMidiTxLanes_VoiceFullWithinPacket);
+  RUN_TEST(TestMidiTxLanes_BulkLaneFull);
+}
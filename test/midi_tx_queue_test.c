@@ -0,0 +1,159 @@
+/*
+ * MIDI Controller - MIDI Transmitter Queue Test.
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include <string.h>
+#include <unity.h>
+
+#include "midi_callback_internal.h"
+#include "midi_defs.h"
+#include "midi_tx_fixture.h"
+#include "midi_tx_queue.h"
+
+static void TestMidiTxQueue_Initialize(void) {
+  midi_tx_queue_t queue;
+  midi_tx_ctx_t tx_ctx;
+  midi_callbacks_t callbacks;
+  MidiInitializeTransmitterCtx(&tx_ctx, true);
+  MidiInitializeCallbacks(&callbacks);
+  TEST_ASSERT_FALSE(MidiInitializeTxQueue(NULL, &tx_ctx, &callbacks, 1));
+  TEST_ASSERT_FALSE(MidiInitializeTxQueue(&queue, NULL, &callbacks, 1));
+  TEST_ASSERT_FALSE(MidiInitializeTxQueue(&queue, &tx_ctx, NULL, 1));
+  /* Requires a writer. */
+  TEST_ASSERT_FALSE(MidiInitializeTxQueue(&queue, &tx_ctx, &callbacks, 1));
+  MidiTxFixtureReset(&callbacks);
+  TEST_ASSERT_TRUE(MidiInitializeTxQueue(&queue, &tx_ctx, &callbacks, 1));
+  TEST_ASSERT_TRUE(MidiTxQueueIsEmpty(&queue));
+  TEST_ASSERT_EQUAL(0, MidiTxQueueFlush(&queue));
+  TEST_ASSERT_EQUAL(0, gTxWriteCount);
+}
+
+static void TestMidiTxQueue_GroupsByStatus(void) {
+  static uint8_t const kExpectedData[] = {
+    MIDI_NOTE_ON | MIDI_CHANNEL_1, 0x40, MIDI_NOTE_ON_VELOCITY,
+    0x41, MIDI_NOTE_ON_VELOCITY,
+    0x42, MIDI_NOTE_ON_VELOCITY,
+    MIDI_NOTE_ON | MIDI_CHANNEL_2, 0x50, MIDI_NOTE_ON_VELOCITY,
+    0x51, MIDI_NOTE_ON_VELOCITY
+  };
+  midi_tx_queue_t queue;
+  midi_tx_ctx_t tx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t message;
+  MidiInitializeTransmitterCtx(&tx_ctx, true);
+  MidiTxFixtureReset(&callbacks);
+  TEST_ASSERT_TRUE(MidiInitializeTxQueue(&queue, &tx_ctx, &callbacks, 10));
+
+  /* Two producers, interleaved. */
+  MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_1, true, 0x40);
+  TEST_ASSERT_TRUE(MidiTxQueueEnqueue(&queue, &message, 0));
+  MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_2, true, 0x50);
+  TEST_ASSERT_TRUE(MidiTxQueueEnqueue(&queue, &message, 0));
+  MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_1, true, 0x41);
+  TEST_ASSERT_TRUE(MidiTxQueueEnqueue(&queue, &message, 1));
+  MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_2, true, 0x51);
+  TEST_ASSERT_TRUE(MidiTxQueueEnqueue(&queue, &message, 1));
+  MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_1, true, 0x42);
+  TEST_ASSERT_TRUE(MidiTxQueueEnqueue(&queue, &message, 2));
+  TEST_ASSERT_EQUAL(5, MidiTxQueueCount(&queue));
+  TEST_ASSERT_EQUAL(0, gTxWriteCount);
+
+  TEST_ASSERT_EQUAL(sizeof(kExpectedData), MidiTxQueueFlush(&queue));
+  TEST_ASSERT_EQUAL(1, gTxWriteCount);
+  TEST_ASSERT_EQUAL(sizeof(kExpectedData), gTxWriteSize);
+  TEST_ASSERT_EQUAL_MEMORY(kExpectedData, gTxWriteBuffer, sizeof(kExpectedData));
+  TEST_ASSERT_TRUE(MidiTxQueueIsEmpty(&queue));
+}
+
+static void TestMidiTxQueue_PreservesChannelOrder(void) {
+  /* The second note on must not pass the note off of the same
+   * channel, and nothing passes the system message. */
+  static uint8_t const kExpectedData[] = {
+    MIDI_NOTE_ON | MIDI_CHANNEL_1, 0x40, MIDI_NOTE_ON_VELOCITY,
+    MIDI_NOTE_OFF | MIDI_CHANNEL_1, 0x40, MIDI_NOTE_ON_VELOCITY,
+    MIDI_NOTE_ON | MIDI_CHANNEL_1, 0x40, MIDI_NOTE_ON_VELOCITY,
+    MIDI_TUNE_REQUEST,
+    MIDI_NOTE_ON | MIDI_CHANNEL_1, 0x41, MIDI_NOTE_ON_VELOCITY
+  };
+  midi_tx_queue_t queue;
+  midi_tx_ctx_t tx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t message;
+  MidiInitializeTransmitterCtx(&tx_ctx, true);
+  MidiTxFixtureReset(&callbacks);
+  TEST_ASSERT_TRUE(MidiInitializeTxQueue(&queue, &tx_ctx, &callbacks, 10));
+
+  MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_1, true, 0x40);
+  TEST_ASSERT_TRUE(MidiTxQueueEnqueue(&queue, &message, 0));
+  MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_1, false, 0x40);
+  TEST_ASSERT_TRUE(MidiTxQueueEnqueue(&queue, &message, 0));
+  MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_1, true, 0x40);
+  TEST_ASSERT_TRUE(MidiTxQueueEnqueue(&queue, &message, 0));
+  memset(&message, 0, sizeof(message));
+  message.type = MIDI_TUNE_REQUEST;
+  TEST_ASSERT_TRUE(MidiTxQueueEnqueue(&queue, &message, 0));
+  MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_1, true, 0x41);
+  TEST_ASSERT_TRUE(MidiTxQueueEnqueue(&queue, &message, 0));
+
+  TEST_ASSERT_EQUAL(sizeof(kExpectedData), MidiTxQueueFlush(&queue));
+  TEST_ASSERT_EQUAL(1, gTxWriteCount);
+  TEST_ASSERT_EQUAL_MEMORY(kExpectedData, gTxWriteBuffer, sizeof(kExpectedData));
+}
+
+static void TestMidiTxQueue_FlushOnLatency(void) {
+  midi_tx_queue_t queue;
+  midi_tx_ctx_t tx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t message;
+  MidiInitializeTransmitterCtx(&tx_ctx, true);
+  MidiTxFixtureReset(&callbacks);
+  TEST_ASSERT_TRUE(MidiInitializeTxQueue(&queue, &tx_ctx, &callbacks, 5));
+
+  TEST_ASSERT_FALSE(MidiTxQueuePoll(&queue, 100));
+  MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_1, true, 0x40);
+  /* Time wraps around. */
+  TEST_ASSERT_TRUE(MidiTxQueueEnqueue(&queue, &message, 0xFFFFFFFE));
+  TEST_ASSERT_FALSE(MidiTxQueuePoll(&queue, 0xFFFFFFFF));
+  TEST_ASSERT_FALSE(MidiTxQueuePoll(&queue, 2));
+  TEST_ASSERT_EQUAL(0, gTxWriteCount);
+  TEST_ASSERT_TRUE(MidiTxQueuePoll(&queue, 3));
+  TEST_ASSERT_EQUAL(1, gTxWriteCount);
+  TEST_ASSERT_EQUAL(3, gTxWriteSize);
+  TEST_ASSERT_TRUE(MidiTxQueueIsEmpty(&queue));
+}
+
+static void TestMidiTxQueue_FlushOnFull(void) {
+  midi_tx_queue_t queue;
+  midi_tx_ctx_t tx_ctx;
+  midi_callbacks_t callbacks;
+  midi_message_t message;
+  MidiInitializeTransmitterCtx(&tx_ctx, true);
+  MidiTxFixtureReset(&callbacks);
+  TEST_ASSERT_TRUE(MidiInitializeTxQueue(&queue, &tx_ctx, &callbacks, 10));
+
+  MidiTxFixtureNoteMessage(&message, MIDI_CHANNEL_3, true, 0x40);
+  for (size_t i = 0; i < MIDI_TX_QUEUE_SIZE; ++i) {
+    TEST_ASSERT_TRUE(MidiTxQueueHasRoom(&queue, &message));
+    TEST_ASSERT_TRUE(MidiTxQueueEnqueue(&queue, &message, 0));
+  }
+  TEST_ASSERT_FALSE(MidiTxQueueHasRoom(&queue, &message));
+  TEST_ASSERT_EQUAL(0, gTxWriteCount);
+  TEST_ASSERT_TRUE(MidiTxQueueEnqueue(&queue, &message, 0));
+  TEST_ASSERT_EQUAL(1, gTxWriteCount);
+  /* Running status for all but the first. */
+  TEST_ASSERT_EQUAL(1 + MIDI_TX_QUEUE_SIZE * 2, gTxWriteSize);
+  TEST_ASSERT_EQUAL(1, MidiTxQueueCount(&queue));
+  /* Running status carries over between flushes. */
+  TEST_ASSERT_EQUAL(2, MidiTxQueueFlush(&queue));
+}
+
+void MidiTxQueueTest(void) {
+  RUN_TEST(TestMidiTxQueue_Initialize);
+  RUN_TEST(TestMidiTxQueue_GroupsByStatus);
+  RUN_TEST(TestMidiTxQueue_PreservesChannelOrder);
+  RUN_TEST(TestMidiTxQueue_FlushOnLatency);
+  RUN_TEST(TestMidiTxQueue_FlushOnFull);
+}
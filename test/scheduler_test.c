@@ -9,6 +9,8 @@
 #include <unity.h>
 
 #include "scheduler.h"
+#include "system_interrupt.h"
+#include "system_sleep.h"
 
 static system_time_t const kInitTime = {
   .seconds = 10,
@@ -346,6 +348,142 @@ static void TestSchedulerDelayCallbacks_Multiple_AllAtOnce(void) {
   TEST_ASSERT_EQUAL(0, scheduler.entry_count);
 }
 
+typedef struct {
+  scheduler_t *scheduler;
+  scheduler_timer_handle_t handle;
+  size_t calls;
+} cancel_ctx_t;
+
+static void CancelTimerCallback(void *ctx_ptr, system_time_t const *time) {
+  cancel_ctx_t *ctx = ctx_ptr;
+  ++ctx->calls;
+  TEST_ASSERT_TRUE(SchedulerIsTimerPending(ctx->scheduler, ctx->handle));
+  TEST_ASSERT_TRUE(SchedulerCancelTimer(ctx->scheduler, ctx->handle));
+}
+
+static void TestSchedulerTimerHandles_Cancel(void) {
+  scheduler_t scheduler;
+  TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &kInitTime));
+
+  timer_ctx_t ctx_a = {};
+  scheduler_timer_handle_t const handle_a =
+      SchedulerSetDelayedCallbackSeconds(
+          &scheduler, 10, NULL, TimerCallback, &ctx_a);
+  timer_ctx_t ctx_b = {};
+  scheduler_timer_handle_t const handle_b =
+      SchedulerSetPeriodicCallbackSeconds(
+          &scheduler, 5, NULL, TimerCallback, &ctx_b);
+  TEST_ASSERT_NOT_EQUAL(SCHEDULER_TIMER_HANDLE_NULL, handle_a);
+  TEST_ASSERT_NOT_EQUAL(SCHEDULER_TIMER_HANDLE_NULL, handle_b);
+  TEST_ASSERT_NOT_EQUAL(handle_a, handle_b);
+  TEST_ASSERT_EQUAL(SCHEDULER_TIMER_HANDLE_NULL,
+                    SchedulerSetDelayedCallbackSeconds(
+                        &scheduler, 10, NULL, NULL, &ctx_a));
+
+  TEST_ASSERT_FALSE(SchedulerCancelTimer(NULL, handle_a));
+  TEST_ASSERT_FALSE(SchedulerCancelTimer(
+      &scheduler, SCHEDULER_TIMER_HANDLE_NULL));
+  TEST_ASSERT_TRUE(SchedulerIsTimerPending(&scheduler, handle_a));
+  TEST_ASSERT_TRUE(SchedulerCancelTimer(&scheduler, handle_a));
+  TEST_ASSERT_FALSE(SchedulerIsTimerPending(&scheduler, handle_a));
+  TEST_ASSERT_FALSE(SchedulerCancelTimer(&scheduler, handle_a));
+  TEST_ASSERT_EQUAL(1, scheduler.entry_count);
+
+  /* The released slot is reused with a new handle. */
+  timer_ctx_t ctx_c = {};
+  scheduler_timer_handle_t const handle_c =
+      SchedulerSetDelayedCallbackSeconds(
+          &scheduler, 10, NULL, TimerCallback, &ctx_c);
+  TEST_ASSERT_NOT_EQUAL(SCHEDULER_TIMER_HANDLE_NULL, handle_c);
+  TEST_ASSERT_NOT_EQUAL(handle_a, handle_c);
+  TEST_ASSERT_FALSE(SchedulerIsTimerPending(&scheduler, handle_a));
+
+  static system_time_t const kCallbackTime = {
+    .seconds = kInitTime.seconds + 10
+  };
+  TEST_ASSERT_EQUAL(2, SchedulerDoCallbacks(&scheduler, &kCallbackTime));
+  TEST_ASSERT_FALSE(ctx_a.received);
+  TEST_ASSERT_TRUE(ctx_b.received);
+  TEST_ASSERT_TRUE(ctx_c.received);
+  /* Delayed callbacks are removed once called. */
+  TEST_ASSERT_FALSE(SchedulerIsTimerPending(&scheduler, handle_c));
+  TEST_ASSERT_TRUE(SchedulerIsTimerPending(&scheduler, handle_b));
+
+  /* Cancelled from within its own callback. */
+  cancel_ctx_t cctx = { .scheduler = &scheduler };
+  cctx.handle = SchedulerSetPeriodicCallbackSeconds(
+      &scheduler, 1, NULL, CancelTimerCallback, &cctx);
+  TEST_ASSERT_NOT_EQUAL(SCHEDULER_TIMER_HANDLE_NULL, cctx.handle);
+  static system_time_t const kCancelTime = {
+    .seconds = kCallbackTime.seconds + 1
+  };
+  TEST_ASSERT_EQUAL(1, SchedulerDoCallbacks(&scheduler, &kCancelTime));
+  TEST_ASSERT_EQUAL(1, cctx.calls);
+  TEST_ASSERT_FALSE(SchedulerIsTimerPending(&scheduler, cctx.handle));
+  TEST_ASSERT_EQUAL(1, scheduler.entry_count);
+
+  /* Clearing invalidates all handles. */
+  TEST_ASSERT_TRUE(SchedulerClearCallbacks(&scheduler));
+  TEST_ASSERT_FALSE(SchedulerIsTimerPending(&scheduler, handle_b));
+}
+
+static void TestSchedulerTimerHandles_Reschedule(void) {
+  scheduler_t scheduler;
+  TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &kInitTime));
+
+  /* A note off, re-armed when the note is retriggered. */
+  timer_ctx_t ctx = {};
+  scheduler_timer_handle_t const handle =
+      SchedulerSetDelayedCallbackMicroseconds(
+          &scheduler, 500000, NULL, TimerCallback, &ctx);
+  TEST_ASSERT_NOT_EQUAL(SCHEDULER_TIMER_HANDLE_NULL, handle);
+  static system_time_t const kRetriggerTime = {
+    .seconds = kInitTime.seconds,
+    .nanoseconds = 400000000
+  };
+  TEST_ASSERT_EQUAL(0, SchedulerDoCallbacks(&scheduler, &kRetriggerTime));
+  TEST_ASSERT_FALSE(SchedulerRescheduleTimerMicroseconds(
+      NULL, handle, 500000, NULL));
+  TEST_ASSERT_FALSE(SchedulerRescheduleTimerMicroseconds(
+      &scheduler, handle, 500000, &kInitTime));
+  TEST_ASSERT_TRUE(SchedulerRescheduleTimerMicroseconds(
+      &scheduler, handle, 500000, NULL));
+  TEST_ASSERT_EQUAL(1, scheduler.entry_count);
+
+  static system_time_t const kOldDeadline = {
+    .seconds = kInitTime.seconds,
+    .nanoseconds = 500000000
+  };
+  TEST_ASSERT_EQUAL(0, SchedulerDoCallbacks(&scheduler, &kOldDeadline));
+  TEST_ASSERT_FALSE(ctx.received);
+  static system_time_t const kNewDeadline = {
+    .seconds = kInitTime.seconds,
+    .nanoseconds = 900000000
+  };
+  TEST_ASSERT_EQUAL(1, SchedulerDoCallbacks(&scheduler, &kNewDeadline));
+  TEST_ASSERT_TRUE(ctx.received);
+  TEST_ASSERT_FALSE(SchedulerRescheduleTimerMicroseconds(
+      &scheduler, handle, 500000, NULL));
+
+  /* Periodic callbacks keep their period from the new time. */
+  timer_ctx_t pctx = {};
+  scheduler_timer_handle_t const phandle =
+      SchedulerSetPeriodicCallbackSeconds(
+          &scheduler, 10, NULL, TimerCallback, &pctx);
+  TEST_ASSERT_TRUE(SchedulerRescheduleTimerSeconds(
+      &scheduler, phandle, 2, NULL));
+  static system_time_t const kPeriodicTime = {
+    .seconds = kNewDeadline.seconds + 2,
+    .nanoseconds = kNewDeadline.nanoseconds
+  };
+  TEST_ASSERT_EQUAL(1, SchedulerDoCallbacks(&scheduler, &kPeriodicTime));
+  TEST_ASSERT_TRUE(pctx.received);
+  system_time_t deadline;
+  TEST_ASSERT_TRUE(SchedulerNextDeadline(&scheduler, &deadline));
+  TEST_ASSERT_EQUAL(kPeriodicTime.seconds + 10, deadline.seconds);
+  TEST_ASSERT_EQUAL(kPeriodicTime.nanoseconds, deadline.nanoseconds);
+}
+
 typedef struct {
   bool_t received;
   system_time_t time;
@@ -379,6 +517,56 @@ static void EventCallback(
 static scheduler_event_id_t const kEventOne = 1;
 static scheduler_event_id_t const kEventTwo = 2;
 
+typedef struct {
+  uint32_t delay;
+  uint32_t *order;
+  size_t *order_count;
+} ordered_timer_ctx_t;
+
+static void OrderedTimerCallback(void *ctx_ptr, system_time_t const *time) {
+  ordered_timer_ctx_t *ctx = ctx_ptr;
+  ctx->order[(*ctx->order_count)++] = ctx->delay;
+}
+
+static void TestSchedulerDelayCallbacks_Ordered(void) {
+  scheduler_t scheduler;
+  TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &kInitTime));
+
+  uint32_t order[SCHEDULER_TIMER_HEAP_SIZE] = {};
+  size_t order_count = 0;
+  ordered_timer_ctx_t ctxs[SCHEDULER_TIMER_HEAP_SIZE];
+  /* Registered out of order; 7 is co-prime with the power of two heap
+   * size, so each delay is unique. */
+  for (size_t i = 0; i < SCHEDULER_TIMER_HEAP_SIZE; ++i) {
+    ctxs[i] = (ordered_timer_ctx_t) {
+      .delay = ((i * 7) % SCHEDULER_TIMER_HEAP_SIZE) + 1,
+      .order = order,
+      .order_count = &order_count
+    };
+    TEST_ASSERT_TRUE(SchedulerSetDelayedCallbackSeconds(
+        &scheduler, ctxs[i].delay, NULL, OrderedTimerCallback, &ctxs[i]));
+  }
+  TEST_ASSERT_EQUAL(SCHEDULER_TIMER_HEAP_SIZE, scheduler.entry_count);
+  /* Timers are full, events are not. */
+  timer_ctx_t ctx = {};
+  TEST_ASSERT_FALSE(SchedulerSetDelayedCallbackSeconds(
+      &scheduler, 1, NULL, TimerCallback, &ctx));
+  event_ctx_t ectx = {};
+  TEST_ASSERT_TRUE(SchedulerSetEventCallback(
+      &scheduler, kEventOne, false, EventCallback, &ectx));
+  TEST_ASSERT_TRUE(SchedulerClearEvents(&scheduler));
+
+  system_time_t time = kInitTime;
+  for (uint32_t i = 1; i <= SCHEDULER_TIMER_HEAP_SIZE; ++i) {
+    time.seconds = kInitTime.seconds + i;
+    TEST_ASSERT_EQUAL(1, SchedulerDoCallbacks(&scheduler, &time));
+    TEST_ASSERT_EQUAL(i, order_count);
+    TEST_ASSERT_EQUAL(i, order[i - 1]);
+  }
+  TEST_ASSERT_EQUAL(1, scheduler.entry_count);
+  TEST_ASSERT_EQUAL(0, scheduler.timer_count);
+}
+
 static void TestSchedulerEventCallbacks_Register(void) {
   scheduler_t scheduler;
   TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &kInitTime));
@@ -624,6 +812,70 @@ static void TestSchedulerEventCallbacks_Multiple_OneReoccuring(void) {
   TEST_ASSERT_EQUAL(kEventTwo, ctx_b.event);
 }
 
+typedef struct {
+  scheduler_t *scheduler;
+  size_t calls;
+} retrigger_ctx_t;
+
+static void RetriggerEventCallback(
+    void *ctx_ptr, scheduler_event_id_t event, system_time_t const *time) {
+  retrigger_ctx_t *ctx = ctx_ptr;
+  ++ctx->calls;
+  SchedulerTiggerEvent(ctx->scheduler, event);
+}
+
+static void TestSchedulerEventCallbacks_Subscribers(void) {
+  scheduler_t scheduler;
+  TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &kInitTime));
+
+  event_ctx_t ctx = {};
+  TEST_ASSERT_FALSE(SchedulerSetEventCallback(
+      &scheduler, SCHEDULER_EVENT_ID_COUNT + 1, true, EventCallback, &ctx));
+  TEST_ASSERT_FALSE(SchedulerTiggerEvent(
+      &scheduler, SCHEDULER_EVENT_ID_COUNT + 1));
+
+  event_ctx_t ctx_last = {};
+  TEST_ASSERT_TRUE(SchedulerSetEventCallback(
+      &scheduler, SCHEDULER_EVENT_ID_COUNT, false, EventCallback, &ctx_last));
+  retrigger_ctx_t rctx_a = { .scheduler = &scheduler };
+  retrigger_ctx_t rctx_b = { .scheduler = &scheduler };
+  TEST_ASSERT_TRUE(SchedulerSetEventCallback(
+      &scheduler, kEventOne, true, RetriggerEventCallback, &rctx_a));
+  TEST_ASSERT_TRUE(SchedulerSetEventCallback(
+      &scheduler, kEventOne, false, RetriggerEventCallback, &rctx_b));
+  TEST_ASSERT_EQUAL(3, scheduler.entry_count);
+
+  TEST_ASSERT_TRUE(SchedulerTiggerEvent(&scheduler, kEventOne));
+  TEST_ASSERT_TRUE(SchedulerTiggerEvent(&scheduler, SCHEDULER_EVENT_ID_COUNT));
+  TEST_ASSERT_EQUAL(2, scheduler.event_count);
+  TEST_ASSERT_EQUAL(3, SchedulerDoCallbacks(&scheduler, &kInitTime));
+  TEST_ASSERT_EQUAL(1, rctx_a.calls);
+  TEST_ASSERT_EQUAL(1, rctx_b.calls);
+  TEST_ASSERT_TRUE(ctx_last.received);
+  TEST_ASSERT_EQUAL(SCHEDULER_EVENT_ID_COUNT, ctx_last.event);
+  TEST_ASSERT_EQUAL(1, scheduler.entry_count);
+
+  /* Re-triggered during the callbacks. */
+  TEST_ASSERT_EQUAL(1, scheduler.event_count);
+  TEST_ASSERT_EQUAL(1, SchedulerDoCallbacks(&scheduler, &kInitTime));
+  TEST_ASSERT_EQUAL(2, rctx_a.calls);
+  TEST_ASSERT_EQUAL(1, rctx_b.calls);
+
+  /* Removed entries are reused. */
+  for (size_t i = 1; i < SCHEDULER_CALLBACK_TABLE_SIZE; ++i) {
+    TEST_ASSERT_TRUE(SchedulerSetEventCallback(
+        &scheduler, kEventTwo, false, EventCallback, &ctx));
+  }
+  TEST_ASSERT_FALSE(SchedulerSetEventCallback(
+      &scheduler, kEventTwo, false, EventCallback, &ctx));
+  TEST_ASSERT_TRUE(SchedulerClearEvents(&scheduler));
+  TEST_ASSERT_TRUE(SchedulerTiggerEvent(&scheduler, kEventTwo));
+  TEST_ASSERT_EQUAL(
+      SCHEDULER_CALLBACK_TABLE_SIZE - 1,
+      SchedulerDoCallbacks(&scheduler, &kInitTime));
+  TEST_ASSERT_EQUAL(1, scheduler.entry_count);
+}
+
 static void TestSchedulerEventCallbacks_ClearEvents(void) {
   scheduler_t scheduler;
   TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &kInitTime));
@@ -650,6 +902,102 @@ static void TestSchedulerEventCallbacks_ClearEvents(void) {
   TEST_ASSERT_EQUAL(0, SchedulerDoCallbacks(&scheduler, &kCallbackTime));
 }
 
+static void TestScheduler_NextDeadline(void) {
+  scheduler_t scheduler;
+  TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &kInitTime));
+  system_time_t deadline = {};
+  TEST_ASSERT_FALSE(SchedulerNextDeadline(NULL, &deadline));
+  TEST_ASSERT_FALSE(SchedulerNextDeadline(&scheduler, NULL));
+  /* Nothing pending. */
+  TEST_ASSERT_FALSE(SchedulerNextDeadline(&scheduler, &deadline));
+  event_ctx_t ectx = {};
+  TEST_ASSERT_TRUE(SchedulerSetEventCallback(
+      &scheduler, kEventOne, true, EventCallback, &ectx));
+  TEST_ASSERT_FALSE(SchedulerNextDeadline(&scheduler, &deadline));
+
+  timer_ctx_t ctx = {};
+  TEST_ASSERT_TRUE(SchedulerSetDelayedCallbackSeconds(
+      &scheduler, 20, NULL, TimerCallback, &ctx));
+  TEST_ASSERT_TRUE(SchedulerSetDelayedCallbackSeconds(
+      &scheduler, 10, NULL, TimerCallback, &ctx));
+  TEST_ASSERT_TRUE(SchedulerNextDeadline(&scheduler, &deadline));
+  TEST_ASSERT_EQUAL(kInitTime.seconds + 10, deadline.seconds);
+  TEST_ASSERT_EQUAL(0, deadline.nanoseconds);
+
+  /* Pending events are due immediately. */
+  TEST_ASSERT_TRUE(SchedulerTiggerEvent(&scheduler, kEventOne));
+  TEST_ASSERT_TRUE(SchedulerNextDeadline(&scheduler, &deadline));
+  TEST_ASSERT_EQUAL(kInitTime.seconds, deadline.seconds);
+
+  static system_time_t const kCallbackTime = {
+    .seconds = kInitTime.seconds + 10
+  };
+  TEST_ASSERT_EQUAL(2, SchedulerDoCallbacks(&scheduler, &kCallbackTime));
+  TEST_ASSERT_TRUE(SchedulerNextDeadline(&scheduler, &deadline));
+  TEST_ASSERT_EQUAL(kInitTime.seconds + 20, deadline.seconds);
+}
+
+#ifdef _PLATFORM_NATIVE
+static void TestScheduler_NativeIdle(void) {
+  system_time_t now;
+  TEST_ASSERT_TRUE(SystemTimeNow(&now));
+  scheduler_t scheduler;
+  TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &now));
+  timer_ctx_t ctx = {};
+  TEST_ASSERT_TRUE(SchedulerSetDelayedCallbackMicroseconds(
+      &scheduler, 2000, NULL, TimerCallback, &ctx));
+  system_time_t deadline;
+  TEST_ASSERT_TRUE(SchedulerNextDeadline(&scheduler, &deadline));
+
+  /* May wake early once from a previous wake up. */
+  for (size_t i = 0; i < 2; ++i) {
+    SchedulerIdle(&scheduler);
+    TEST_ASSERT_TRUE(SystemTimeNow(&now));
+    if (SystemTimeLessThanOrEqual(&deadline, &now)) break;
+  }
+  TEST_ASSERT_TRUE(SystemTimeLessThanOrEqual(&deadline, &now));
+  TEST_ASSERT_EQUAL(1, SchedulerDoCallbacks(&scheduler, &now));
+  TEST_ASSERT_TRUE(ctx.received);
+
+  /* Woken early. */
+  TEST_ASSERT_TRUE(SchedulerSetDelayedCallbackSeconds(
+      &scheduler, 60, NULL, TimerCallback, &ctx));
+  SystemWakeUp();
+  SystemDisableInterrupt();
+  TEST_ASSERT_FALSE(SystemSleepUntil(&scheduler.timers[0].timer));
+}
+
+static void SoakTimerCallback(void *ctx_ptr, system_time_t const *time) {
+  ++*((uint32_t *) ctx_ptr);
+}
+
+static void TestScheduler_NativeVirtualClockSoak(void) {
+  TEST_ASSERT_TRUE(SystemTimeEnableVirtualClock(&kInitTime));
+  scheduler_t scheduler;
+  TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &kInitTime));
+  uint32_t ticks = 0;
+  uint32_t beats = 0;
+  /* A 1 ms tick and a 120 BPM beat for ten simulated minutes. */
+  TEST_ASSERT_TRUE(SchedulerSetPeriodicCallbackMicroseconds(
+      &scheduler, 1000, NULL, SoakTimerCallback, &ticks));
+  TEST_ASSERT_TRUE(SchedulerSetPeriodicCallbackMicroseconds(
+      &scheduler, 500000, NULL, SoakTimerCallback, &beats));
+  system_time_t end = kInitTime;
+  TEST_ASSERT_TRUE(SystemTimeIncrementSeconds(&end, 600));
+
+  system_time_t now = kInitTime;
+  while (SystemTimeLessThan(&now, &end)) {
+    SchedulerIdle(&scheduler);
+    TEST_ASSERT_TRUE(SystemTimeNow(&now));
+    SchedulerDoCallbacks(&scheduler, &now);
+  }
+  /* The virtual clock is disabled by tearDown(). */
+  TEST_ASSERT_TRUE(SystemTimeEqual(&end, &now));
+  TEST_ASSERT_EQUAL(600000, ticks);
+  TEST_ASSERT_EQUAL(1200, beats);
+}
+#endif  /* _PLATFORM_NATIVE */
+
 static void TestSchedulerCallbacks_Multiple(void) {
   scheduler_t scheduler;
   TEST_ASSERT_TRUE(SchedulerInitialize(&scheduler, &kInitTime));
@@ -783,6 +1131,9 @@ void SchedulerTest(void) {
   RUN_TEST(TestSchedulerDelayCallbacks_Single);
   RUN_TEST(TestSchedulerDelayCallbacks_Multiple_OneAtATime);
   RUN_TEST(TestSchedulerDelayCallbacks_Multiple_AllAtOnce);
+  RUN_TEST(TestSchedulerDelayCallbacks_Ordered);
+  RUN_TEST(TestSchedulerTimerHandles_Cancel);
+  RUN_TEST(TestSchedulerTimerHandles_Reschedule);
 
   RUN_TEST(TestSchedulerEventCallbacks_Register);
   RUN_TEST(TestSchedulerEventCallbacks_Single);
@@ -791,8 +1142,15 @@ void SchedulerTest(void) {
   RUN_TEST(TestSchedulerEventCallbacks_Multiple_AllAtOnce);
   RUN_TEST(TestSchedulerEventCallbacks_Multiple_OneReoccuring);
   RUN_TEST(TestSchedulerEventCallbacks_ClearEvents);
+  RUN_TEST(TestSchedulerEventCallbacks_Subscribers);
 
   RUN_TEST(TestSchedulerCallbacks_Multiple);
   RUN_TEST(TestSchedulerCallbacks_Multiple_Reoccuring);
   RUN_TEST(TestSchedulerCallbacks_Multiple_ClearCallbacks);
+
+  RUN_TEST(TestScheduler_NextDeadline);
+#ifdef _PLATFORM_NATIVE
+  RUN_TEST(TestScheduler_NativeIdle);
+  RUN_TEST(TestScheduler_NativeVirtualClockSoak);
+#endif  /* _PLATFORM_NATIVE */
 }
@@ -0,0 +1,132 @@
+/*
+ * MIDI Controller - System Time Benchmark
+ *
+ * Copyright (c) 2020 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifdef _BENCHMARK_ENABLED
+
+#include <unity.h>
+
+#include "benchmark.h"
+#include "system_time.h"
+
+#define BENCHMARK_TIME_COUNT 64
+#define BENCHMARK_ROUNDS     20000
+
+#define BENCHMARK_OPERATIONS (BENCHMARK_ROUNDS * BENCHMARK_TIME_COUNT)
+
+static system_time_t sTimes[BENCHMARK_TIME_COUNT];
+static system_ticks_t sTicks[BENCHMARK_TIME_COUNT];
+
+static void InitializeTimes(void) {
+  /* Deadlines as seen by the scheduler, a few milliseconds apart. */
+  for (size_t i = 0; i < BENCHMARK_TIME_COUNT; ++i) {
+    sTimes[i] = (system_time_t) {
+      .seconds = 100 + (i / 16),
+      .nanoseconds = (uint32_t) ((i * 61000001u) % 1000000000u)
+    };
+    SystemTicksFromTime(&sTimes[i], &sTicks[i]);
+  }
+}
+
+static void BenchmarkSystemTime_Compare(void) {
+  benchmark_t benchmark;
+  uint32_t sink = 0;
+  BenchmarkStart(&benchmark, "SystemTime/time-compare");
+  for (uint32_t round = 0; round < BENCHMARK_ROUNDS; ++round) {
+    for (size_t i = 0; i < BENCHMARK_TIME_COUNT; ++i) {
+      sink += SystemTimeLessThan(
+          &sTimes[i], &sTimes[(i + round) % BENCHMARK_TIME_COUNT]);
+    }
+  }
+  BenchmarkStop(&benchmark, BENCHMARK_OPERATIONS);
+  gBenchmarkSink = sink;
+}
+
+static void BenchmarkSystemTicks_Compare(void) {
+  benchmark_t benchmark;
+  uint32_t sink = 0;
+  BenchmarkStart(&benchmark, "SystemTime/ticks-compare");
+  for (uint32_t round = 0; round < BENCHMARK_ROUNDS; ++round) {
+    for (size_t i = 0; i < BENCHMARK_TIME_COUNT; ++i) {
+      sink += SystemTicksLessThan(
+          sTicks[i], sTicks[(i + round) % BENCHMARK_TIME_COUNT]);
+    }
+  }
+  BenchmarkStop(&benchmark, BENCHMARK_OPERATIONS);
+  gBenchmarkSink = sink;
+}
+
+static void BenchmarkSystemTime_Increment(void) {
+  benchmark_t benchmark;
+  uint32_t sink = 0;
+  BenchmarkStart(&benchmark, "SystemTime/time-increment-us");
+  for (uint32_t round = 0; round < BENCHMARK_ROUNDS; ++round) {
+    for (size_t i = 0; i < BENCHMARK_TIME_COUNT; ++i) {
+      system_time_t time = sTimes[i];
+      SystemTimeIncrementMicroseconds(&time, 1500 + round);
+      sink += time.nanoseconds;
+    }
+  }
+  BenchmarkStop(&benchmark, BENCHMARK_OPERATIONS);
+  gBenchmarkSink = sink;
+}
+
+static void BenchmarkSystemTicks_Add(void) {
+  benchmark_t benchmark;
+  uint32_t sink = 0;
+  BenchmarkStart(&benchmark, "SystemTime/ticks-add-us");
+  for (uint32_t round = 0; round < BENCHMARK_ROUNDS; ++round) {
+    for (size_t i = 0; i < BENCHMARK_TIME_COUNT; ++i) {
+      system_ticks_t const ticks = SystemTicksAdd(
+          sTicks[i], SystemTicksFromMicroseconds(1500 + round));
+      sink += (uint32_t) ticks;
+    }
+  }
+  BenchmarkStop(&benchmark, BENCHMARK_OPERATIONS);
+  gBenchmarkSink = sink;
+}
+
+static void BenchmarkSystemTime_Delta(void) {
+  benchmark_t benchmark;
+  uint32_t sink = 0;
+  BenchmarkStart(&benchmark, "SystemTime/time-delta-us");
+  for (uint32_t round = 0; round < BENCHMARK_ROUNDS; ++round) {
+    for (size_t i = 0; i < BENCHMARK_TIME_COUNT; ++i) {
+      uint32_t us = 0;
+      SystemTimeMicrosecondsDelta(
+          &sTimes[i], &sTimes[(i + round) % BENCHMARK_TIME_COUNT], &us);
+      sink += us;
+    }
+  }
+  BenchmarkStop(&benchmark, BENCHMARK_OPERATIONS);
+  gBenchmarkSink = sink;
+}
+
+static void BenchmarkSystemTicks_Delta(void) {
+  benchmark_t benchmark;
+  uint32_t sink = 0;
+  BenchmarkStart(&benchmark, "SystemTime/ticks-delta");
+  for (uint32_t round = 0; round < BENCHMARK_ROUNDS; ++round) {
+    for (size_t i = 0; i < BENCHMARK_TIME_COUNT; ++i) {
+      sink += (uint32_t) SystemTicksDelta(
+          sTicks[i], sTicks[(i + round) % BENCHMARK_TIME_COUNT]);
+    }
+  }
+  BenchmarkStop(&benchmark, BENCHMARK_OPERATIONS);
+  gBenchmarkSink = sink;
+}
+
+void SystemTimeBenchmark(void) {
+  InitializeTimes();
+  RUN_TEST(BenchmarkSystemTime_Compare);
+  RUN_TEST(BenchmarkSystemTicks_Compare);
+  RUN_TEST(BenchmarkSystemTime_Increment);
+  RUN_TEST(BenchmarkSystemTicks_Add);
+  RUN_TEST(BenchmarkSystemTime_Delta);
+  RUN_TEST(BenchmarkSystemTicks_Delta);
+}
+
+#endif  /* _BENCHMARK_ENABLED */
@@ -48,6 +48,9 @@ static system_time_t const kInvalidTime = {
 #include <stdio.h>
 #include <unistd.h>
 
+#include "system_interrupt.h"
+#include "system_sleep.h"
+
 static void TestSystemTime_NativeMonotonic(void)  {
   TEST_ASSERT_FALSE(SystemTimeNow(NULL));
   system_time_t start = {};
@@ -60,8 +63,125 @@ static void TestSystemTime_NativeMonotonic(void)  {
   TEST_ASSERT_TRUE(SystemTimeNow(&end));
   TEST_ASSERT_TRUE(SystemTimeLessThan(&start, &end));
 }
+
+static void TestSystemTime_NativeTimestamp(void) {
+  TEST_ASSERT_EQUAL(25000, SystemTimestampResolution());
+  system_timestamp_t const start = SystemTimestamp();
+  /* 1ms is 40 ticks. */
+  unsigned int const res = usleep(1000);
+  TEST_ASSERT_EQUAL(0, res);
+  system_timestamp_t const elapsed = SystemTimestamp() - start;
+  TEST_ASSERT_GREATER_OR_EQUAL(40, elapsed);
+}
+
+static void TestSystemTicks_NativeMonotonic(void) {
+  system_ticks_t const start = SystemTicksNow();
+  unsigned int const res = usleep(1000);
+  TEST_ASSERT_EQUAL(0, res);
+  system_ticks_t const end = SystemTicksNow();
+  TEST_ASSERT_TRUE(SystemTicksLessThan(start, end));
+  TEST_ASSERT_GREATER_OR_EQUAL(
+      SystemTicksFromMicroseconds(1000), SystemTicksDelta(start, end));
+}
+
+static void TestSystemTime_NativeVirtualClock(void) {
+  TEST_ASSERT_FALSE(SystemTimeIsVirtualClock());
+  TEST_ASSERT_FALSE(SystemTimeAdvanceVirtualClock(1000));
+  TEST_ASSERT_FALSE(SystemTimeEnableVirtualClock(NULL));
+  TEST_ASSERT_FALSE(SystemTimeEnableVirtualClock(&kInvalidTime));
+  static system_time_t const kStart = {
+    .seconds = 100,
+    .nanoseconds = 0
+  };
+  TEST_ASSERT_TRUE(SystemTimeEnableVirtualClock(&kStart));
+  TEST_ASSERT_TRUE(SystemTimeIsVirtualClock());
+
+  system_time_t now = {};
+  TEST_ASSERT_TRUE(SystemTimeNow(&now));
+  TEST_ASSERT_TRUE(SystemTimeEqual(&kStart, &now));
+  system_timestamp_t const timestamp = SystemTimestamp();
+  system_ticks_t const ticks = SystemTicksNow();
+  TEST_ASSERT_TRUE(SystemTicksFromSeconds(100) == ticks);
+
+  /* Stands still until advanced. */
+  TEST_ASSERT_TRUE(SystemTimeNow(&now));
+  TEST_ASSERT_TRUE(SystemTimeEqual(&kStart, &now));
+  TEST_ASSERT_TRUE(SystemTimeAdvanceVirtualClock(1500));
+  TEST_ASSERT_TRUE(SystemTimeNow(&now));
+  TEST_ASSERT_EQUAL(100, now.seconds);
+  TEST_ASSERT_EQUAL(1500000, now.nanoseconds);
+  TEST_ASSERT_EQUAL(60, (system_timestamp_t) (SystemTimestamp() - timestamp));
+  TEST_ASSERT_TRUE(SystemTicksFromMicroseconds(1500) ==
+                   SystemTicksDelta(ticks, SystemTicksNow()));
+
+  /* Never moves backwards. */
+  TEST_ASSERT_FALSE(SystemTimeSetVirtualClock(&kStart));
+  static system_time_t const kLater = {
+    .seconds = 3700,
+    .nanoseconds = 5
+  };
+  TEST_ASSERT_TRUE(SystemTimeSetVirtualClock(&kLater));
+  TEST_ASSERT_TRUE(SystemTimeNow(&now));
+  TEST_ASSERT_TRUE(SystemTimeEqual(&kLater, &now));
+
+  /* Sleeping jumps to the deadline. */
+  static system_time_t const kDeadline = {
+    .seconds = 7300,
+    .nanoseconds = 0
+  };
+  SystemDisableInterrupt();
+  TEST_ASSERT_TRUE(SystemSleepUntil(&kDeadline));
+  TEST_ASSERT_TRUE(SystemTimeNow(&now));
+  TEST_ASSERT_TRUE(SystemTimeEqual(&kDeadline, &now));
+
+  SystemTimeDisableVirtualClock();
+  TEST_ASSERT_FALSE(SystemTimeIsVirtualClock());
+  TEST_ASSERT_TRUE(SystemTimeNow(&now));
+  TEST_ASSERT_FALSE(SystemTimeEqual(&kDeadline, &now));
+}
 #endif  /* _PLATFORM_NATIVE */
 
+static void TestSystemTicks_Conversions(void) {
+  system_ticks_t ticks = 0;
+  TEST_ASSERT_FALSE(SystemTicksFromTime(NULL, &ticks));
+  TEST_ASSERT_FALSE(SystemTicksFromTime(&kZeroTime, NULL));
+  TEST_ASSERT_FALSE(SystemTicksFromTime(&kInvalidTime, &ticks));
+  TEST_ASSERT_TRUE(SystemTicksFromTime(&kZeroTime, &ticks));
+  TEST_ASSERT_EQUAL(0, ticks);
+
+  static system_time_t const kTime = {
+    .seconds = 12,
+    .nanoseconds = 345678999
+  };
+  TEST_ASSERT_TRUE(SystemTicksFromTime(&kTime, &ticks));
+  TEST_ASSERT_TRUE(SystemTicksFromSeconds(12) + 345678999 / SYSTEM_TICK_NS ==
+                   ticks);
+  system_time_t time = {};
+  TEST_ASSERT_FALSE(SystemTimeFromTicks(ticks, NULL));
+  TEST_ASSERT_TRUE(SystemTimeFromTicks(ticks, &time));
+  TEST_ASSERT_EQUAL(12, time.seconds);
+  /* Rounded down to a whole tick. */
+  TEST_ASSERT_EQUAL(
+      (345678999 / SYSTEM_TICK_NS) * SYSTEM_TICK_NS, time.nanoseconds);
+
+  TEST_ASSERT_TRUE(SystemTicksFromTime(&kMaxTime, &ticks));
+  TEST_ASSERT_TRUE(SystemTimeFromTicks(ticks, &time));
+  TEST_ASSERT_EQUAL(kMaxTime.seconds, time.seconds);
+  TEST_ASSERT_TRUE(SystemTimeFromTicks(
+      SystemTicksAdd(ticks, SYSTEM_TICKS_PER_SECOND), &time));
+  TEST_ASSERT_TRUE(SystemTimeEqual(&kMaxTime, &time));
+
+  TEST_ASSERT_TRUE(SystemTicksFromMicroseconds(1500) ==
+                   SystemTicksDelta(
+                      SystemTicksFromSeconds(1),
+                      SystemTicksAdd(SystemTicksFromSeconds(1),
+                                     SystemTicksFromMicroseconds(1500))));
+  TEST_ASSERT_EQUAL(1500, SystemTicksToMicroseconds(
+      SystemTicksFromMicroseconds(1500)));
+  TEST_ASSERT_TRUE(SystemTicksLessThanOrEqual(ticks, ticks));
+  TEST_ASSERT_FALSE(SystemTicksLessThan(ticks, ticks));
+}
+
 static void TestSystemTime_LessThan(void) {
   TEST_ASSERT_FALSE(SystemTimeLessThan(NULL, &kZeroTime));
   TEST_ASSERT_FALSE(SystemTimeLessThan(&kInvalidTime, &kZeroTime));
@@ -1192,7 +1312,12 @@ void SystemTimeTest(void) {
   RUN_TEST(TestSystemTime_DecrementMicroseconds);
   RUN_TEST(TestSystemTime_DecrementNanoseconds);
 
+  RUN_TEST(TestSystemTicks_Conversions);
+
 #ifdef _PLATFORM_NATIVE
   RUN_TEST(TestSystemTime_NativeMonotonic);
+  RUN_TEST(TestSystemTime_NativeTimestamp);
+  RUN_TEST(TestSystemTicks_NativeMonotonic);
+  RUN_TEST(TestSystemTime_NativeVirtualClock);
 #endif  /* _PLATFORM_NATIVE */
 }
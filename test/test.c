@@ -9,6 +9,20 @@
 #include <unity.h>
 #include "test.h"
 
+#ifdef _PLATFORM_NATIVE
+#include "system_time.h"
+#endif
+
+void setUp(void) {}
+
+void tearDown(void) {
+#ifdef _PLATFORM_NATIVE
+  /* A failed assertion leaves the test early; the virtual clock must
+   * not stay enabled for the tests which follow. */
+  SystemTimeDisableVirtualClock();
+#endif
+}
+
 /* Test Main for all test */
 int main(void) {
   UNITY_BEGIN();
@@ -21,6 +35,7 @@ int main(void) {
   printf("\n==== Misc Utilities Test ====\n");
   BitArrayTest();
   ByteBufferTest();
+  ByteRingTest();
   SystemTimeTest();
   SchedulerTest();
 
@@ -30,6 +45,8 @@ int main(void) {
   MidiNoteTest();
   MidiTimeTest();
   MidiTimeTrackerTest();
+  MidiTimeGeneratorTest();
+  MidiClockRecoveryTest();
   MidiControlTest();
   MidiFrameTest();
   MidiUserBitsTest();
@@ -41,11 +58,24 @@ int main(void) {
   MidiSystemExclusiveTest();
 
   MidiProgramTest();
+  MidiStatusTest();
   MidiMessageTest();
+  MidiCompactTest();
   MidiSerializeTest();
   MidiCallbackTest();
+  MidiEventQueueTest();
 
   MidiTransceiverTest();
+  MidiTxQueueTest();
+  MidiTxLanesTest();
+
+#ifdef _BENCHMARK_ENABLED
+  printf("\n==== Benchmarks ====\n");
+  ByteRingBenchmark();
+  MidiStatusBenchmark();
+  MidiCallbackBenchmark();
+  SystemTimeBenchmark();
+#endif  /* _BENCHMARK_ENABLED */
   UNITY_END();
   return 0;
 }
@@ -12,6 +12,7 @@ void SmartStringTest(void);
 void PlatformAttributesTest(void);
 void BitArrayTest(void);
 void ByteBufferTest(void);
+void ByteRingTest(void);
 void SystemTimeTest(void);
 void SchedulerTest(void);
 
@@ -20,6 +21,8 @@ void MidiBytesTest(void);
 void MidiNoteTest(void);
 void MidiTimeTest(void);
 void MidiTimeTrackerTest(void);
+void MidiTimeGeneratorTest(void);
+void MidiClockRecoveryTest(void);
 void MidiControlTest(void);
 void MidiFrameTest(void);
 void MidiUserBitsTest(void);
@@ -32,11 +35,24 @@ void MidiSystemExclusiveTest(void);
 
 void MidiProgramTest(void);
 
+void MidiStatusTest(void);
 void MidiMessageTest(void);
+void MidiCompactTest(void);
 
 void MidiSerializeTest(void);
 void MidiCallbackTest(void);
+void MidiEventQueueTest(void);
 
 void MidiTransceiverTest(void);
+void MidiTxQueueTest(void);
+void MidiTxLanesTest(void);
+
+#ifdef _BENCHMARK_ENABLED
+/* Benchmarks */
+void ByteRingBenchmark(void);
+void MidiCallbackBenchmark(void);
+void MidiStatusBenchmark(void);
+void SystemTimeBenchmark(void);
+#endif  /* _BENCHMARK_ENABLED */
 
 #endif  /* _TEST_H_ */